@@ -25,10 +25,22 @@
 
 #import <Foundation/Foundation.h>
 
+@class MRBrewWorker;
+
 @interface MRBrew ()
 
 @property (strong) NSString *brewPath;
 @property (strong) NSDictionary *environment;
 @property (strong) NSOperationQueue *backgroundQueue;
 
+/* Workers for operations that are waiting to be retried after failing due to
+ * lock contention. They are added to the background queue once their delay
+ * has elapsed.
+ */
+@property (strong) NSMutableSet *pendingRetryWorkers;
+
+- (MRBrewWorker *)workerForOperation:(MRBrewOperation *)operation;
+- (NSDictionary *)environmentForOperation:(MRBrewOperation *)operation;
+- (void)scheduleWorker:(MRBrewWorker *)worker afterDelay:(NSTimeInterval)delay;
+
 @end
@@ -26,6 +26,8 @@
 #import <Cocoa/Cocoa.h>
 #import "MRBrewOperation.h"
 
+@class MRBrewProgress;
+
 /** These constants indicate the type of error that resulted in an operation's
  * failure.
  */
@@ -41,11 +43,84 @@ typedef NS_ENUM(NSInteger, MRBrewError) {
     /** Indicates that the operation failed to complete due to a cancellation
      * message.
      */
-    MRBrewErrorOperationCancelled
+    MRBrewErrorOperationCancelled,
+    /** Indicates that the operation failed because another Homebrew process
+     * held a lock it needed, and the operation's retries were exhausted (see
+     * lockRetryLimit).
+     */
+    MRBrewErrorLockContention
+};
+
+/** These constants determine what happens to an operation's output when it is
+ * generated faster than the callback queue delivers it (see
+ * outputBufferPolicy).
+ */
+typedef NS_ENUM(NSInteger, MRBrewOutputBufferPolicy) {
+    /** Indicates that output is no longer read while the buffer is full.
+     * Homebrew blocks when it next writes to the full pipe, and continues once
+     * the waiting output has been delivered. No output is lost.
+     */
+    MRBrewOutputBufferPolicyBlock,
+    /** Indicates that output read while earlier output is waiting is merged
+     * with it and delivered by a single callback. If the merged output exceeds
+     * the buffer's limit, its oldest bytes are discarded so that the most
+     * recent output is kept.
+     */
+    MRBrewOutputBufferPolicyCoalesce,
+    /** Indicates that output read while the buffer is full is discarded.
+     */
+    MRBrewOutputBufferPolicyDrop
 };
 
+/** The block type used to deliver output generated by an operation.
+ *
+ * @param operation The operation that generated the output.
+ * @param output The output string.
+ */
+typedef void (^MRBrewOutputHandler)(MRBrewOperation *operation, NSString *output);
+
+/** The block type used to deliver the raw bytes of output generated by an
+ * operation.
+ *
+ * @param operation The operation that generated the output.
+ * @param data The bytes read from Homebrew's output, exactly as they were read.
+ */
+typedef void (^MRBrewDataHandler)(MRBrewOperation *operation, NSData *data);
+
+/** The block type used to deliver the progress of an install operation.
+ *
+ * @param operation The operation whose progress changed.
+ * @param progress The operation's progress.
+ */
+typedef void (^MRBrewProgressHandler)(MRBrewOperation *operation, MRBrewProgress *progress);
+
+/** The block type used to signal the successful completion of an operation.
+ *
+ * @param operation The operation that finished.
+ */
+typedef void (^MRBrewCompletionHandler)(MRBrewOperation *operation);
+
+/** The block type used to signal the failure of an operation.
+ *
+ * @param operation The operation that failed.
+ * @param error An error object whose `code` corresponds to one of the
+ * `MRBrewError` constants.
+ */
+typedef void (^MRBrewFailureHandler)(MRBrewOperation *operation, NSError *error);
+
+/** The block type used to deliver the disk usage of installed formulae.
+ *
+ * @param usages An array of `MRBrewDiskUsage` objects.
+ */
+typedef void (^MRBrewDiskUsageHandler)(NSArray *usages);
+
 @protocol MRBrewDelegate;
 @class MRBrewWorker;
+@class MRBrewFuture;
+@class MRBrewFormulaLoader;
+@class MRBrewOutputSpool;
+@class MRBrewOutdatedScanner;
+@class MRBrewDiskUsageScanner;
 
 /** The `MRBrew` class manages the execution of Homebrew operations. Operation
  * objects (defined by the MRBrewOperation class) are added to a queue and
@@ -61,7 +136,16 @@ typedef NS_ENUM(NSInteger, MRBrewError) {
  *
  * `MRBrew`'s delegate methods—defined by the MRBrewDelegate protocol—allow
  * an object to receive callbacks regarding the success or failure of an
- * operation and output from Homebrew as it occurs.
+ * operation and output from Homebrew as it occurs. Alternatively, use
+ * performOperation:queue:output:completion:failure: to receive the same
+ * callbacks as blocks on a queue of your choosing.
+ *
+ * The shared instance returned by sharedBrew suits most applications. To
+ * manage several Homebrew installations at once, such as one per architecture
+ * or per project, create an `MRBrew` instance for each with
+ * initWithBrewPath:. Each instance has its own executable path, environment,
+ * operation queue and formula loader, and its operations never use another
+ * instance's configuration.
  *
  * @warning Attempting to perform two operations that reference the same formula
  * concurrently may result in the failure of one of those operations. This is
@@ -84,6 +168,24 @@ typedef NS_ENUM(NSInteger, MRBrewError) {
  */
 + (instancetype)sharedBrew;
 
+/**-----------------------------------------------------------------------------
+ * @name Creating an Independent Brew Instance
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns an initialized `MRBrew` object that performs operations with the
+ * specified Homebrew executable.
+ *
+ * The returned instance is independent of the shared instance and of any other
+ * instance: changes to its path, environment or concurrency only affect the
+ * operations it performs.
+ *
+ * @param path The absolute path of the Homebrew executable. If `nil` the
+ * executable discovered by `MRBrewLocations`' defaultLocations will be used.
+ * @return An initialized `MRBrew` object.
+ */
+- (instancetype)initWithBrewPath:(NSString *)path;
+
 /**-----------------------------------------------------------------------------
  * @name Modifying the Homebrew path
  * -----------------------------------------------------------------------------
@@ -98,7 +200,7 @@ typedef NS_ENUM(NSInteger, MRBrewError) {
 /** Sets the absolute path of the Homebrew executable.
  *
  * @param path The absolute path of the Homebrew executable. If `nil` the
- * default path `/usr/local/bin/brew` will be used.
+ * executable discovered by `MRBrewLocations`' defaultLocations will be used.
  */
 - (void)setBrewPath:(NSString *)path;
 
@@ -120,6 +222,264 @@ typedef NS_ENUM(NSInteger, MRBrewError) {
  */
 - (void)performOperation:(MRBrewOperation *)operation delegate:(id<MRBrewDelegate>)delegate;
 
+/** Performs an operation, delivering callbacks as blocks on the specified
+ * queue.
+ *
+ * Unlike performOperation:delegate:, which always delivers its callbacks on
+ * the main queue, this method allows callers that do not run a main run loop
+ * (or that would immediately move the work off the main thread) to choose
+ * where callbacks are executed.
+ *
+ * If _queue_ is `nil`, blocks are invoked inline on the thread that reads
+ * Homebrew's output and observes its termination. Inline blocks should return
+ * quickly, since output is not read while they execute.
+ *
+ * @warning If _queue_ allows more than one concurrent operation, output
+ * blocks may execute out of order. Use the main queue, `nil`, or a queue whose
+ * `maxConcurrentOperationCount` is `1` if ordering matters.
+ *
+ * @param operation The operation to perform.
+ * @param queue The queue on which blocks are executed, or `nil` to execute
+ * them inline.
+ * @param outputHandler A block to execute when output is received from
+ * Homebrew, or `nil`.
+ * @param completionHandler A block to execute when the operation completes
+ * successfully, or `nil`.
+ * @param failureHandler A block to execute if the operation fails, or `nil`.
+ */
+- (void)performOperation:(MRBrewOperation *)operation queue:(NSOperationQueue *)queue output:(MRBrewOutputHandler)outputHandler completion:(MRBrewCompletionHandler)completionHandler failure:(MRBrewFailureHandler)failureHandler;
+
+/** Performs an operation, delivering its output as raw bytes.
+ *
+ * This method behaves like performOperation:queue:output:completion:failure:,
+ * except that output is passed to _dataHandler_ without being decoded, for
+ * callers that write it to a file or socket unchanged.
+ *
+ * Each data object passed to _dataHandler_ is the buffer that a chunk of output
+ * was read into; it is not copied. The object is immutable and remains valid
+ * for as long as the handler retains it, so retain the object (not a pointer to
+ * its bytes) to use it after the handler returns. Chunk boundaries are
+ * arbitrary and may fall within a multibyte UTF-8 character.
+ *
+ * @param operation The operation to perform.
+ * @param queue The queue on which blocks are executed, or `nil` to execute
+ * them inline.
+ * @param dataHandler A block to execute when output is received from
+ * Homebrew, or `nil`.
+ * @param completionHandler A block to execute when the operation completes
+ * successfully, or `nil`.
+ * @param failureHandler A block to execute if the operation fails, or `nil`.
+ */
+- (void)performOperation:(MRBrewOperation *)operation queue:(NSOperationQueue *)queue data:(MRBrewDataHandler)dataHandler completion:(MRBrewCompletionHandler)completionHandler failure:(MRBrewFailureHandler)failureHandler;
+
+/** Performs an operation, delivering its output and error output separately
+ * and without decoding them.
+ *
+ * This method behaves like performOperation:queue:data:completion:failure:,
+ * except that Homebrew's standard error is also delivered, to
+ * _errorDataHandler_, rather than only being examined to determine why an
+ * operation failed. Output from the two streams is buffered separately, so a
+ * slow consumer of one does not hold back the other.
+ *
+ * @param operation The operation to perform.
+ * @param queue The queue on which blocks are executed, or `nil` to execute
+ * them inline.
+ * @param dataHandler A block to execute when output is received from
+ * Homebrew, or `nil`.
+ * @param errorDataHandler A block to execute when error output is received
+ * from Homebrew, or `nil`.
+ * @param completionHandler A block to execute when the operation completes
+ * successfully, or `nil`.
+ * @param failureHandler A block to execute if the operation fails, or `nil`.
+ */
+- (void)performOperation:(MRBrewOperation *)operation queue:(NSOperationQueue *)queue data:(MRBrewDataHandler)dataHandler errorData:(MRBrewDataHandler)errorDataHandler completion:(MRBrewCompletionHandler)completionHandler failure:(MRBrewFailureHandler)failureHandler;
+
+/** Performs an operation, delivering its progress as `MRBrewProgress` objects.
+ *
+ * This method behaves like performOperation:queue:output:completion:failure:,
+ * except that Homebrew's output is read for phase markers such as
+ * `==> Downloading` and `==> Pouring` and for download percentages, and only
+ * the progress they describe is delivered.
+ *
+ * Progress that starts a new phase, or names a new formula, is delivered as
+ * soon as it is read. Updates within a phase, such as download percentages,
+ * are delivered at most once per progressInterval; when several arrive within
+ * an interval only the latest is delivered, at the end of the interval.
+ *
+ * @param operation The operation to perform.
+ * @param queue The queue on which blocks are executed, or `nil` to execute
+ * them inline.
+ * @param progressHandler A block to execute when the operation's progress
+ * changes, or `nil`.
+ * @param completionHandler A block to execute when the operation completes
+ * successfully, or `nil`.
+ * @param failureHandler A block to execute if the operation fails, or `nil`.
+ */
+- (void)performOperation:(MRBrewOperation *)operation queue:(NSOperationQueue *)queue progress:(MRBrewProgressHandler)progressHandler completion:(MRBrewCompletionHandler)completionHandler failure:(MRBrewFailureHandler)failureHandler;
+
+/** Performs an operation, collecting its output in a spool.
+ *
+ * Output is appended to _spool_ on the thread that reads it, so it is never
+ * queued in memory waiting for a callback. Once the operation exits the spool's
+ * finishWriting method is called, and then the completion or failure block is
+ * executed on _queue_, after which the output can be read from the spool. This
+ * keeps memory use bounded for operations that generate very large output,
+ * such as verbose source builds (see MRBrewOutputSpool).
+ *
+ * @param operation The operation to perform.
+ * @param spool The spool in which to collect the operation's output.
+ * @param queue The queue on which blocks are executed, or `nil` to execute
+ * them inline.
+ * @param completionHandler A block to execute when the operation completes
+ * successfully, or `nil`.
+ * @param failureHandler A block to execute if the operation fails, or `nil`.
+ */
+- (void)performOperation:(MRBrewOperation *)operation spool:(MRBrewOutputSpool *)spool queue:(NSOperationQueue *)queue completion:(MRBrewCompletionHandler)completionHandler failure:(MRBrewFailureHandler)failureHandler;
+
+/** Performs an operation and returns a future representing its result.
+ *
+ * The returned future is fulfilled with the complete output of the operation
+ * and any objects that `MRBrewOutputParser` is able to parse from it, or
+ * rejected with an error whose `code` corresponds to one of the `MRBrewError`
+ * constants. Futures can be chained and combined so that dependent operations
+ * are queued as soon as their inputs are available (see MRBrewFuture).
+ *
+ * @param operation The operation to perform.
+ * @return A future representing the result of the operation.
+ */
+- (MRBrewFuture *)futureForOperation:(MRBrewOperation *)operation;
+
+/** The loader used to look up the details of individual formulae.
+ *
+ * Lookups made through the loader within a short interval of each other are
+ * performed by a single brew invocation (see MRBrewFormulaLoader).
+ */
+@property (readonly) MRBrewFormulaLoader *formulaLoader;
+
+/** The minimum interval between progress updates within a phase of an
+ * operation, delivered to a progress block or to the delegate method
+ * brewOperation:didUpdateProgress:. The default is `0.1` seconds.
+ *
+ * Changing the interval does not affect operations that have already been
+ * performed.
+ */
+@property (assign) NSTimeInterval progressInterval;
+
+/**-----------------------------------------------------------------------------
+ * @name Buffering Output
+ * -----------------------------------------------------------------------------
+ */
+
+/** The number of bytes of output held for each of an operation's output and
+ * error output while they wait to be delivered. The default is `1048576`
+ * (1MB).
+ *
+ * Output read from Homebrew is held until the queue that delivers callbacks
+ * executes them, and callbacks for output that arrives while earlier output
+ * is waiting are combined. When the output held for a stream reaches the limit
+ * the outputBufferPolicy is applied. Output delivered inline, to a `nil`
+ * queue, is never held.
+ *
+ * Changing the limit does not affect operations that have already been
+ * performed.
+ */
+@property (assign) NSUInteger outputBufferLimit;
+
+/** The policy applied to output read while an operation's buffer is full. The
+ * default is `MRBrewOutputBufferPolicyBlock`.
+ *
+ * If output is discarded under the other policies, the delegate method
+ * brewOperation:didDropOutputLength:errorOutputLength: is called before the
+ * operation finishes.
+ *
+ * Changing the policy does not affect operations that have already been
+ * performed.
+ */
+@property (assign) MRBrewOutputBufferPolicy outputBufferPolicy;
+
+/**-----------------------------------------------------------------------------
+ * @name Retrying After Lock Contention
+ * -----------------------------------------------------------------------------
+ */
+
+/** The number of times an operation is retried if it fails because another
+ * Homebrew process holds a lock it needs. The default is `5`; `0` disables
+ * retries. Read-only operations (see `-[MRBrewOperation isReadOnly]`) do not
+ * take Homebrew's locks and are never retried.
+ *
+ * Homebrew refuses to run while another process is updating it or operating
+ * on the same formula, and reports this on its error output. An operation that
+ * fails for this reason is performed again after a delay, and its delegate and
+ * blocks are only told of the outcome of the final attempt. If every attempt
+ * fails the error's `code` is `MRBrewErrorLockContention`.
+ *
+ * So that output and progress from an abandoned attempt are never delivered,
+ * they are held back while an attempt may still be retried. Homebrew reports
+ * lock contention as soon as it starts, so they are released once an attempt
+ * has run for two seconds or generated more than outputBufferLimit bytes of
+ * output, and an attempt whose output has been released is not retried.
+ *
+ * Changing the limit does not affect operations that have already been
+ * performed.
+ */
+@property (assign) NSUInteger lockRetryLimit;
+
+/** The delay before an operation is first retried after failing due to lock
+ * contention. The default is `1.0` seconds.
+ *
+ * The delay doubles with each further attempt, up to one minute, and is
+ * varied randomly by up to half in either direction so that operations that
+ * contended for the same lock do not retry in lockstep.
+ */
+@property (assign) NSTimeInterval lockRetryInterval;
+
+/** A scanner that answers outdated operations without running Homebrew, or
+ * `nil`, the default, to run `brew outdated` for every outdated operation.
+ *
+ * When set, outdated operations that produce plain or verbose output are
+ * answered by the scanner, which compares the installed kegs in the scanner's
+ * prefix with the formula sources there. Their output, delegate messages and
+ * notifications are the same as if Homebrew had been run. Outdated operations
+ * that request JSON output always run Homebrew.
+ *
+ * The scanner's locations should be those of the Homebrew installation at
+ * brewPath.
+ */
+@property (strong) MRBrewOutdatedScanner *outdatedScanner;
+
+/**-----------------------------------------------------------------------------
+ * @name Measuring Disk Usage
+ * -----------------------------------------------------------------------------
+ */
+
+/** The scanner used to measure the disk usage of installed formulae.
+ *
+ * A scanner for the Homebrew installation at brewPath is created when disk
+ * usage is first measured. The scanner caches the measurements of each keg, so
+ * keep the same scanner to have later measurements revisit only the kegs that
+ * have changed (see MRBrewDiskUsageScanner). Assign a new scanner after
+ * changing brewPath.
+ */
+@property (strong) MRBrewDiskUsageScanner *diskUsageScanner;
+
+/** Measures the disk space used by installed formulae, without running `du`.
+ *
+ * The formulae's kegs are walked concurrently in the background, and the
+ * results are delivered as `MRBrewDiskUsage` objects that describe each
+ * formula's total usage and that of each installed version. Pass the formulae
+ * parsed from the output of a list operation to report their usage alongside
+ * them.
+ *
+ * @param formulae An array of `MRBrewFormula` objects, or `nil` to measure
+ * every installed formula.
+ * @param queue The queue on which the block is executed, or `nil` to execute
+ * it on the thread that measured the formulae.
+ * @param completionHandler A block to execute with an array of
+ * `MRBrewDiskUsage` objects, one for each formula in _formulae_ and in the same
+ * order, or ordered by name if _formulae_ is `nil`.
+ */
+- (void)measureDiskUsageOfFormulae:(NSArray *)formulae queue:(NSOperationQueue *)queue completion:(MRBrewDiskUsageHandler)completionHandler;
+
 /**-----------------------------------------------------------------------------
  * @name Stopping an Operation
  * -----------------------------------------------------------------------------
@@ -164,9 +524,22 @@ typedef NS_ENUM(NSInteger, MRBrewError) {
  */
 - (void)setConcurrentOperations:(BOOL)concurrency;
 
+/** Sets the maximum number of operations that are executed at the same time.
+ *
+ * Changing the maximum does not affect operations that are currently
+ * executing.
+ *
+ * @param count The maximum number of concurrent operations, `1` to execute
+ * operations serially, or `NSOperationQueueDefaultMaxConcurrentOperationCount`
+ * to let the system decide based on current conditions.
+ */
+- (void)setMaxConcurrentOperationCount:(NSInteger)count;
+
 /** Returns the number of operations queued for execution.
  *
  * The value returned by this method will change as operations are completed.
+ * Operations waiting to be retried after failing due to lock contention are
+ * included.
  *
  * @return The number of operations currently queued for execution.
  */
@@ -29,6 +29,14 @@
 #import "MRBrewFormula.h"
 #import "MRBrewConstants.h"
 #import "MRBrewWorker.h"
+#import "MRBrewFuture.h"
+#import "MRBrewFuture+Private.h"
+#import "MRBrewOutputParser.h"
+#import "MRBrewFormulaLoader.h"
+#import "MRBrewOutputSpool.h"
+#import "MRBrewOutdatedScanner.h"
+#import "MRBrewLocations.h"
+#import "MRBrewDiskUsageScanner.h"
 
 #ifndef __has_feature
     #define __has_feature(x) 0 // for compatibility with non-clang compilers
@@ -38,12 +46,16 @@
     #error MRBrew must be built with ARC.
 #endif
 
-static NSString * MRDefaultBrewPath = @"/usr/local/bin/brew";
+static const NSTimeInterval MRDefaultProgressInterval = 0.1;
+static const NSUInteger MRDefaultLockRetryLimit = 5;
+static const NSTimeInterval MRDefaultLockRetryInterval = 1.0;
+static const NSUInteger MRDefaultOutputBufferLimit = 1024 * 1024;
 
 @implementation MRBrew
 
 @synthesize brewPath = _brewPath;
 @synthesize environment = _environment;
+@synthesize diskUsageScanner = _diskUsageScanner;
 
 #pragma mark - Lifecycle
 
@@ -60,10 +72,22 @@ static NSString * MRDefaultBrewPath = @"/usr/local/bin/brew";
 }
 
 - (instancetype)init
+{
+    return [self initWithBrewPath:nil];
+}
+
+- (instancetype)initWithBrewPath:(NSString *)path
 {
     if (self = [super init]) {
         _backgroundQueue = [[NSOperationQueue alloc] init];
-        _brewPath = MRDefaultBrewPath;
+        _brewPath = path ? [path copy] : [[MRBrewLocations defaultLocations] brewPath];
+        _formulaLoader = [[MRBrewFormulaLoader alloc] initWithBrew:self];
+        _progressInterval = MRDefaultProgressInterval;
+        _lockRetryLimit = MRDefaultLockRetryLimit;
+        _lockRetryInterval = MRDefaultLockRetryInterval;
+        _outputBufferLimit = MRDefaultOutputBufferLimit;
+        _outputBufferPolicy = MRBrewOutputBufferPolicyBlock;
+        _pendingRetryWorkers = [NSMutableSet set];
     }
     
     return self;
@@ -81,12 +105,199 @@ static NSString * MRDefaultBrewPath = @"/usr/local/bin/brew";
     if (path)
         _brewPath = [path copy];
     else
-        _brewPath = @"/usr/local/bin/brew";
+        _brewPath = [[MRBrewLocations defaultLocations] brewPath];
+}
+
+#pragma mark - Disk Usage
+
+- (MRBrewDiskUsageScanner *)diskUsageScanner
+{
+    @synchronized(self) {
+        if (!_diskUsageScanner) {
+            // an executable that is missing or not laid out as Homebrew expects
+            // has no locations, so the default installation is scanned instead
+            MRBrewLocations *locations = [MRBrewLocations locationsForBrewPath:[self brewPath]];
+            if (!locations) {
+                NSLog(@"MRBrew: Unable to find the locations of %@, using %@", [self brewPath], [[MRBrewLocations defaultLocations] prefixPath]);
+                locations = [MRBrewLocations defaultLocations];
+            }
+            _diskUsageScanner = [[MRBrewDiskUsageScanner alloc] initWithLocations:locations];
+        }
+        
+        return _diskUsageScanner;
+    }
+}
+
+- (void)setDiskUsageScanner:(MRBrewDiskUsageScanner *)diskUsageScanner
+{
+    @synchronized(self) {
+        _diskUsageScanner = diskUsageScanner;
+    }
+}
+
+- (void)measureDiskUsageOfFormulae:(NSArray *)formulae queue:(NSOperationQueue *)queue completion:(MRBrewDiskUsageHandler)completionHandler
+{
+    NSArray *formulaeToMeasure = [formulae copy];
+    
+    // finding the installation's locations may itself run brew, so the
+    // scanner is created in the background too
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSArray *usages = [[self diskUsageScanner] diskUsageOfFormulae:formulaeToMeasure];
+        if (completionHandler) {
+            [self performBlock:^{
+                completionHandler(usages);
+            } queue:queue];
+        }
+    });
 }
 
 #pragma mark - Operation Methods
 
 - (void)performOperation:(MRBrewOperation *)operation delegate:(id<MRBrewDelegate>)delegate
+{
+    MRBrewWorker *worker = [self workerForOperation:operation];
+    [worker setDelegate:delegate];
+    [[self backgroundQueue] addOperation:worker];
+}
+
+- (void)performOperation:(MRBrewOperation *)operation queue:(NSOperationQueue *)queue output:(MRBrewOutputHandler)outputHandler completion:(MRBrewCompletionHandler)completionHandler failure:(MRBrewFailureHandler)failureHandler
+{
+    MRBrewWorker *worker = [self workerForOperation:operation];
+    [worker setCallbackQueue:queue];
+    [worker setOutputHandler:outputHandler];
+    [worker setCompletionHandler:completionHandler];
+    [worker setFailureHandler:failureHandler];
+    [[self backgroundQueue] addOperation:worker];
+}
+
+- (void)performOperation:(MRBrewOperation *)operation queue:(NSOperationQueue *)queue data:(MRBrewDataHandler)dataHandler completion:(MRBrewCompletionHandler)completionHandler failure:(MRBrewFailureHandler)failureHandler
+{
+    MRBrewWorker *worker = [self workerForOperation:operation];
+    [worker setCallbackQueue:queue];
+    [worker setDataHandler:dataHandler];
+    [worker setCompletionHandler:completionHandler];
+    [worker setFailureHandler:failureHandler];
+    [[self backgroundQueue] addOperation:worker];
+}
+
+- (void)performOperation:(MRBrewOperation *)operation queue:(NSOperationQueue *)queue data:(MRBrewDataHandler)dataHandler errorData:(MRBrewDataHandler)errorDataHandler completion:(MRBrewCompletionHandler)completionHandler failure:(MRBrewFailureHandler)failureHandler
+{
+    MRBrewWorker *worker = [self workerForOperation:operation];
+    [worker setCallbackQueue:queue];
+    [worker setDataHandler:dataHandler];
+    [worker setErrorDataHandler:errorDataHandler];
+    [worker setCompletionHandler:completionHandler];
+    [worker setFailureHandler:failureHandler];
+    [[self backgroundQueue] addOperation:worker];
+}
+
+- (void)performOperation:(MRBrewOperation *)operation queue:(NSOperationQueue *)queue progress:(MRBrewProgressHandler)progressHandler completion:(MRBrewCompletionHandler)completionHandler failure:(MRBrewFailureHandler)failureHandler
+{
+    MRBrewWorker *worker = [self workerForOperation:operation];
+    [worker setCallbackQueue:queue];
+    [worker setProgressHandler:progressHandler];
+    [worker setCompletionHandler:completionHandler];
+    [worker setFailureHandler:failureHandler];
+    [[self backgroundQueue] addOperation:worker];
+}
+
+- (void)performOperation:(MRBrewOperation *)operation spool:(MRBrewOutputSpool *)spool queue:(NSOperationQueue *)queue completion:(MRBrewCompletionHandler)completionHandler failure:(MRBrewFailureHandler)failureHandler
+{
+    // output is spooled inline; only the final callbacks move to the queue
+    [self performOperation:operation queue:nil data:^(MRBrewOperation *generatingOperation, NSData *data) {
+        [spool appendData:data];
+    } completion:^(MRBrewOperation *completedOperation) {
+        [spool finishWriting];
+        if (completionHandler) {
+            [self performBlock:^{
+                completionHandler(completedOperation);
+            } queue:queue];
+        }
+    } failure:^(MRBrewOperation *failedOperation, NSError *error) {
+        [spool finishWriting];
+        if (failureHandler) {
+            [self performBlock:^{
+                failureHandler(failedOperation, error);
+            } queue:queue];
+        }
+    }];
+}
+
+/* Executes the block on the specified queue, or inline if the queue is nil. */
+- (void)performBlock:(void (^)(void))block queue:(NSOperationQueue *)queue
+{
+    if (queue) {
+        [queue addOperationWithBlock:block];
+    }
+    else {
+        block();
+    }
+}
+
+- (MRBrewFuture *)futureForOperation:(MRBrewOperation *)operation
+{
+    MRBrewFuture *future = [[MRBrewFuture alloc] initWithOperation:operation];
+    NSMutableData *output = [NSMutableData data];
+    
+    // output is collected as bytes and decoded once it is complete, since a
+    // chunk may end part way through a multibyte character; handlers are
+    // invoked inline so that dependent operations are queued the moment this
+    // future is resolved
+    [self performOperation:operation queue:nil data:^(MRBrewOperation *generatingOperation, NSData *chunk) {
+        @synchronized(output) {
+            [output appendData:chunk];
+        }
+    } completion:^(MRBrewOperation *completedOperation) {
+        NSString *completeOutput;
+        @synchronized(output) {
+            completeOutput = [[NSString alloc] initWithData:output encoding:NSUTF8StringEncoding];
+            if (!completeOutput) {
+                // output that is not valid UTF-8 is kept rather than lost
+                completeOutput = [[NSString alloc] initWithData:output encoding:NSISOLatin1StringEncoding];
+            }
+        }
+        NSArray *objects = [[MRBrewOutputParser outputParser] objectsForOperation:completedOperation output:completeOutput error:nil];
+        [future fulfillWithOutput:completeOutput objects:objects];
+    } failure:^(MRBrewOperation *failedOperation, NSError *error) {
+        [future rejectWithError:error];
+    }];
+    
+    return future;
+}
+
+/* Returns the environment the specified operation is launched with: the
+ * receiver's environment, or the process's if none is set, with the
+ * operation's own variables applied. Returns nil if neither the receiver nor
+ * the operation sets any variables, so that the task inherits the process
+ * environment unchanged.
+ */
+- (NSDictionary *)environmentForOperation:(MRBrewOperation *)operation
+{
+    NSDictionary *overrides = [operation environment];
+    NSDictionary *environment = [self environment];
+    
+    if (![overrides count]) {
+        return environment;
+    }
+    
+    NSMutableDictionary *mergedEnvironment = [NSMutableDictionary dictionaryWithDictionary:(environment ? environment : [[NSProcessInfo processInfo] environment])];
+    [overrides enumerateKeysAndObjectsUsingBlock:^(NSString *name, id value, BOOL *stop) {
+        if (value == [NSNull null]) {
+            [mergedEnvironment removeObjectForKey:name];
+        }
+        else {
+            [mergedEnvironment setObject:value forKey:name];
+        }
+    }];
+    
+    return mergedEnvironment;
+}
+
+/* Returns a worker configured with the command-line arguments, environment
+ * and working directory for the specified operation, and the receiver's
+ * executable path. These are computed once, when the worker is created.
+ */
+- (MRBrewWorker *)workerForOperation:(MRBrewOperation *)operation
 {
     // construct command-line arguments for brew command
     NSMutableArray *arguments = [NSMutableArray array];
@@ -97,21 +308,84 @@ static NSString * MRDefaultBrewPath = @"/usr/local/bin/brew";
     if ([operation formula])
         [arguments addObject:[[operation formula] name]];
     
+    // the worker is given this instance's configuration so that instances
+    // managing different Homebrew installations never share it
     MRBrewWorker *worker = [[MRBrewWorker alloc] init];
     [worker setArguments:arguments];
     [worker setOperation:operation];
-    [worker setDelegate:delegate];
-    [[self backgroundQueue] addOperation:worker];
+    [worker setBrewPath:[self brewPath]];
+    [worker setEnvironment:[self environmentForOperation:operation]];
+    [worker setCurrentDirectoryPath:[operation workingDirectory]];
+    [worker setProgressInterval:[self progressInterval]];
+    [worker setLockRetryLimit:[self lockRetryLimit]];
+    [worker setLockRetryInterval:[self lockRetryInterval]];
+    [worker setOutputBufferLimit:[self outputBufferLimit]];
+    [worker setOutputBufferPolicy:[self outputBufferPolicy]];
+    
+    MRBrewOutdatedScanner *outdatedScanner = [self outdatedScanner];
+    if ([outdatedScanner canProduceOutputForOperation:operation]) {
+        [worker setOutputProvider:^NSData *{
+            return [outdatedScanner outputForOperation:operation];
+        }];
+    }
+    
+    // read-only operations do not take Homebrew's locks, so are never retried
+    // and their output is not held back
+    if (![operation isReadOnly]) {
+        __weak MRBrew *weakSelf = self;
+        [worker setRetryHandler:^(MRBrewWorker *retryWorker, NSTimeInterval delay) {
+            [weakSelf scheduleWorker:retryWorker afterDelay:delay];
+        }];
+    }
+    
+    return worker;
+}
+
+/* Adds the worker to the background queue once the delay has elapsed. Until
+ * then it is held with the other pending retries, so that it can be cancelled
+ * and is counted as queued.
+ */
+- (void)scheduleWorker:(MRBrewWorker *)worker afterDelay:(NSTimeInterval)delay
+{
+    @synchronized(_pendingRetryWorkers) {
+        [_pendingRetryWorkers addObject:worker];
+    }
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        @synchronized(_pendingRetryWorkers) {
+            [_pendingRetryWorkers removeObject:worker];
+        }
+        
+        [[self backgroundQueue] addOperation:worker];
+    });
+}
+
+/* Returns the workers in the background queue and those waiting to be
+ * retried.
+ */
+- (NSArray *)workers
+{
+    NSMutableArray *workers = [NSMutableArray arrayWithArray:[[self backgroundQueue] operations]];
+    
+    @synchronized(_pendingRetryWorkers) {
+        [workers addObjectsFromArray:[_pendingRetryWorkers allObjects]];
+    }
+    
+    return workers;
 }
 
 - (void)cancelAllOperations
 {
     [[self backgroundQueue] cancelAllOperations];
+    
+    @synchronized(_pendingRetryWorkers) {
+        [_pendingRetryWorkers makeObjectsPerformSelector:@selector(cancel)];
+    }
 }
 
 - (void)cancelOperation:(MRBrewOperation *)operation
 {
-    for (MRBrewWorker *worker in [[self backgroundQueue] operations]) {
+    for (MRBrewWorker *worker in [self workers]) {
         if ([[worker operation] isEqualToOperation:operation]) {
             [worker cancel];
             break;
@@ -121,7 +395,7 @@ static NSString * MRDefaultBrewPath = @"/usr/local/bin/brew";
 
 - (void)cancelAllOperationsOfType:(MRBrewOperationType)type
 {
-    if ([[self backgroundQueue] operationCount] > 0) {
+    if ([self operationCount] > 0) {
         NSString *operationName;
         switch (type) {
             case MRBrewOperationInfo:
@@ -150,7 +424,7 @@ static NSString * MRDefaultBrewPath = @"/usr/local/bin/brew";
                 break;
         }
         
-        for (MRBrewWorker *worker in [[self backgroundQueue] operations]) {
+        for (MRBrewWorker *worker in [self workers]) {
             if ([[[worker operation] name] isEqualToString:operationName]) {
                 [worker cancel];
             }
@@ -168,9 +442,19 @@ static NSString * MRDefaultBrewPath = @"/usr/local/bin/brew";
     }
 }
 
+- (void)setMaxConcurrentOperationCount:(NSInteger)count
+{
+    [[self backgroundQueue] setMaxConcurrentOperationCount:count];
+}
+
 - (NSUInteger)operationCount
 {
-    return [[self backgroundQueue] operationCount];
+    NSUInteger pendingRetryCount;
+    @synchronized(_pendingRetryWorkers) {
+        pendingRetryCount = [_pendingRetryWorkers count];
+    }
+    
+    return [[self backgroundQueue] operationCount] + pendingRetryCount;
 }
 
 - (NSDictionary *)environment
@@ -0,0 +1,102 @@
+//
+//  MRBrewChange.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/** These constants indicate the type of change described by an MRBrewChange
+ * object.
+ */
+typedef NS_ENUM(NSInteger, MRBrewChangeType) {
+    /** A formula that was not previously installed has been installed. */
+    MRBrewChangeFormulaInstalled,
+    /** All installed versions of a formula have been removed. */
+    MRBrewChangeFormulaRemoved,
+    /** A version of an installed formula has been added to the Cellar. */
+    MRBrewChangeVersionAdded,
+    /** A version of a formula has been removed from the Cellar while at least
+     * one other version remains installed. */
+    MRBrewChangeVersionRemoved,
+    /** A formula has been linked, or linked to a different version. */
+    MRBrewChangeFormulaLinked,
+    /** A formula has been unlinked. */
+    MRBrewChangeFormulaUnlinked,
+    /** A formula has been pinned. */
+    MRBrewChangeFormulaPinned,
+    /** A formula has been unpinned. */
+    MRBrewChangeFormulaUnpinned
+};
+
+/** An `MRBrewChange` object describes a single change to the installed state of
+ * a formula, as computed by an MRBrewSnapshot.
+ *
+ * Change objects are immutable.
+ */
+@interface MRBrewChange : NSObject <NSCopying>
+
+/** The type of the change. */
+@property (readonly) MRBrewChangeType type;
+
+/** The name of the formula that changed. */
+@property (readonly, copy) NSString *formulaName;
+
+/** The version the change applies to, or `nil` if the change applies to the
+ * formula as a whole. For MRBrewChangeFormulaInstalled this is the newest
+ * installed version, for MRBrewChangeFormulaLinked the version now linked and
+ * for MRBrewChangeFormulaPinned the version pinned.
+ */
+@property (readonly, copy) NSString *version;
+
+/**-----------------------------------------------------------------------------
+ * @name Creating a Change
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns an initialized `MRBrewChange` object with the specified type,
+ * formula name and version.
+ *
+ * @param type The type of the change.
+ * @param formulaName The name of the formula that changed.
+ * @param version The version the change applies to, or `nil`.
+ * @return A change with the specified properties.
+ */
+- (instancetype)initWithType:(MRBrewChangeType)type formulaName:(NSString *)formulaName version:(NSString *)version;
+
+/** Returns a change with the specified type, formula name and version.
+ *
+ * @param type The type of the change.
+ * @param formulaName The name of the formula that changed.
+ * @param version The version the change applies to, or `nil`.
+ * @return A change with the specified properties.
+ */
++ (instancetype)changeWithType:(MRBrewChangeType)type formulaName:(NSString *)formulaName version:(NSString *)version;
+
+/** Compares the receiver to another change.
+ *
+ * @param change The change with which to compare the receiver.
+ * @return YES if the receiver is equal to _change_, otherwise NO.
+ */
+- (BOOL)isEqualToChange:(MRBrewChange *)change;
+
+@end
@@ -0,0 +1,93 @@
+//
+//  MRBrewChange.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewChange.h"
+
+@implementation MRBrewChange
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithType:(MRBrewChangeType)type formulaName:(NSString *)formulaName version:(NSString *)version
+{
+    if (self = [super init]) {
+        _type = type;
+        _formulaName = [formulaName copy];
+        _version = [version copy];
+    }
+    
+    return self;
+}
+
++ (instancetype)changeWithType:(MRBrewChangeType)type formulaName:(NSString *)formulaName version:(NSString *)version
+{
+    return [[self alloc] initWithType:type
+                          formulaName:formulaName
+                              version:version];
+}
+
+#pragma mark - Equality
+
+- (BOOL)isEqualToChange:(MRBrewChange *)change
+{
+    if (self == change)
+        return YES;
+    
+    if (!change || ![change isKindOfClass:[self class]])
+        return NO;
+    
+    if ([self type] != [change type])
+        return NO;
+    if (![[self formulaName] isEqualToString:[change formulaName]])
+        return NO;
+    if ([self version] != [change version] && ![[self version] isEqualToString:[change version]])
+        return NO;
+    
+    return YES;
+}
+
+- (BOOL)isEqual:(id)object
+{
+    return [self isEqualToChange:object];
+}
+
+- (NSUInteger)hash
+{
+    return [[self formulaName] hash] ^ [[self version] hash] ^ (NSUInteger)[self type];
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p type=%ld formula=%@ version=%@>", [self class], self, (long)[self type], [self formulaName], [self version]];
+}
+
+#pragma mark - NSCopying protocol
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // immutable
+    return self;
+}
+
+@end
@@ -34,3 +34,14 @@ extern NSString * const MRBrewOperationRemoveIdentifier;
 extern NSString * const MRBrewOperationOptionsIdentifier;
 extern NSString * const MRBrewOperationOutdatedIdentifier;
 
+extern NSString * const MRBrewOperationJSONInfoParameter;
+
+// the domain of errors whose codes are MRBrewError constants
+extern NSString * const MRBrewErrorDomain;
+
+// posted by MRBrewWorker on its own thread with the MRBrewOperation as the
+// notification object, immediately before the brew task is launched and after
+// it has exited
+extern NSString * const MRBrewOperationWillLaunchNotification;
+extern NSString * const MRBrewOperationDidExitNotification;
+
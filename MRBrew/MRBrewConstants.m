@@ -34,3 +34,10 @@ NSString * const MRBrewOperationRemoveIdentifier = @"remove";
 NSString * const MRBrewOperationOptionsIdentifier = @"options";
 NSString * const MRBrewOperationOutdatedIdentifier = @"outdated";
 
+NSString * const MRBrewOperationJSONInfoParameter = @"--json=v1";
+
+NSString * const MRBrewErrorDomain = @"uk.co.fidgetbox.MRBrew";
+
+NSString * const MRBrewOperationWillLaunchNotification = @"MRBrewOperationWillLaunchNotification";
+NSString * const MRBrewOperationDidExitNotification = @"MRBrewOperationDidExitNotification";
+
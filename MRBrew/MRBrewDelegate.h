@@ -26,6 +26,8 @@
 #import <Foundation/Foundation.h>
 #import "MRBrewOperation.h"
 
+@class MRBrewProgress;
+
 /** The `MRBrewDelegate` protocol defines the optional methods implemented by
  delegates of the MRBrew class.
  
@@ -76,4 +78,47 @@
  */
 - (void)brewOperation:(MRBrewOperation *)operation didGenerateOutput:(NSString *)output;
 
+/** This method is called when output is received from Homebrew, with the
+ * bytes exactly as they were read. Implement it instead of
+ * brewOperation:didGenerateOutput: to pass output on without decoding it.
+ *
+ * The data object is the buffer the output was read into and is not copied.
+ * It is immutable and remains valid for as long as it is retained. Chunk
+ * boundaries are arbitrary and may fall within a multibyte UTF-8 character.
+ *
+ * @param operation The type of operation that generated the output.
+ * @param data The output bytes.
+ */
+- (void)brewOperation:(MRBrewOperation *)operation didGenerateData:(NSData *)data;
+
+/** This method is called when error output is received from Homebrew.
+ *
+ * Error output is buffered and delivered separately from output, so the two
+ * are not interleaved in the order Homebrew wrote them.
+ *
+ * @param operation The type of operation that generated the error output.
+ * @param output The error output string.
+ */
+- (void)brewOperation:(MRBrewOperation *)operation didGenerateErrorOutput:(NSString *)output;
+
+/** This method is called before an operation finishes if some of its output
+ * was discarded because it was generated faster than it could be delivered
+ * (see `MRBrew`'s outputBufferPolicy).
+ *
+ * @param operation The type of operation whose output was discarded.
+ * @param length The number of bytes of output discarded.
+ * @param errorLength The number of bytes of error output discarded.
+ */
+- (void)brewOperation:(MRBrewOperation *)operation didDropOutputLength:(NSUInteger)length errorOutputLength:(NSUInteger)errorLength;
+
+/** This method is called when the progress of an operation changes, as
+ * recognised from Homebrew's output. Progress that starts a new phase is
+ * delivered immediately; updates within a phase, such as download
+ * percentages, are delivered at most once per `MRBrew`'s progressInterval.
+ *
+ * @param operation The type of operation whose progress changed.
+ * @param progress The operation's progress.
+ */
+- (void)brewOperation:(MRBrewOperation *)operation didUpdateProgress:(MRBrewProgress *)progress;
+
 @end
@@ -0,0 +1,69 @@
+//
+//  MRBrewDiskUsage.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+@class MRBrewFormula;
+
+/** An `MRBrewDiskUsage` object describes the disk space used by an installed
+ * formula, or by one of its installed versions (kegs), as measured by an
+ * `MRBrewDiskUsageScanner`.
+ *
+ * Sizes are the space allocated to files and directories, as reported by
+ * `du`, rather than the lengths of the files. A file with several hard links
+ * is counted once, however many of its links are within the measured kegs.
+ */
+@interface MRBrewDiskUsage : NSObject <NSCopying>
+
+/** The formula whose disk usage is described. */
+@property (readonly) MRBrewFormula *formula;
+
+/** The installed version whose disk usage is described, or `nil` if the
+ * receiver describes all of the formula's installed versions.
+ */
+@property (readonly, copy) NSString *version;
+
+/** The number of bytes allocated to the formula's or version's files and
+ * directories.
+ */
+@property (readonly) unsigned long long size;
+
+/** The number of files, symbolic links and other non-directory entries. */
+@property (readonly) NSUInteger fileCount;
+
+/** An array of `MRBrewDiskUsage` objects describing each installed version of
+ * the formula, ordered by version, or `nil` if the receiver describes a single
+ * version.
+ */
+@property (readonly, copy) NSArray *versionUsages;
+
+/** Returns the disk usage of one of the formula's installed versions.
+ *
+ * @param version An installed version, such as `1.15`.
+ * @return The disk usage of _version_, or `nil` if it is not installed.
+ */
+- (MRBrewDiskUsage *)usageForVersion:(NSString *)version;
+
+@end
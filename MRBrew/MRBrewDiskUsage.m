@@ -0,0 +1,69 @@
+//
+//  MRBrewDiskUsage.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewDiskUsage.h"
+#import "MRBrewDiskUsage+Private.h"
+#import "MRBrewFormula.h"
+
+@implementation MRBrewDiskUsage
+
+- (instancetype)initWithFormula:(MRBrewFormula *)formula version:(NSString *)version size:(unsigned long long)size fileCount:(NSUInteger)fileCount versionUsages:(NSArray *)versionUsages
+{
+    if (self = [super init]) {
+        _formula = formula;
+        _version = [version copy];
+        _size = size;
+        _fileCount = fileCount;
+        _versionUsages = [versionUsages copy];
+    }
+    
+    return self;
+}
+
+- (MRBrewDiskUsage *)usageForVersion:(NSString *)version
+{
+    for (MRBrewDiskUsage *usage in [self versionUsages]) {
+        if ([[usage version] isEqualToString:version]) {
+            return usage;
+        }
+    }
+    
+    return nil;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p formula=%@ version=%@ size=%llu files=%lu>", [self class], self, [[self formula] name], [self version], [self size], (unsigned long)[self fileCount]];
+}
+
+#pragma mark - NSCopying protocol
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // disk usages are immutable
+    return self;
+}
+
+@end
@@ -0,0 +1,103 @@
+//
+//  MRBrewDiskUsageScanner.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+@class MRBrewLocations;
+
+/** An `MRBrewDiskUsageScanner` object measures the disk space used by the
+ * formulae installed in a Homebrew `Cellar`, without running `du`.
+ *
+ * Each installed version of a formula (keg) is walked separately, and kegs are
+ * walked concurrently, so a few large kegs do not hold up the rest of a scan.
+ * Files with several hard links are counted once within a formula.
+ *
+ * The measurements of each keg are cached by the scanner. A keg is walked again
+ * only if it has been replaced, or if any directory within it has been
+ * modified since it was last walked, i.e. an entry has been added, removed or
+ * renamed at any depth. Checking this reads the keg's directories but does not
+ * examine its files, so a scan after installing or removing a formula walks
+ * only the kegs that changed.
+ *
+ * @warning A file that is rewritten in place, rather than replaced, does not
+ * modify its directory, so a change in its size is not noticed. Homebrew does
+ * not modify kegs in this way once they are installed; call
+ * discardCachedMeasurements if they may have been.
+ */
+@interface MRBrewDiskUsageScanner : NSObject
+
+/** The locations of the Homebrew installation that is scanned. */
+@property (readonly, copy) MRBrewLocations *locations;
+
+/** The number of kegs walked by the most recent scan, as opposed to those
+ * measured from the cache.
+ */
+@property (readonly) NSUInteger walkedKegCount;
+
+/**-----------------------------------------------------------------------------
+ * @name Creating a Scanner
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns an initialized `MRBrewDiskUsageScanner` object for the Homebrew
+ * installation described by `MRBrewLocations`' defaultLocations.
+ *
+ * @return A scanner for the default installation.
+ */
+- (instancetype)init;
+
+/** Returns an initialized `MRBrewDiskUsageScanner` object for the Homebrew
+ * installation at the specified locations.
+ *
+ * @param locations The locations of the installation to scan.
+ * @return A scanner for the specified installation.
+ */
+- (instancetype)initWithLocations:(MRBrewLocations *)locations;
+
+/**-----------------------------------------------------------------------------
+ * @name Scanning
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns the disk usage of the specified formulae, such as those parsed from
+ * the output of a list operation.
+ *
+ * This method walks the file system and should not be called on the main
+ * thread.
+ *
+ * @param formulae An array of `MRBrewFormula` objects, or `nil` to measure
+ * every installed formula.
+ * @return An array of `MRBrewDiskUsage` objects, one for each formula in
+ * _formulae_ and in the same order, or ordered by name if _formulae_ is `nil`.
+ * Formulae that are not installed have a size of zero and no version usages.
+ */
+- (NSArray *)diskUsageOfFormulae:(NSArray *)formulae;
+
+/** Discards the cached measurements of every keg, so that the next scan walks
+ * every keg it measures.
+ */
+- (void)discardCachedMeasurements;
+
+@end
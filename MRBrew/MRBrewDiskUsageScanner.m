@@ -0,0 +1,350 @@
+//
+//  MRBrewDiskUsageScanner.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewDiskUsageScanner.h"
+#import "MRBrewDiskUsage.h"
+#import "MRBrewDiskUsage+Private.h"
+#import "MRBrewFormula.h"
+#import "MRBrewLocations.h"
+#import "MRBrewSnapshot.h"
+#import "MRBrewVersion.h"
+#include <errno.h>
+#include <fts.h>
+#include <sys/stat.h>
+
+/* The size du reports for an entry: the blocks allocated to it, which are
+ * always counted in units of 512 bytes.
+ */
+static inline unsigned long long MRBrewAllocatedSize(const struct stat *status)
+{
+    return (unsigned long long)status->st_blocks * 512;
+}
+
+/* The modification time of an entry, which Linux and Darwin name differently. */
+static inline struct timespec MRBrewModificationTime(const struct stat *status)
+{
+#if defined(__linux__)
+    return status->st_mtim;
+#else
+    return status->st_mtimespec;
+#endif
+}
+
+/* Advances latest to the modification time of an entry if it is later. */
+static inline void MRBrewUpdateLatestModificationTime(struct timespec *latest, const struct stat *status)
+{
+    struct timespec modificationTime = MRBrewModificationTime(status);
+    if (modificationTime.tv_sec > latest->tv_sec || (modificationTime.tv_sec == latest->tv_sec && modificationTime.tv_nsec > latest->tv_nsec)) {
+        *latest = modificationTime;
+    }
+}
+
+/* A keg's signature: the inode of its directory and the latest modification
+ * time among all of the directories within it.
+ */
+static inline NSString *MRBrewKegSignature(ino_t inode, struct timespec latest)
+{
+    return [NSString stringWithFormat:@"%llu:%ld.%09ld", (unsigned long long)inode, (long)latest.tv_sec, (long)latest.tv_nsec];
+}
+
+/* The measurements of a single keg. Files with more than one link are kept
+ * apart, keyed by device and inode, so that a file linked from several kegs of
+ * the same formula is counted once in the formula's total.
+ */
+@interface MRBrewKegMeasurement : NSObject
+{
+    @public
+    NSString *_version;
+    NSString *_signature;
+    unsigned long long _size;
+    NSUInteger _fileCount;
+    NSDictionary *_linkedFileSizes;
+}
+
+@end
+
+@implementation MRBrewKegMeasurement
+
+@end
+
+@interface MRBrewDiskUsageScanner ()
+{
+    @private
+    NSMutableDictionary *_measurements;
+}
+
+@end
+
+@implementation MRBrewDiskUsageScanner
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    return [self initWithLocations:[MRBrewLocations defaultLocations]];
+}
+
+- (instancetype)initWithLocations:(MRBrewLocations *)locations
+{
+    if (self = [super init]) {
+        _locations = [locations copy];
+        _measurements = [NSMutableDictionary dictionary];
+    }
+    
+    return self;
+}
+
+#pragma mark - Scanning
+
+- (NSArray *)diskUsageOfFormulae:(NSArray *)formulae
+{
+    MRBrewLocations *locations = [self locations];
+    MRBrewSnapshot *snapshot = [MRBrewSnapshot snapshotWithCellarPath:[locations cellarPath]
+                                                       linkedKegsPath:[locations linkedKegsPath]
+                                                       pinnedKegsPath:[locations pinnedKegsPath]];
+    [snapshot reload];
+    
+    if (!formulae) {
+        NSMutableArray *installedFormulae = [NSMutableArray array];
+        for (NSString *name in [[[snapshot installedFormulaNames] allObjects] sortedArrayUsingSelector:@selector(compare:)]) {
+            [installedFormulae addObject:[MRBrewFormula formulaWithName:name]];
+        }
+        formulae = installedFormulae;
+    }
+    
+    // every keg is a separate unit of work, so that the kegs of a formula
+    // with many large versions are spread across threads
+    NSMutableArray *kegPaths = [NSMutableArray array];
+    NSMutableArray *kegVersions = [NSMutableArray array];
+    for (MRBrewFormula *formula in formulae) {
+        NSString *formulaPath = [[locations cellarPath] stringByAppendingPathComponent:[formula name]];
+        for (NSString *version in [snapshot versionsForFormula:[formula name]]) {
+            [kegPaths addObject:[formulaPath stringByAppendingPathComponent:version]];
+            [kegVersions addObject:version];
+        }
+    }
+    
+    NSMutableDictionary *measurements = [NSMutableDictionary dictionaryWithCapacity:[kegPaths count]];
+    __block NSUInteger walkedKegCount = 0;
+    
+    // iterations are handed to threads as they become free, so threads that
+    // finish small kegs go on to take the remaining ones
+    dispatch_apply([kegPaths count], dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        @autoreleasepool {
+            NSString *path = [kegPaths objectAtIndex:i];
+            
+            MRBrewKegMeasurement *measurement;
+            @synchronized(_measurements) {
+                measurement = [_measurements objectForKey:path];
+            }
+            
+            // the signature of a keg that has not been measured is gathered
+            // by the walk that measures it
+            if (!measurement || ![measurement->_signature isEqualToString:[self signatureOfKegAtPath:path]]) {
+                measurement = [self measureKegAtPath:path];
+                measurement->_version = [kegVersions objectAtIndex:i];
+                
+                @synchronized(_measurements) {
+                    [_measurements setObject:measurement forKey:path];
+                    walkedKegCount++;
+                }
+            }
+            
+            @synchronized(measurements) {
+                [measurements setObject:measurement forKey:path];
+            }
+        }
+    });
+    
+    // kegs that have been removed are no longer worth keeping
+    @synchronized(_measurements) {
+        for (NSString *path in [_measurements allKeys]) {
+            if (![measurements objectForKey:path] && ![[NSFileManager defaultManager] fileExistsAtPath:path]) {
+                [_measurements removeObjectForKey:path];
+            }
+        }
+        _walkedKegCount = walkedKegCount;
+    }
+    
+    NSMutableArray *usages = [NSMutableArray arrayWithCapacity:[formulae count]];
+    for (MRBrewFormula *formula in formulae) {
+        NSString *formulaPath = [[locations cellarPath] stringByAppendingPathComponent:[formula name]];
+        NSMutableArray *kegMeasurements = [NSMutableArray array];
+        for (NSString *version in [snapshot versionsForFormula:[formula name]]) {
+            [kegMeasurements addObject:[measurements objectForKey:[formulaPath stringByAppendingPathComponent:version]]];
+        }
+        [usages addObject:[self usageOfFormula:formula kegMeasurements:kegMeasurements]];
+    }
+    
+    return usages;
+}
+
+- (void)discardCachedMeasurements
+{
+    @synchronized(_measurements) {
+        [_measurements removeAllObjects];
+    }
+}
+
+/* Combines the measurements of a formula's kegs, counting files linked from
+ * more than one of them once.
+ */
+- (MRBrewDiskUsage *)usageOfFormula:(MRBrewFormula *)formula kegMeasurements:(NSArray *)kegMeasurements
+{
+    NSArray *sortedMeasurements = [kegMeasurements sortedArrayUsingComparator:^NSComparisonResult(MRBrewKegMeasurement *measurement, MRBrewKegMeasurement *otherMeasurement) {
+        return [MRBrewVersion compareVersion:measurement->_version toVersion:otherMeasurement->_version];
+    }];
+    
+    NSMutableArray *versionUsages = [NSMutableArray arrayWithCapacity:[sortedMeasurements count]];
+    NSMutableDictionary *linkedFileSizes = [NSMutableDictionary dictionary];
+    unsigned long long size = 0;
+    NSUInteger fileCount = 0;
+    
+    for (MRBrewKegMeasurement *measurement in sortedMeasurements) {
+        unsigned long long linkedSize = 0;
+        for (NSNumber *linkedFileSize in [measurement->_linkedFileSizes allValues]) {
+            linkedSize += [linkedFileSize unsignedLongLongValue];
+        }
+        
+        [versionUsages addObject:[[MRBrewDiskUsage alloc] initWithFormula:formula
+                                                                  version:measurement->_version
+                                                                     size:measurement->_size + linkedSize
+                                                                fileCount:measurement->_fileCount + [measurement->_linkedFileSizes count]
+                                                            versionUsages:nil]];
+        
+        size += measurement->_size;
+        fileCount += measurement->_fileCount;
+        [linkedFileSizes addEntriesFromDictionary:measurement->_linkedFileSizes];
+    }
+    
+    for (NSNumber *linkedFileSize in [linkedFileSizes allValues]) {
+        size += [linkedFileSize unsignedLongLongValue];
+    }
+    fileCount += [linkedFileSizes count];
+    
+    return [[MRBrewDiskUsage alloc] initWithFormula:formula version:nil size:size fileCount:fileCount versionUsages:versionUsages];
+}
+
+#pragma mark - File System
+
+/* Returns a string that changes when a keg is replaced or when an entry is
+ * added to, removed from or renamed within any directory in it. Only the
+ * directories are examined, so this is much cheaper than measuring the keg.
+ */
+- (NSString *)signatureOfKegAtPath:(NSString *)path
+{
+    // files are not stat'd, as only the directories are needed
+    char *paths[] = {(char *)[path fileSystemRepresentation], NULL};
+    FTS *traversal = fts_open(paths, FTS_PHYSICAL | FTS_NOCHDIR | FTS_NOSTAT, NULL);
+    if (!traversal) {
+        return nil;
+    }
+    
+    NSString *signature = nil;
+    ino_t inode = 0;
+    struct timespec latest = {0, 0};
+    
+    FTSENT *entry;
+    while ((entry = fts_read(traversal)) != NULL) {
+        if (entry->fts_info != FTS_D) {
+            continue;
+        }
+        if (entry->fts_level == FTS_ROOTLEVEL) {
+            inode = entry->fts_statp->st_ino;
+        }
+        MRBrewUpdateLatestModificationTime(&latest, entry->fts_statp);
+    }
+    
+    if (errno == 0 && inode != 0) {
+        signature = MRBrewKegSignature(inode, latest);
+    }
+    
+    fts_close(traversal);
+    
+    return signature;
+}
+
+/* Walks a keg without following symbolic links, totalling the space allocated
+ * to its entries as du does. Files with more than one link are recorded by
+ * device and inode instead, once each, to be totalled by the caller. The keg's
+ * signature is gathered from the directories on the way; each is stat'd before
+ * its entries are read, so a change made during the walk is noticed later.
+ */
+- (MRBrewKegMeasurement *)measureKegAtPath:(NSString *)path
+{
+    MRBrewKegMeasurement *measurement = [[MRBrewKegMeasurement alloc] init];
+    NSMutableDictionary *linkedFileSizes = [NSMutableDictionary dictionary];
+    
+    char *paths[] = {(char *)[path fileSystemRepresentation], NULL};
+    FTS *traversal = fts_open(paths, FTS_PHYSICAL | FTS_NOCHDIR, NULL);
+    if (!traversal) {
+        measurement->_linkedFileSizes = linkedFileSizes;
+        return measurement;
+    }
+    
+    ino_t inode = 0;
+    struct timespec latest = {0, 0};
+    
+    FTSENT *entry;
+    while ((entry = fts_read(traversal)) != NULL) {
+        switch (entry->fts_info) {
+            case FTS_D:
+                measurement->_size += MRBrewAllocatedSize(entry->fts_statp);
+                if (entry->fts_level == FTS_ROOTLEVEL) {
+                    inode = entry->fts_statp->st_ino;
+                }
+                MRBrewUpdateLatestModificationTime(&latest, entry->fts_statp);
+                break;
+            case FTS_F:
+            case FTS_SL:
+            case FTS_SLNONE:
+            case FTS_DEFAULT:
+                if (entry->fts_statp->st_nlink > 1) {
+                    NSString *key = [NSString stringWithFormat:@"%llu:%llu", (unsigned long long)entry->fts_statp->st_dev, (unsigned long long)entry->fts_statp->st_ino];
+                    [linkedFileSizes setObject:@(MRBrewAllocatedSize(entry->fts_statp)) forKey:key];
+                }
+                else {
+                    measurement->_size += MRBrewAllocatedSize(entry->fts_statp);
+                    measurement->_fileCount++;
+                }
+                break;
+            default:
+                // directories are counted on the way in, and entries that
+                // cannot be read are skipped as du skips them
+                break;
+        }
+    }
+    
+    if (errno == 0 && inode != 0) {
+        measurement->_signature = MRBrewKegSignature(inode, latest);
+    }
+    
+    fts_close(traversal);
+    
+    measurement->_linkedFileSizes = linkedFileSizes;
+    return measurement;
+}
+
+@end
@@ -0,0 +1,123 @@
+//
+//  MRBrewFSEventsWatcherBackend.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewFSEventsWatcherBackend.h"
+
+#if defined(__APPLE__)
+
+#import <CoreServices/CoreServices.h>
+
+@interface MRBrewFSEventsWatcherBackend ()
+{
+    @private
+    FSEventStreamRef _eventStream;
+    MRBrewWatcherBackendHandler _handler;
+}
+
+@end
+
+@implementation MRBrewFSEventsWatcherBackend
+
+#pragma mark - FSEvents Callback
+
+static void fileSystemEventsCallback(ConstFSEventStreamRef streamRef, void *userData, size_t numEvents, void *eventPaths, const FSEventStreamEventFlags eventFlags[], const FSEventStreamEventId eventIds[])
+{
+    MRBrewFSEventsWatcherBackend *backend = (__bridge MRBrewFSEventsWatcherBackend *)userData;
+
+    // an ordered set removes duplicate paths in linear time while preserving
+    // the order in which events were reported
+    NSArray *modifiedPaths = [[NSOrderedSet orderedSetWithArray:(__bridge NSArray *)eventPaths] array];
+
+    if (backend->_handler) {
+        backend->_handler(modifiedPaths);
+    }
+}
+
+#pragma mark - Control
+
+- (BOOL)startWatchingPaths:(NSArray *)paths latency:(NSTimeInterval)latency handler:(MRBrewWatcherBackendHandler)handler
+{
+    // stop existing event stream if one exists
+    if (_eventStream) {
+        [self stopWatching];
+    }
+
+    _handler = [handler copy];
+
+    // create an event stream context with a reference to this
+    // backend object for use by our callback method
+    FSEventStreamContext eventStreamContext;
+    eventStreamContext.info = (__bridge void *)(self);
+    eventStreamContext.version = 0;
+    eventStreamContext.retain = NULL;
+    eventStreamContext.release = NULL;
+    eventStreamContext.copyDescription = NULL;
+
+    // create an event stream and register a callback
+    _eventStream = FSEventStreamCreate(NULL,
+                                       &fileSystemEventsCallback,
+                                       &eventStreamContext,
+                                       (__bridge CFArrayRef) paths,
+                                       kFSEventStreamEventIdSinceNow,
+                                       (CFAbsoluteTime) latency,
+                                       kFSEventStreamCreateFlagUseCFTypes);
+
+    if (!_eventStream) {
+        return NO;
+    }
+
+    FSEventStreamScheduleWithRunLoop(_eventStream,
+                                     CFRunLoopGetCurrent(),
+                                     kCFRunLoopDefaultMode);
+
+    return FSEventStreamStart(_eventStream);
+}
+
+- (void)stopWatching
+{
+    if (!(_eventStream)) {
+        return;
+    }
+
+    FSEventStreamStop(_eventStream);
+    FSEventStreamInvalidate(_eventStream);
+    FSEventStreamRelease(_eventStream);
+    _eventStream = NULL;
+    _handler = nil;
+}
+
+- (BOOL)isWatching
+{
+    return _eventStream != NULL;
+}
+
+- (void)dealloc
+{
+    [self stopWatching];
+}
+
+@end
+
+#endif
@@ -0,0 +1,48 @@
+//
+//  MRBrewFormula+Private.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewFormula.h"
+
+/* Formulae that are not interned are built by the objects that parse brew's
+ * output using the methods below, and must not be modified once they have been
+ * passed to a client.
+ */
+@interface MRBrewFormula ()
+
+@property (readwrite) BOOL isInstalled;
+@property (readwrite) BOOL isPinned;
+@property (readwrite) BOOL isOutdated;
+@property (readwrite, copy) NSString *stableVersion;
+@property (readwrite, copy) NSString *develVersion;
+@property (readwrite, copy) NSString *headVersion;
+@property (readwrite, copy) NSArray *installedVersions;
+@property (readwrite, copy) NSString *availableVersion;
+@property (readwrite, copy) NSString *linkedVersion;
+@property (readwrite, copy) NSArray *dependencies;
+@property (readwrite, copy) NSArray *options;
+
+- (void)setName:(NSString *)name;
+
+@end
@@ -27,20 +27,73 @@
 
 /** An `MRBrewFormula` object represents a formula in the Homebrew package
  * manager.
+ *
+ * Formulae are immutable. Formulae created with a name and status are interned:
+ * creating a formula with the same name and status as an existing one returns
+ * the existing object, so identical formulae can be compared by pointer and
+ * copying a formula returns the receiver. The names of all formulae are
+ * interned in the same way and each formula caches its hash, so formulae can be
+ * compared, deduplicated and used as dictionary keys without comparing their
+ * names character by character.
+ *
+ * Formulae parsed from the output of a JSON info operation (see
+ * `MRBrewOperation`'s infoOperationForFormulae:) also describe the formula's
+ * versions, installed kegs, dependencies and options, and whether it is pinned
+ * or outdated. Formulae parsed from the output of an outdated operation
+ * describe their installed versions, the version available to upgrade to, and
+ * whether they are pinned. For formulae created in any other way these
+ * properties are `nil` or `NO`. Parsed formulae are not interned, but share
+ * their name with other formulae of the same name.
  */
 @interface MRBrewFormula : NSObject <NSCopying>
 
 /** The name of the formula. */
-@property (copy) NSString *name;
+@property (readonly, copy) NSString *name;
 
 /** A boolean value representing whether the formula has been updated. */
-@property (assign) BOOL isUpdated;
+@property (readonly) BOOL isUpdated;
 
 /** A boolean value representing whether the formula is new.*/
-@property (assign) BOOL isNew;
+@property (readonly) BOOL isNew;
 
 /** A boolean value representing whether the formula is installed. */
-@property (assign) BOOL isInstalled;
+@property (readonly) BOOL isInstalled;
+
+/** A boolean value representing whether the formula is pinned. */
+@property (readonly) BOOL isPinned;
+
+/** A boolean value representing whether an installed formula is outdated. */
+@property (readonly) BOOL isOutdated;
+
+/** The current stable version of the formula. */
+@property (readonly, copy) NSString *stableVersion;
+
+/** The current development version of the formula, if it has one. */
+@property (readonly, copy) NSString *develVersion;
+
+/** The head version of the formula, if it can be installed from HEAD. */
+@property (readonly, copy) NSString *headVersion;
+
+/** An array of strings containing the installed versions (kegs) of the
+ * formula.
+ */
+@property (readonly, copy) NSArray *installedVersions;
+
+/** The version that an outdated formula can be upgraded to. This property is
+ * only set for formulae parsed from the output of an outdated operation.
+ */
+@property (readonly, copy) NSString *availableVersion;
+
+/** The installed version that is linked into the Homebrew prefix. */
+@property (readonly, copy) NSString *linkedVersion;
+
+/** An array of strings containing the names of the formula's dependencies. */
+@property (readonly, copy) NSArray *dependencies;
+
+/** An array of `MRBrewInstallOption` objects describing the formula's install
+ * options.
+ */
+@property (readonly, copy) NSArray *options;
 
 /**-----------------------------------------------------------------------------
  * @name Initialising a Formula
@@ -50,7 +103,8 @@
 /** Returns an initialized `MRBrewFormula` object with the specified name.
  *
  * @param name The name of the formula.
- * @return A formula with the specified name.
+ * @return The interned formula with the specified name, or a new formula if
+ * _name_ is `nil`.
  */
 - (instancetype)initWithName:(NSString *)name;
 
@@ -62,7 +116,8 @@
  * @param isUpdated A boolean value representing whether the formula is updated.
  * @param isInstalled A boolean value representing whether the formula is
  * installed.
- * @return A formula with the specified properties.
+ * @return The interned formula with the specified properties, or a new formula
+ * if _name_ is `nil`.
  */
 - (instancetype)initWithName:(NSString *)name isNew:(BOOL)isNew isUpdated:(BOOL)isUpdated isInstalled:(BOOL)isInstalled;
 
@@ -90,6 +145,9 @@
 + (instancetype)formulaWithName:(NSString *)name isNew:(BOOL)isNew isUpdated:(BOOL)isUpdated isInstalled:(BOOL)isInstalled;
 
 /** Compares the receiver to another formula.
+ *
+ * Formulae with different names are rejected by comparing their interned
+ * names by pointer.
  *
  * @param formula The formula with which to compare the receiver.
  * @return YES if the receiver is equal to _formula_, otherwise NO.
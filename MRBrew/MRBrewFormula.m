@@ -24,9 +24,114 @@
 //
 
 #import "MRBrewFormula.h"
+#import "MRBrewFormula+Private.h"
+
+/* The number of combinations of the isNew, isUpdated and isInstalled
+ * properties, each of which has its own interned formula.
+ */
+enum {
+    MRBrewFormulaStatusCount = 8
+};
+
+static inline BOOL MRBrewObjectsEqual(id object, id otherObject)
+{
+    return object == otherObject || [object isEqual:otherObject];
+}
+
+static inline NSUInteger MRBrewFormulaStatusIndex(BOOL isNew, BOOL isUpdated, BOOL isInstalled)
+{
+    return (isNew ? 1 : 0) | (isUpdated ? 2 : 0) | (isInstalled ? 4 : 0);
+}
+
+/* An entry in the intern table: the canonical copy of a formula name, and the
+ * formulae created with that name for each status, created as they are first
+ * requested.
+ */
+@interface MRBrewFormulaInternEntry : NSObject
+{
+    @public
+    NSString *_name;
+    NSUInteger _hash;
+    MRBrewFormula *_formulae[MRBrewFormulaStatusCount];
+}
+
+@end
+
+@implementation MRBrewFormulaInternEntry
+
+@end
+
+@interface MRBrewFormula ()
+{
+    @private
+    NSUInteger _hash;
+}
+
+- (instancetype)initWithEntry:(MRBrewFormulaInternEntry *)entry isNew:(BOOL)isNew isUpdated:(BOOL)isUpdated isInstalled:(BOOL)isInstalled;
+
+@end
 
 @implementation MRBrewFormula
 
+#pragma mark - Interning
+
+/* Returns the intern table entry for the specified name, creating it if
+ * necessary. Entries are never removed; the table is bounded by the number of
+ * formulae Homebrew knows about. The caller must hold the table's lock.
+ */
++ (MRBrewFormulaInternEntry *)internEntryForName:(NSString *)name inTable:(NSMutableDictionary *)table
+{
+    MRBrewFormulaInternEntry *entry = [table objectForKey:name];
+    
+    if (!entry) {
+        entry = [[MRBrewFormulaInternEntry alloc] init];
+        entry->_name = [name copy];
+        entry->_hash = [entry->_name hash];
+        [table setObject:entry forKey:entry->_name];
+    }
+    
+    return entry;
+}
+
++ (NSMutableDictionary *)internTable
+{
+    static NSMutableDictionary *table = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        table = [NSMutableDictionary dictionary];
+    });
+    
+    return table;
+}
+
++ (MRBrewFormulaInternEntry *)internEntryForName:(NSString *)name
+{
+    NSMutableDictionary *table = [self internTable];
+    
+    @synchronized(table) {
+        return [self internEntryForName:name inTable:table];
+    }
+}
+
++ (MRBrewFormula *)internedFormulaWithName:(NSString *)name isNew:(BOOL)isNew isUpdated:(BOOL)isUpdated isInstalled:(BOOL)isInstalled
+{
+    NSMutableDictionary *table = [self internTable];
+    NSUInteger index = MRBrewFormulaStatusIndex(isNew, isUpdated, isInstalled);
+    
+    @synchronized(table) {
+        MRBrewFormulaInternEntry *entry = [self internEntryForName:name inTable:table];
+        
+        if (!entry->_formulae[index]) {
+            entry->_formulae[index] = [[MRBrewFormula alloc] initWithEntry:entry
+                                                                     isNew:isNew
+                                                                 isUpdated:isUpdated
+                                                               isInstalled:isInstalled];
+        }
+        
+        return entry->_formulae[index];
+    }
+}
+
 #pragma mark - Lifecycle
 
 - (instancetype)init {
@@ -45,9 +150,26 @@
 }
 
 - (instancetype)initWithName:(NSString *)name isNew:(BOOL)isNew isUpdated:(BOOL)isUpdated isInstalled:(BOOL)isInstalled
+{
+    // formulae without a name are being built by a parser and aren't interned
+    if (name && [self isMemberOfClass:[MRBrewFormula class]]) {
+        return [MRBrewFormula internedFormulaWithName:name
+                                                isNew:isNew
+                                            isUpdated:isUpdated
+                                          isInstalled:isInstalled];
+    }
+    
+    return [self initWithEntry:(name ? [MRBrewFormula internEntryForName:name] : nil)
+                         isNew:isNew
+                     isUpdated:isUpdated
+                   isInstalled:isInstalled];
+}
+
+- (instancetype)initWithEntry:(MRBrewFormulaInternEntry *)entry isNew:(BOOL)isNew isUpdated:(BOOL)isUpdated isInstalled:(BOOL)isInstalled
 {
     if (self = [super init]) {
-        _name = [name copy];
+        _name = entry ? entry->_name : nil;
+        _hash = entry ? entry->_hash : 0;
         _isUpdated = isUpdated;
         _isNew = isNew;
         _isInstalled = isInstalled;
@@ -72,6 +194,15 @@
                           isInstalled:isInstalled];
 }
 
+#pragma mark - Building (private)
+
+- (void)setName:(NSString *)name
+{
+    MRBrewFormulaInternEntry *entry = name ? [MRBrewFormula internEntryForName:name] : nil;
+    _name = entry ? entry->_name : nil;
+    _hash = entry ? entry->_hash : 0;
+}
+
 #pragma mark - Equality
 
 - (BOOL)isEqualToFormula:(MRBrewFormula *)formula
@@ -79,10 +210,11 @@
     if (self == formula)
         return YES;
     
-    if (!formula || ![formula isKindOfClass:[self class]])
+    if (!formula || ![formula isKindOfClass:[MRBrewFormula class]])
         return NO;
     
-    if (![[self name] isEqualToString:[formula name]])
+    // names are interned, so formulae with different names never share one
+    if ([self name] != [formula name])
         return NO;
     if ([self isUpdated] != [formula isUpdated])
         return NO;
@@ -90,21 +222,46 @@
         return NO;
     if ([self isInstalled] != [formula isInstalled])
         return NO;
+    if ([self isPinned] != [formula isPinned])
+        return NO;
+    if ([self isOutdated] != [formula isOutdated])
+        return NO;
+    if (!MRBrewObjectsEqual([self stableVersion], [formula stableVersion]))
+        return NO;
+    if (!MRBrewObjectsEqual([self develVersion], [formula develVersion]))
+        return NO;
+    if (!MRBrewObjectsEqual([self headVersion], [formula headVersion]))
+        return NO;
+    if (!MRBrewObjectsEqual([self installedVersions], [formula installedVersions]))
+        return NO;
+    if (!MRBrewObjectsEqual([self availableVersion], [formula availableVersion]))
+        return NO;
+    if (!MRBrewObjectsEqual([self linkedVersion], [formula linkedVersion]))
+        return NO;
+    if (!MRBrewObjectsEqual([self dependencies], [formula dependencies]))
+        return NO;
+    if (!MRBrewObjectsEqual([self options], [formula options]))
+        return NO;
     
     return YES;
 }
 
+- (BOOL)isEqual:(id)object
+{
+    return [self isEqualToFormula:object];
+}
+
+- (NSUInteger)hash
+{
+    return _hash;
+}
+
 #pragma mark - NSCopying protocol
 
 - (id)copyWithZone:(NSZone *)zone
 {
-    MRBrewFormula *copy = [[[self class] allocWithZone:zone] init];
-    [copy setName:[[self name] copy]];
-    [copy setIsUpdated:[self isUpdated]];
-    [copy setIsNew:[self isNew]];
-    [copy setIsInstalled:[self isInstalled]];
-    
-    return copy;
+    // formulae are immutable
+    return self;
 }
 
 @end
@@ -0,0 +1,60 @@
+//
+//  MRBrewFormulaInfoReader.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/** An `MRBrewFormulaInfoReader` object builds `MRBrewFormula` objects from the
+ * JSON output of an info operation created with `MRBrewOperation`'s
+ * infoOperationForFormulae: or installedInfoOperation methods.
+ *
+ * Output can be read in chunks as it is generated, and each formula is built in
+ * a single pass over the JSON. Members of the output that `MRBrewFormula` does
+ * not represent are skipped without being decoded.
+ */
+@interface MRBrewFormulaInfoReader : NSObject
+
+/** Returns an array of formulae read from the specified output.
+ *
+ * @param data The complete output of a JSON info operation.
+ * @return An array of `MRBrewFormula` objects, or `nil` if the output is
+ * malformed.
+ */
++ (NSArray *)formulaeFromData:(NSData *)data;
+
+/** Reads the next chunk of output.
+ *
+ * @param data The output following that passed to the previous call.
+ * @return `NO` if the output is malformed, otherwise `YES`.
+ */
+- (BOOL)readData:(NSData *)data;
+
+/** Indicates that all of the output has been read.
+ *
+ * @return An array of `MRBrewFormula` objects, or `nil` if the output is
+ * malformed or incomplete.
+ */
+- (NSArray *)finishReading;
+
+@end
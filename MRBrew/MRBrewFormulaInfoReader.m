@@ -0,0 +1,266 @@
+//
+//  MRBrewFormulaInfoReader.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewFormulaInfoReader.h"
+#import "MRBrewJSONParser.h"
+#import "MRBrewFormula.h"
+#import "MRBrewFormula+Private.h"
+#import "MRBrewInstallOption.h"
+
+/* The members of a formula's JSON object that are read. */
+typedef NS_ENUM(NSInteger, MRBrewFormulaInfoMember) {
+    MRBrewFormulaInfoMemberNone,
+    MRBrewFormulaInfoMemberName,
+    MRBrewFormulaInfoMemberVersions,
+    MRBrewFormulaInfoMemberInstalled,
+    MRBrewFormulaInfoMemberLinkedKeg,
+    MRBrewFormulaInfoMemberPinned,
+    MRBrewFormulaInfoMemberOutdated,
+    MRBrewFormulaInfoMemberDependencies,
+    MRBrewFormulaInfoMemberOptions
+};
+
+/* Nesting depths of the JSON elements that are read: the top level array of
+ * formulae, each formula object, the value of one of its members, and the
+ * objects inside the installed and options arrays.
+ */
+enum {
+    MRBrewFormulaInfoDepthFormula = 2,
+    MRBrewFormulaInfoDepthMember = 3,
+    MRBrewFormulaInfoDepthMemberElement = 4
+};
+
+@interface MRBrewFormulaInfoReader () <MRBrewJSONParserDelegate>
+{
+    @private
+    MRBrewJSONParser *_parser;
+    NSMutableArray *_formulae;
+    NSUInteger _depth;
+    MRBrewFormulaInfoMember _member;
+    NSString *_memberKey;
+    MRBrewFormula *_formula;
+    NSMutableArray *_installedVersions;
+    NSMutableArray *_dependencies;
+    NSMutableArray *_options;
+    NSString *_optionName;
+    NSString *_optionDescription;
+}
+
+@end
+
+@implementation MRBrewFormulaInfoReader
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        _parser = [[MRBrewJSONParser alloc] initWithDelegate:self];
+        _formulae = [NSMutableArray array];
+    }
+
+    return self;
+}
+
++ (NSArray *)formulaeFromData:(NSData *)data
+{
+    MRBrewFormulaInfoReader *reader = [[self alloc] init];
+    if (![reader readData:data]) {
+        return nil;
+    }
+
+    return [reader finishReading];
+}
+
+#pragma mark - Reading
+
+- (BOOL)readData:(NSData *)data
+{
+    return [_parser parseData:data];
+}
+
+- (NSArray *)finishReading
+{
+    if (![_parser finish]) {
+        return nil;
+    }
+
+    return [NSArray arrayWithArray:_formulae];
+}
+
++ (MRBrewFormulaInfoMember)memberForKey:(NSString *)key
+{
+    static NSDictionary *members = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        members = @{@"name": @(MRBrewFormulaInfoMemberName),
+                    @"versions": @(MRBrewFormulaInfoMemberVersions),
+                    @"installed": @(MRBrewFormulaInfoMemberInstalled),
+                    @"linked_keg": @(MRBrewFormulaInfoMemberLinkedKeg),
+                    @"pinned": @(MRBrewFormulaInfoMemberPinned),
+                    @"outdated": @(MRBrewFormulaInfoMemberOutdated),
+                    @"dependencies": @(MRBrewFormulaInfoMemberDependencies),
+                    @"options": @(MRBrewFormulaInfoMemberOptions)};
+    });
+
+    return [[members objectForKey:key] integerValue];
+}
+
+#pragma mark - MRBrewJSONParserDelegate protocol
+
+- (void)parserDidStartObject:(MRBrewJSONParser *)parser
+{
+    _depth++;
+
+    if (_depth == MRBrewFormulaInfoDepthFormula) {
+        _formula = [[MRBrewFormula alloc] init];
+        _member = MRBrewFormulaInfoMemberNone;
+        _installedVersions = [NSMutableArray array];
+        _dependencies = [NSMutableArray array];
+        _options = [NSMutableArray array];
+    }
+    else if (_depth == MRBrewFormulaInfoDepthMemberElement && _member == MRBrewFormulaInfoMemberOptions) {
+        _optionName = nil;
+        _optionDescription = nil;
+    }
+}
+
+- (void)parserDidEndObject:(MRBrewJSONParser *)parser
+{
+    if (_depth == MRBrewFormulaInfoDepthFormula && _formula) {
+        [_formula setInstalledVersions:_installedVersions];
+        [_formula setIsInstalled:[_installedVersions count] > 0];
+        [_formula setDependencies:_dependencies];
+        [_formula setOptions:_options];
+        [_formulae addObject:_formula];
+        _formula = nil;
+    }
+    else if (_depth == MRBrewFormulaInfoDepthMemberElement && _member == MRBrewFormulaInfoMemberOptions && _optionName) {
+        [_options addObject:[MRBrewInstallOption installOptionWithName:_optionName description:_optionDescription selected:NO]];
+    }
+
+    _depth--;
+}
+
+- (void)parserDidStartArray:(MRBrewJSONParser *)parser
+{
+    _depth++;
+}
+
+- (void)parserDidEndArray:(MRBrewJSONParser *)parser
+{
+    _depth--;
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundKey:(NSString *)key
+{
+    BOOL wanted = NO;
+
+    if (_depth == MRBrewFormulaInfoDepthFormula) {
+        _member = [[self class] memberForKey:key];
+        wanted = (_member != MRBrewFormulaInfoMemberNone);
+    }
+    else if (_depth == MRBrewFormulaInfoDepthMember && _member == MRBrewFormulaInfoMemberVersions) {
+        _memberKey = key;
+        wanted = [key isEqualToString:@"stable"] || [key isEqualToString:@"devel"] || [key isEqualToString:@"head"];
+    }
+    else if (_depth == MRBrewFormulaInfoDepthMemberElement && _member == MRBrewFormulaInfoMemberInstalled) {
+        _memberKey = key;
+        wanted = [key isEqualToString:@"version"];
+    }
+    else if (_depth == MRBrewFormulaInfoDepthMemberElement && _member == MRBrewFormulaInfoMemberOptions) {
+        _memberKey = key;
+        wanted = [key isEqualToString:@"option"] || [key isEqualToString:@"description"];
+    }
+
+    if (!wanted) {
+        [parser skipNextValue];
+    }
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundString:(NSString *)string
+{
+    if (_depth == MRBrewFormulaInfoDepthFormula) {
+        if (_member == MRBrewFormulaInfoMemberName) {
+            [_formula setName:string];
+        }
+        else if (_member == MRBrewFormulaInfoMemberLinkedKeg) {
+            [_formula setLinkedVersion:string];
+        }
+    }
+    else if (_depth == MRBrewFormulaInfoDepthMember) {
+        if (_member == MRBrewFormulaInfoMemberDependencies) {
+            [_dependencies addObject:string];
+        }
+        else if (_member == MRBrewFormulaInfoMemberVersions) {
+            if ([_memberKey isEqualToString:@"stable"]) {
+                [_formula setStableVersion:string];
+            }
+            else if ([_memberKey isEqualToString:@"devel"]) {
+                [_formula setDevelVersion:string];
+            }
+            else if ([_memberKey isEqualToString:@"head"]) {
+                [_formula setHeadVersion:string];
+            }
+        }
+    }
+    else if (_depth == MRBrewFormulaInfoDepthMemberElement) {
+        if (_member == MRBrewFormulaInfoMemberInstalled) {
+            [_installedVersions addObject:string];
+        }
+        else if (_member == MRBrewFormulaInfoMemberOptions) {
+            if ([_memberKey isEqualToString:@"option"]) {
+                _optionName = string;
+            }
+            else {
+                _optionDescription = string;
+            }
+        }
+    }
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundBool:(BOOL)value
+{
+    if (_depth != MRBrewFormulaInfoDepthFormula) {
+        return;
+    }
+
+    if (_member == MRBrewFormulaInfoMemberPinned) {
+        [_formula setIsPinned:value];
+    }
+    else if (_member == MRBrewFormulaInfoMemberOutdated) {
+        [_formula setIsOutdated:value];
+    }
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundNumber:(NSNumber *)number
+{
+}
+
+- (void)parserFoundNull:(MRBrewJSONParser *)parser
+{
+}
+
+@end
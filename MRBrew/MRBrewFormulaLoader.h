@@ -0,0 +1,86 @@
+//
+//  MRBrewFormulaLoader.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+@class MRBrew;
+@class MRBrewFormula;
+
+/** The block type used to deliver the result of a formula lookup.
+ *
+ * @param formula A formula with its versions, installed kegs, dependencies and
+ * options populated, or `nil` if the lookup failed.
+ * @param error An error object describing the failure, or `nil`.
+ */
+typedef void (^MRBrewFormulaLoaderHandler)(MRBrewFormula *formula, NSError *error);
+
+/** An `MRBrewFormulaLoader` object batches lookups of individual formulae into
+ * a single brew invocation.
+ *
+ * Requests made within the batch interval are collected, duplicate names are
+ * merged, and one JSON info operation (see `MRBrewOperation`'s
+ * infoOperationForFormulae:) is performed for the whole batch. The result for
+ * each formula is then delivered to every requester of that formula. Populating
+ * a table of 200 formulae therefore costs one process rather than 200.
+ *
+ * If a batch fails because one of the names is not a known formula, it is split
+ * in half and each half is retried, so that a single bad name only fails its
+ * own requests. Any other failure is delivered to every request in the batch.
+ * If the brew object has been deallocated, requests fail with an
+ * `MRBrewErrorOperationCancelled` error.
+ *
+ * Use the `formulaLoader` property of an `MRBrew` object rather than creating
+ * a loader directly.
+ */
+@interface MRBrewFormulaLoader : NSObject
+
+/** The interval, in seconds, for which requests are collected before a batch
+ * is performed. The default interval is 0.05 seconds.
+ */
+@property (assign) NSTimeInterval batchInterval;
+
+/** The maximum number of formulae described by a single brew invocation. Larger
+ * batches are divided between several invocations. The default is 500.
+ */
+@property (assign) NSUInteger maximumBatchSize;
+
+/** Returns an initialized `MRBrewFormulaLoader` object that performs its
+ * operations with the specified brew object.
+ *
+ * @param brew The brew object used to perform operations.
+ * @return A loader for the specified brew object.
+ */
+- (instancetype)initWithBrew:(MRBrew *)brew;
+
+/** Requests the details of a formula.
+ *
+ * @param formula The formula to look up. Only its name is used.
+ * @param queue The queue on which _handler_ is executed, or `nil` to execute
+ * it inline on the thread that reads Homebrew's output.
+ * @param handler The block to execute with the result of the lookup.
+ */
+- (void)loadFormula:(MRBrewFormula *)formula queue:(NSOperationQueue *)queue handler:(MRBrewFormulaLoaderHandler)handler;
+
+@end
@@ -0,0 +1,254 @@
+//
+//  MRBrewFormulaLoader.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewFormulaLoader.h"
+#import "MRBrew.h"
+#import "MRBrewFormula.h"
+#import "MRBrewFormulaInfoReader.h"
+#import "MRBrewOutputParser.h"
+#import "MRBrewConstants.h"
+
+static const NSTimeInterval MRBrewFormulaLoaderDefaultBatchInterval = 0.05;
+static const NSUInteger MRBrewFormulaLoaderDefaultMaximumBatchSize = 500;
+
+/* Homebrew's error when one of the names it is given is not a known formula.
+ * Only this failure is specific to some of the names in a batch.
+ */
+static NSString * const MRBrewFormulaLoaderUnknownFormulaError = @"No available formula";
+
+/* A handler waiting for the result of a lookup, and the queue to call it on. */
+@interface MRBrewFormulaLoaderRequest : NSObject
+
+@property (copy) MRBrewFormulaLoaderHandler handler;
+@property (strong) NSOperationQueue *queue;
+
+@end
+
+@implementation MRBrewFormulaLoaderRequest
+
+@end
+
+@interface MRBrewFormulaLoader ()
+{
+    @private
+    __weak MRBrew *_brew;
+    NSMutableArray *_pendingNames;
+    NSMutableDictionary *_pendingRequests;
+}
+
+@end
+
+@implementation MRBrewFormulaLoader
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    return [self initWithBrew:nil];
+}
+
+- (instancetype)initWithBrew:(MRBrew *)brew
+{
+    if (self = [super init]) {
+        _brew = brew;
+        _batchInterval = MRBrewFormulaLoaderDefaultBatchInterval;
+        _maximumBatchSize = MRBrewFormulaLoaderDefaultMaximumBatchSize;
+        _pendingNames = [NSMutableArray array];
+        _pendingRequests = [NSMutableDictionary dictionary];
+    }
+    
+    return self;
+}
+
+#pragma mark - Loading
+
+- (void)loadFormula:(MRBrewFormula *)formula queue:(NSOperationQueue *)queue handler:(MRBrewFormulaLoaderHandler)handler
+{
+    NSParameterAssert([formula name]);
+    
+    MRBrewFormulaLoaderRequest *request = [[MRBrewFormulaLoaderRequest alloc] init];
+    [request setHandler:handler];
+    [request setQueue:queue];
+    
+    BOOL startsBatch = NO;
+    
+    @synchronized(self) {
+        startsBatch = ([_pendingNames count] == 0);
+        
+        NSMutableArray *requests = [_pendingRequests objectForKey:[formula name]];
+        if (!requests) {
+            requests = [NSMutableArray array];
+            [_pendingRequests setObject:requests forKey:[formula name]];
+            [_pendingNames addObject:[formula name]];
+        }
+        [requests addObject:request];
+    }
+    
+    // the first request of a batch schedules it, later requests join it
+    if (startsBatch) {
+        __weak MRBrewFormulaLoader *weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)([self batchInterval] * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [weakSelf performPendingBatch];
+        });
+    }
+}
+
+- (void)performPendingBatch
+{
+    NSArray *names;
+    NSDictionary *requests;
+    
+    @synchronized(self) {
+        names = [_pendingNames copy];
+        requests = [_pendingRequests copy];
+        [_pendingNames removeAllObjects];
+        [_pendingRequests removeAllObjects];
+    }
+    
+    NSUInteger batchSize = MAX([self maximumBatchSize], (NSUInteger)1);
+    for (NSUInteger location = 0; location < [names count]; location += batchSize) {
+        NSRange range = NSMakeRange(location, MIN(batchSize, [names count] - location));
+        [self performBatchWithNames:[names subarrayWithRange:range] requests:requests];
+    }
+}
+
+- (void)performBatchWithNames:(NSArray *)names requests:(NSDictionary *)requests
+{
+    NSMutableArray *formulae = [NSMutableArray arrayWithCapacity:[names count]];
+    for (NSString *name in names) {
+        [formulae addObject:[MRBrewFormula formulaWithName:name]];
+    }
+    
+    MRBrew *brew = _brew;
+    if (!brew) {
+        NSError *error = [NSError errorWithDomain:MRBrewErrorDomain
+                                             code:MRBrewErrorOperationCancelled
+                                         userInfo:@{NSLocalizedDescriptionKey: @"The brew object that performs lookups no longer exists."}];
+        for (NSString *name in names) {
+            [self deliverFormula:nil error:error toRequests:[requests objectForKey:name]];
+        }
+        return;
+    }
+    
+    // output bytes are parsed as they arrive rather than decoded and accumulated
+    MRBrewFormulaInfoReader *reader = [[MRBrewFormulaInfoReader alloc] init];
+    __block BOOL readFailed = NO;
+    NSMutableData *errorOutput = [NSMutableData data];
+    __weak MRBrewFormulaLoader *weakSelf = self;
+    
+    [brew performOperation:[MRBrewOperation infoOperationForFormulae:formulae] queue:nil data:^(MRBrewOperation *operation, NSData *data) {
+        @synchronized(reader) {
+            if (!readFailed) {
+                readFailed = ![reader readData:data];
+            }
+        }
+    } errorData:^(MRBrewOperation *operation, NSData *data) {
+        @synchronized(errorOutput) {
+            [errorOutput appendData:data];
+        }
+    } completion:^(MRBrewOperation *operation) {
+        NSArray *loadedFormulae;
+        @synchronized(reader) {
+            loadedFormulae = readFailed ? nil : [reader finishReading];
+        }
+        [weakSelf deliverFormulae:loadedFormulae forNames:names requests:requests];
+    } failure:^(MRBrewOperation *operation, NSError *error) {
+        NSString *errorString;
+        @synchronized(errorOutput) {
+            errorString = [[NSString alloc] initWithData:errorOutput encoding:NSUTF8StringEncoding];
+        }
+        [weakSelf handleFailure:error errorOutput:errorString forNames:names requests:requests];
+    }];
+}
+
+/* Splits a batch that failed because it named an unknown formula in half and
+ * retries each half, until the unknown names are isolated. Any other failure
+ * (e.g. lock contention or a network error) would fail every half alike, so
+ * is delivered to all of the batch's requests.
+ */
+- (void)handleFailure:(NSError *)error errorOutput:(NSString *)errorOutput forNames:(NSArray *)names requests:(NSDictionary *)requests
+{
+    if ([names count] > 1 && errorOutput && [errorOutput rangeOfString:MRBrewFormulaLoaderUnknownFormulaError].location != NSNotFound) {
+        NSUInteger half = [names count] / 2;
+        [self performBatchWithNames:[names subarrayWithRange:NSMakeRange(0, half)] requests:requests];
+        [self performBatchWithNames:[names subarrayWithRange:NSMakeRange(half, [names count] - half)] requests:requests];
+        return;
+    }
+    
+    for (NSString *name in names) {
+        [self deliverFormula:nil error:error toRequests:[requests objectForKey:name]];
+    }
+}
+
+- (void)deliverFormulae:(NSArray *)formulae forNames:(NSArray *)names requests:(NSDictionary *)requests
+{
+    NSDictionary *formulaeByName = nil;
+    
+    // brew describes formulae in the order they were named, but reports the
+    // canonical name for an alias, so match by position where possible
+    if ([formulae count] != [names count]) {
+        NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithCapacity:[formulae count]];
+        for (MRBrewFormula *formula in formulae) {
+            if ([formula name]) {
+                [dictionary setObject:formula forKey:[formula name]];
+            }
+        }
+        formulaeByName = dictionary;
+    }
+    
+    [names enumerateObjectsUsingBlock:^(NSString *name, NSUInteger index, BOOL *stop) {
+        MRBrewFormula *formula = formulaeByName ? [formulaeByName objectForKey:name] : [formulae objectAtIndex:index];
+        NSError *error = nil;
+        
+        if (!formula) {
+            error = [NSError errorWithDomain:MRBrewOutputParserErrorDomain
+                                        code:MRBrewOutputParserErrorSyntax
+                                    userInfo:@{NSLocalizedDescriptionKey: @"Output string did not describe the requested formula."}];
+        }
+        
+        [self deliverFormula:formula error:error toRequests:[requests objectForKey:name]];
+    }];
+}
+
+- (void)deliverFormula:(MRBrewFormula *)formula error:(NSError *)error toRequests:(NSArray *)requests
+{
+    for (MRBrewFormulaLoaderRequest *request in requests) {
+        MRBrewFormulaLoaderHandler handler = [request handler];
+        if (!handler) {
+            continue;
+        }
+        
+        if ([request queue]) {
+            [[request queue] addOperationWithBlock:^{
+                handler(formula, error);
+            }];
+        }
+        else {
+            handler(formula, error);
+        }
+    }
+}
+
+@end
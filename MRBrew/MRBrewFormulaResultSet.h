@@ -0,0 +1,134 @@
+//
+//  MRBrewFormulaResultSet.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/** These constants describe the status of a formula in an
+ * `MRBrewFormulaResultSet`, and correspond to `MRBrewFormula`'s isNew,
+ * isUpdated and isInstalled properties.
+ */
+typedef NS_OPTIONS(NSUInteger, MRBrewFormulaStatus) {
+    /** The formula is new. */
+    MRBrewFormulaStatusNew = 1 << 0,
+    /** The formula has been updated. */
+    MRBrewFormulaStatusUpdated = 1 << 1,
+    /** The formula is installed. */
+    MRBrewFormulaStatusInstalled = 1 << 2
+};
+
+/** An `MRBrewFormulaResultSet` object is an immutable array of formulae stored
+ * in columns rather than as individual objects.
+ *
+ * The names of the formulae are stored end to end in a single buffer, and each
+ * status flag is stored in its own bitset, so a result set describing the
+ * whole Homebrew catalog occupies a few kilobytes per thousand formulae, plus a
+ * pointer per formula. An `MRBrewFormula` object is only looked up when an
+ * element of the array is first accessed, and is the interned formula for that
+ * name and status; later accesses return it from the pointer column.
+ *
+ * Result sets can be filtered and compared using the columns directly, without
+ * creating any formula objects. `MRBrewOutputParser` returns result sets for
+ * list and search operations.
+ */
+@interface MRBrewFormulaResultSet : NSArray
+
+/**-----------------------------------------------------------------------------
+ * @name Creating a Result Set
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns a result set containing a formula for each non-empty line of the
+ * specified output.
+ *
+ * @param output A string containing one formula name per line.
+ * @param status The status of each formula.
+ * @return A result set of formulae with the specified status.
+ */
++ (instancetype)resultSetWithLines:(NSString *)output status:(MRBrewFormulaStatus)status;
+
+/** Returns a result set containing the specified formulae.
+ *
+ * Only the name and the isNew, isUpdated and isInstalled properties of each
+ * formula are stored.
+ *
+ * @param formulae An array of `MRBrewFormula` objects.
+ * @return A result set of the specified formulae.
+ */
++ (instancetype)resultSetWithFormulae:(NSArray *)formulae;
+
+/**-----------------------------------------------------------------------------
+ * @name Querying a Result Set
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns the name of the formula at the specified index without creating a
+ * formula object.
+ *
+ * @param index An index within the bounds of the result set.
+ * @return The name of the formula.
+ */
+- (NSString *)nameAtIndex:(NSUInteger)index;
+
+/** Returns the status of the formula at the specified index without creating a
+ * formula object.
+ *
+ * @param index An index within the bounds of the result set.
+ * @return The status of the formula.
+ */
+- (MRBrewFormulaStatus)statusAtIndex:(NSUInteger)index;
+
+/**-----------------------------------------------------------------------------
+ * @name Filtering and Comparing Result Sets
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns a result set containing the formulae of the receiver that have all
+ * of the specified status flags.
+ *
+ * @param status The status flags to filter by.
+ * @return A new result set.
+ */
+- (MRBrewFormulaResultSet *)resultSetWithStatus:(MRBrewFormulaStatus)status;
+
+/** Returns a result set containing the formulae of the receiver whose names
+ * contain the specified string. The comparison is case sensitive.
+ *
+ * @param string The string to search for.
+ * @return A new result set.
+ */
+- (MRBrewFormulaResultSet *)resultSetMatchingString:(NSString *)string;
+
+/** Returns a result set containing the formulae of the receiver whose names do
+ * not appear in the specified result set.
+ *
+ * Comparing two snapshots of the same catalog in both directions yields the
+ * formulae added and removed between them.
+ *
+ * @param resultSet The result set whose formulae to exclude.
+ * @return A new result set.
+ */
+- (MRBrewFormulaResultSet *)resultSetByRemovingFormulaeInResultSet:(MRBrewFormulaResultSet *)resultSet;
+
+@end
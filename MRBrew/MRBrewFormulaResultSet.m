@@ -0,0 +1,371 @@
+//
+//  MRBrewFormulaResultSet.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewFormulaResultSet.h"
+#import "MRBrewFormulaResultSet+Private.h"
+#import "MRBrewFormula.h"
+
+/* The number of status flags, each of which is stored in its own bitset. */
+enum {
+    MRBrewFormulaResultSetStatusColumnCount = 3
+};
+
+static inline BOOL MRBrewBitIsSet(NSData *bits, NSUInteger index)
+{
+    const uint8_t *bytes = [bits bytes];
+    return (bytes[index >> 3] >> (index & 7)) & 1;
+}
+
+static inline void MRBrewSetBit(NSMutableData *bits, NSUInteger index)
+{
+    uint8_t *bytes = [bits mutableBytes];
+    bytes[index >> 3] |= (uint8_t)(1 << (index & 7));
+}
+
+/* FNV-1a hash of a name stored in the arena. */
+static inline NSUInteger MRBrewHashBytes(const char *bytes, NSUInteger length)
+{
+    uint32_t hash = 2166136261u;
+    for (NSUInteger i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)bytes[i]) * 16777619u;
+    }
+    
+    return hash;
+}
+
+static BOOL MRBrewBytesContainBytes(const char *bytes, NSUInteger length, const char *search, NSUInteger searchLength)
+{
+    if (searchLength == 0) {
+        return YES;
+    }
+    
+    for (NSUInteger i = 0; i + searchLength <= length; i++) {
+        if (bytes[i] == search[0] && memcmp(bytes + i, search, searchLength) == 0) {
+            return YES;
+        }
+    }
+    
+    return NO;
+}
+
+@interface MRBrewFormulaResultSet ()
+{
+    @private
+    NSUInteger _count;
+    NSMutableData *_names;
+    NSMutableData *_offsets;
+    NSMutableData *_statusBits[MRBrewFormulaResultSetStatusColumnCount];
+    NSMutableData *_formulae;
+}
+
+@end
+
+@implementation MRBrewFormulaResultSet
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        uint32_t offset = 0;
+        _names = [NSMutableData data];
+        _offsets = [NSMutableData dataWithBytes:&offset length:sizeof(offset)];
+        _formulae = [NSMutableData data];
+        
+        for (NSUInteger column = 0; column < MRBrewFormulaResultSetStatusColumnCount; column++) {
+            _statusBits[column] = [NSMutableData data];
+        }
+    }
+    
+    return self;
+}
+
++ (instancetype)resultSetWithLines:(NSString *)output status:(MRBrewFormulaStatus)status
+{
+    const char *bytes = [output UTF8String];
+    
+    return [self resultSetWithLineBytes:bytes length:(bytes ? strlen(bytes) : 0) status:status];
+}
+
++ (instancetype)resultSetWithLineBytes:(const char *)bytes length:(NSUInteger)length status:(MRBrewFormulaStatus)status
+{
+    MRBrewFormulaResultSet *resultSet = [[self alloc] init];
+    NSUInteger lineStart = 0;
+    
+    for (NSUInteger i = 0; i <= length; i++) {
+        if (i == length || bytes[i] == '\n') {
+            if (i > lineStart) {
+                [resultSet appendNameBytes:bytes + lineStart length:i - lineStart status:status];
+            }
+            lineStart = i + 1;
+        }
+    }
+    
+    return resultSet;
+}
+
++ (instancetype)resultSetByJoiningResultSets:(NSArray *)resultSets
+{
+    MRBrewFormulaResultSet *resultSet = [[self alloc] init];
+    
+    for (MRBrewFormulaResultSet *part in resultSets) {
+        // names are copied wholesale and each offset rebased onto the arena
+        uint32_t base = (uint32_t)[resultSet->_names length];
+        const uint32_t *offsets = [part->_offsets bytes];
+        [resultSet->_names appendData:part->_names];
+        
+        for (NSUInteger i = 1; i <= part->_count; i++) {
+            uint32_t offset = base + offsets[i];
+            [resultSet->_offsets appendBytes:&offset length:sizeof(offset)];
+        }
+        
+        NSUInteger index = resultSet->_count;
+        resultSet->_count += part->_count;
+        [resultSet->_formulae setLength:resultSet->_count * sizeof(void *)];
+        
+        for (NSUInteger column = 0; column < MRBrewFormulaResultSetStatusColumnCount; column++) {
+            [resultSet->_statusBits[column] setLength:(resultSet->_count + 7) / 8];
+            
+            for (NSUInteger i = 0; i < part->_count; i++) {
+                if (MRBrewBitIsSet(part->_statusBits[column], i)) {
+                    MRBrewSetBit(resultSet->_statusBits[column], index + i);
+                }
+            }
+        }
+    }
+    
+    return resultSet;
+}
+
++ (instancetype)resultSetWithFormulae:(NSArray *)formulae
+{
+    MRBrewFormulaResultSet *resultSet = [[self alloc] init];
+    
+    for (MRBrewFormula *formula in formulae) {
+        [resultSet appendFormula:formula];
+    }
+    
+    return resultSet;
+}
+
+#pragma mark - Building (private)
+
+- (void)appendNameBytes:(const char *)bytes length:(NSUInteger)length status:(MRBrewFormulaStatus)status
+{
+    [_names appendBytes:bytes length:length];
+    
+    uint32_t offset = (uint32_t)[_names length];
+    [_offsets appendBytes:&offset length:sizeof(offset)];
+    
+    NSUInteger index = _count++;
+    [_formulae setLength:_count * sizeof(void *)];
+    
+    for (NSUInteger column = 0; column < MRBrewFormulaResultSetStatusColumnCount; column++) {
+        [_statusBits[column] setLength:(_count + 7) / 8];
+        
+        if (status & (1 << column)) {
+            MRBrewSetBit(_statusBits[column], index);
+        }
+    }
+}
+
+- (void)appendFormula:(MRBrewFormula *)formula
+{
+    NSString *name = [formula name] ? [formula name] : @"";
+    MRBrewFormulaStatus status = ([formula isNew] ? MRBrewFormulaStatusNew : 0) |
+                                 ([formula isUpdated] ? MRBrewFormulaStatusUpdated : 0) |
+                                 ([formula isInstalled] ? MRBrewFormulaStatusInstalled : 0);
+    
+    [self appendNameBytes:[name UTF8String] length:[name lengthOfBytesUsingEncoding:NSUTF8StringEncoding] status:status];
+}
+
+- (void)appendEntryAtIndex:(NSUInteger)index ofResultSet:(MRBrewFormulaResultSet *)resultSet
+{
+    NSUInteger length;
+    const char *bytes = [resultSet nameBytesAtIndex:index length:&length];
+    
+    [self appendNameBytes:bytes length:length status:[resultSet statusAtIndex:index]];
+}
+
+- (const char *)nameBytesAtIndex:(NSUInteger)index length:(NSUInteger *)length
+{
+    const uint32_t *offsets = [_offsets bytes];
+    *length = offsets[index + 1] - offsets[index];
+    
+    return (const char *)[_names bytes] + offsets[index];
+}
+
+#pragma mark - NSArray primitive methods
+
+- (NSUInteger)count
+{
+    return _count;
+}
+
+/* The returned formula is interned and so outlives the result set, which lets
+ * NSArray's fast enumeration hand out unretained references safely. For the
+ * same reason each formula is kept unretained, one pointer per name, so that
+ * only the first access to an index creates a name and takes the intern lock.
+ * Threads that race on an index store the same interned formula.
+ */
+- (id)objectAtIndex:(NSUInteger)index
+{
+    if (index >= _count) {
+        [NSException raise:NSRangeException format:@"Index %lu beyond bounds [0 .. %lu]", (unsigned long)index, (unsigned long)_count];
+    }
+    
+    __unsafe_unretained MRBrewFormula **formulae = (__unsafe_unretained MRBrewFormula **)[_formulae mutableBytes];
+    if (formulae[index]) {
+        return formulae[index];
+    }
+    
+    MRBrewFormulaStatus status = [self statusAtIndex:index];
+    MRBrewFormula *formula = [MRBrewFormula formulaWithName:[self nameAtIndex:index]
+                                                      isNew:(status & MRBrewFormulaStatusNew) != 0
+                                                  isUpdated:(status & MRBrewFormulaStatusUpdated) != 0
+                                                isInstalled:(status & MRBrewFormulaStatusInstalled) != 0];
+    formulae[index] = formula;
+    
+    return formula;
+}
+
+#pragma mark - Querying
+
+- (NSString *)nameAtIndex:(NSUInteger)index
+{
+    NSUInteger length;
+    const char *bytes = [self nameBytesAtIndex:index length:&length];
+    
+    return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+}
+
+- (MRBrewFormulaStatus)statusAtIndex:(NSUInteger)index
+{
+    MRBrewFormulaStatus status = 0;
+    
+    for (NSUInteger column = 0; column < MRBrewFormulaResultSetStatusColumnCount; column++) {
+        if (MRBrewBitIsSet(_statusBits[column], index)) {
+            status |= (1 << column);
+        }
+    }
+    
+    return status;
+}
+
+#pragma mark - Filtering and Comparing
+
+- (MRBrewFormulaResultSet *)resultSetWithStatus:(MRBrewFormulaStatus)status
+{
+    MRBrewFormulaResultSet *resultSet = [[MRBrewFormulaResultSet alloc] init];
+    
+    for (NSUInteger i = 0; i < _count; i++) {
+        if (([self statusAtIndex:i] & status) == status) {
+            [resultSet appendEntryAtIndex:i ofResultSet:self];
+        }
+    }
+    
+    return resultSet;
+}
+
+- (MRBrewFormulaResultSet *)resultSetMatchingString:(NSString *)string
+{
+    MRBrewFormulaResultSet *resultSet = [[MRBrewFormulaResultSet alloc] init];
+    const char *search = [string UTF8String];
+    NSUInteger searchLength = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    
+    for (NSUInteger i = 0; i < _count; i++) {
+        NSUInteger length;
+        const char *bytes = [self nameBytesAtIndex:i length:&length];
+        
+        if (MRBrewBytesContainBytes(bytes, length, search, searchLength)) {
+            [resultSet appendEntryAtIndex:i ofResultSet:self];
+        }
+    }
+    
+    return resultSet;
+}
+
+- (MRBrewFormulaResultSet *)resultSetByRemovingFormulaeInResultSet:(MRBrewFormulaResultSet *)other
+{
+    // index the other result set's names in an open addressing hash table
+    NSUInteger capacity = 16;
+    while (capacity < [other count] * 2) {
+        capacity <<= 1;
+    }
+    
+    NSUInteger *slots = calloc(capacity, sizeof(NSUInteger));
+    
+    for (NSUInteger i = 0; i < [other count]; i++) {
+        NSUInteger length;
+        const char *bytes = [other nameBytesAtIndex:i length:&length];
+        NSUInteger slot = MRBrewHashBytes(bytes, length) & (capacity - 1);
+        
+        while (slots[slot]) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        slots[slot] = i + 1;
+    }
+    
+    MRBrewFormulaResultSet *resultSet = [[MRBrewFormulaResultSet alloc] init];
+    
+    for (NSUInteger i = 0; i < _count; i++) {
+        NSUInteger length;
+        const char *bytes = [self nameBytesAtIndex:i length:&length];
+        NSUInteger slot = MRBrewHashBytes(bytes, length) & (capacity - 1);
+        BOOL found = NO;
+        
+        while (slots[slot] && !found) {
+            NSUInteger otherLength;
+            const char *otherBytes = [other nameBytesAtIndex:slots[slot] - 1 length:&otherLength];
+            found = (length == otherLength && memcmp(bytes, otherBytes, length) == 0);
+            slot = (slot + 1) & (capacity - 1);
+        }
+        
+        if (!found) {
+            [resultSet appendEntryAtIndex:i ofResultSet:self];
+        }
+    }
+    
+    free(slots);
+    
+    return resultSet;
+}
+
+#pragma mark - NSCopying protocol
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // result sets are immutable
+    return self;
+}
+
+#pragma mark - NSCoding protocol
+
+- (Class)classForCoder
+{
+    return [NSArray class];
+}
+
+@end
@@ -0,0 +1,161 @@
+//
+//  MRBrewFuture.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+@class MRBrewOperation;
+@class MRBrewFuture;
+
+/** These constants indicate the state of a future. */
+typedef NS_ENUM(NSInteger, MRBrewFutureState) {
+    /** The future has not yet been resolved. */
+    MRBrewFutureStatePending,
+    /** The future was resolved successfully. */
+    MRBrewFutureStateFulfilled,
+    /** The future was resolved with an error. */
+    MRBrewFutureStateRejected
+};
+
+/** The block type used to observe the resolution of a future.
+ *
+ * @param future The resolved future.
+ */
+typedef void (^MRBrewFutureHandler)(MRBrewFuture *future);
+
+/** The block type used to chain a dependent future.
+ *
+ * @param future The fulfilled future on which the chain depends.
+ * @return A future representing the dependent work, or `nil`.
+ */
+typedef MRBrewFuture * (^MRBrewFutureContinuation)(MRBrewFuture *future);
+
+/** An `MRBrewFuture` object represents the eventual result of an operation
+ performed using `MRBrew`'s futureForOperation: method.
+
+ A future starts out pending and is resolved exactly once, either _fulfilled_
+ with the operation's output (and any objects that `MRBrewOutputParser` was
+ able to parse from it), or _rejected_ with an error.
+
+ Futures can be composed without writing a delegate. The then: method submits
+ dependent work as soon as the receiver is fulfilled, while the all: and any:
+ class methods combine several futures into one. For example, the following
+ code performs an `update` operation followed immediately by an `outdated`
+ operation:
+
+     MRBrew *brew = [MRBrew sharedBrew];
+     MRBrewFuture *outdated = [[brew futureForOperation:[MRBrewOperation updateOperation]] then:^MRBrewFuture *(MRBrewFuture *update) {
+         return [brew futureForOperation:[MRBrewOperation outdatedOperation]];
+     }];
+
+ Continuations and combinators are executed inline on the thread that resolves
+ the future, so dependent operations are queued without waiting for the main
+ thread. Use whenResolved:queue: to observe the final result on a queue of your
+ choosing.
+ */
+@interface MRBrewFuture : NSObject
+
+/** The state of the future. */
+@property (readonly) MRBrewFutureState state;
+
+/** The operation whose result the future represents. For futures created by
+ * all:, this property is `nil`. For futures created by then: or any:, this is
+ * the operation of the future that resolved them.
+ */
+@property (readonly) MRBrewOperation *operation;
+
+/** The output string generated by the operation, or `nil` if the future is not
+ * fulfilled.
+ */
+@property (readonly, copy) NSString *output;
+
+/** The objects parsed from the operation's output using `MRBrewOutputParser`,
+ * or `nil` if the output could not be parsed. For futures created by all:,
+ * this is the array of fulfilled input futures.
+ */
+@property (readonly, copy) NSArray *objects;
+
+/** The error that caused the future to be rejected, or `nil`. */
+@property (readonly) NSError *error;
+
+/**-----------------------------------------------------------------------------
+ * @name Observing Resolution
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns a Boolean value indicating whether the future has been resolved.
+ *
+ * @return `YES` if the future has been fulfilled or rejected, otherwise `NO`.
+ */
+- (BOOL)isResolved;
+
+/** Registers a block to execute when the future is resolved.
+ *
+ * If the future has already been resolved, the block is scheduled immediately.
+ *
+ * @param handler The block to execute.
+ * @param queue The queue on which the block is executed, or `nil` to execute it
+ * inline on the thread that resolves the future.
+ */
+- (void)whenResolved:(MRBrewFutureHandler)handler queue:(NSOperationQueue *)queue;
+
+/**-----------------------------------------------------------------------------
+ * @name Composing Futures
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns a future for dependent work that starts when the receiver is
+ * fulfilled.
+ *
+ * The continuation block is executed as soon as the receiver is fulfilled and
+ * would typically perform another operation. The returned future is resolved
+ * with the result of the future returned by the block, or with the receiver's
+ * own result if the block returns `nil`. If the receiver is rejected, the block
+ * is not executed and the returned future is rejected with the same error.
+ *
+ * @param continuation The block to execute when the receiver is fulfilled.
+ * @return A future representing the result of the chain.
+ */
+- (MRBrewFuture *)then:(MRBrewFutureContinuation)continuation;
+
+/** Returns a future that is fulfilled when all of the specified futures have
+ * been fulfilled, or rejected as soon as any one of them is rejected.
+ *
+ * The `objects` property of the returned future contains the input futures, in
+ * the order specified.
+ *
+ * @param futures An array of `MRBrewFuture` objects.
+ * @return A combined future.
+ */
++ (MRBrewFuture *)all:(NSArray *)futures;
+
+/** Returns a future that is resolved with the result of the first of the
+ * specified futures to be fulfilled, or rejected if all of them are rejected.
+ *
+ * @param futures A non-empty array of `MRBrewFuture` objects.
+ * @return A combined future.
+ */
++ (MRBrewFuture *)any:(NSArray *)futures;
+
+@end
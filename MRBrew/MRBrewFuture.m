@@ -0,0 +1,239 @@
+//
+//  MRBrewFuture.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewFuture.h"
+#import "MRBrewFuture+Private.h"
+#import "MRBrewOperation.h"
+
+@interface MRBrewFuture ()
+{
+    @private
+    NSMutableArray *_handlers;
+}
+
+@end
+
+@implementation MRBrewFuture
+
+@synthesize state = _state;
+@synthesize operation = _operation;
+@synthesize output = _output;
+@synthesize objects = _objects;
+@synthesize error = _error;
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    return [self initWithOperation:nil];
+}
+
+- (instancetype)initWithOperation:(MRBrewOperation *)operation
+{
+    if (self = [super init]) {
+        _operation = operation;
+        _state = MRBrewFutureStatePending;
+        _handlers = [NSMutableArray array];
+    }
+
+    return self;
+}
+
+#pragma mark - Observing Resolution
+
+- (BOOL)isResolved
+{
+    return [self state] != MRBrewFutureStatePending;
+}
+
+- (void)whenResolved:(MRBrewFutureHandler)handler queue:(NSOperationQueue *)queue
+{
+    void (^callback)(void) = ^{
+        if (queue) {
+            [queue addOperationWithBlock:^{
+                handler(self);
+            }];
+        }
+        else {
+            handler(self);
+        }
+    };
+
+    @synchronized(self) {
+        if (_state == MRBrewFutureStatePending) {
+            [_handlers addObject:[callback copy]];
+            return;
+        }
+    }
+
+    callback();
+}
+
+#pragma mark - Resolution (private)
+
+- (void)fulfillWithOutput:(NSString *)output objects:(NSArray *)objects
+{
+    [self resolveWithState:MRBrewFutureStateFulfilled operation:[self operation] output:output objects:objects error:nil];
+}
+
+- (void)rejectWithError:(NSError *)error
+{
+    [self resolveWithState:MRBrewFutureStateRejected operation:[self operation] output:nil objects:nil error:error];
+}
+
+- (void)resolveWithFuture:(MRBrewFuture *)future
+{
+    [self resolveWithState:[future state] operation:[future operation] output:[future output] objects:[future objects] error:[future error]];
+}
+
+/* Resolves the receiver with the specified result and executes any pending
+ * handlers. Futures are resolved at most once, so subsequent calls are ignored.
+ */
+- (void)resolveWithState:(MRBrewFutureState)state operation:(MRBrewOperation *)operation output:(NSString *)output objects:(NSArray *)objects error:(NSError *)error
+{
+    NSArray *handlers;
+
+    @synchronized(self) {
+        if (_state != MRBrewFutureStatePending) {
+            return;
+        }
+
+        _operation = operation;
+        _output = [output copy];
+        _objects = [objects copy];
+        _error = error;
+        _state = state;
+
+        handlers = _handlers;
+        _handlers = nil;
+    }
+
+    for (void (^callback)(void) in handlers) {
+        callback();
+    }
+}
+
+#pragma mark - Accessors
+
+- (MRBrewFutureState)state
+{
+    @synchronized(self) {
+        return _state;
+    }
+}
+
+#pragma mark - Composition
+
+- (MRBrewFuture *)then:(MRBrewFutureContinuation)continuation
+{
+    MRBrewFuture *chained = [[MRBrewFuture alloc] initWithOperation:nil];
+
+    [self whenResolved:^(MRBrewFuture *future) {
+        if ([future state] == MRBrewFutureStateRejected) {
+            [chained resolveWithFuture:future];
+            return;
+        }
+
+        MRBrewFuture *next = continuation ? continuation(future) : nil;
+        if (!next) {
+            [chained resolveWithFuture:future];
+            return;
+        }
+
+        [next whenResolved:^(MRBrewFuture *nextFuture) {
+            [chained resolveWithFuture:nextFuture];
+        } queue:nil];
+    } queue:nil];
+
+    return chained;
+}
+
++ (MRBrewFuture *)all:(NSArray *)futures
+{
+    MRBrewFuture *combined = [[MRBrewFuture alloc] initWithOperation:nil];
+    NSArray *inputs = [futures copy];
+
+    if ([inputs count] == 0) {
+        [combined fulfillWithOutput:nil objects:inputs];
+        return combined;
+    }
+
+    __block NSUInteger remaining = [inputs count];
+    NSObject *lock = [[NSObject alloc] init];
+
+    for (MRBrewFuture *future in inputs) {
+        [future whenResolved:^(MRBrewFuture *resolved) {
+            if ([resolved state] == MRBrewFutureStateRejected) {
+                [combined rejectWithError:[resolved error]];
+                return;
+            }
+
+            BOOL finished;
+            @synchronized(lock) {
+                finished = (--remaining == 0);
+            }
+
+            if (finished) {
+                [combined fulfillWithOutput:nil objects:inputs];
+            }
+        } queue:nil];
+    }
+
+    return combined;
+}
+
++ (MRBrewFuture *)any:(NSArray *)futures
+{
+    NSParameterAssert([futures count] > 0);
+
+    MRBrewFuture *combined = [[MRBrewFuture alloc] initWithOperation:nil];
+
+    __block NSUInteger remaining = [futures count];
+    NSObject *lock = [[NSObject alloc] init];
+
+    for (MRBrewFuture *future in futures) {
+        [future whenResolved:^(MRBrewFuture *resolved) {
+            if ([resolved state] == MRBrewFutureStateFulfilled) {
+                [combined resolveWithFuture:resolved];
+                return;
+            }
+
+            // reject only once every input has been rejected, using the
+            // error of the last future to resolve
+            BOOL finished;
+            @synchronized(lock) {
+                finished = (--remaining == 0);
+            }
+
+            if (finished) {
+                [combined resolveWithFuture:resolved];
+            }
+        } queue:nil];
+    }
+
+    return combined;
+}
+
+@end
@@ -0,0 +1,75 @@
+//
+//  MRBrewInotifyWatcherBackend.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "MRBrewWatcherBackend.h"
+
+/** The block type used to report a directory that could not be watched.
+ *
+ * @param path The path of the directory.
+ * @param error An error in the `NSPOSIXErrorDomain` describing the failure,
+ * e.g. `ENOSPC` once the `fs.inotify.max_user_watches` limit is reached.
+ */
+typedef void (^MRBrewInotifyWatchErrorHandler)(NSString *path, NSError *error);
+
+/** An `MRBrewInotifyWatcherBackend` object observes the file system using the
+ * Linux inotify API, for use with Linuxbrew.
+ *
+ * Because inotify is not recursive, the backend adds a watch for every
+ * directory beneath the watched paths, including directories that are created
+ * after watching has started. A newly created directory is scanned as soon as
+ * its watch is added, so that any subdirectories created before the watch
+ * existed are not missed.
+ *
+ * A directory that is moved within a watched tree is watched at its new path,
+ * and one that is moved out of the tree is no longer watched.
+ *
+ * A watched path that does not exist yet, such as `PinnedKegs` before the first
+ * formula is pinned, is watched once it is created, as is one that is deleted
+ * or moved away and later recreated. Until then its nearest existing ancestor is
+ * watched for the creation of the path, and the path is reported as changed
+ * when it appears.
+ *
+ * Events are read on a dedicated thread and coalesced per directory for the
+ * configured latency, so a burst of events in a handful of directories costs a
+ * handful of path lookups. The handler is invoked on the queue specified by the
+ * handlerQueue property, or on a private serial queue if it is `nil`, so events
+ * are delivered even if the main thread never runs.
+ */
+@interface MRBrewInotifyWatcherBackend : NSObject <MRBrewWatcherBackend>
+
+/** The queue the handlers are invoked on, or `nil` to use a private serial
+ * queue. Changes take effect the next time the receiver starts watching.
+ */
+@property (strong) NSOperationQueue *handlerQueue;
+
+/** The block invoked, on the same queue as the handler, for each directory that
+ * could not be watched. Directories that are removed before their watch can be
+ * added, and watched paths that do not exist yet, are not reported. Changes take effect the next time the receiver starts
+ * watching.
+ */
+@property (copy) MRBrewInotifyWatchErrorHandler watchErrorHandler;
+
+@end
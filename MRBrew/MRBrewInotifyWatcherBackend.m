@@ -0,0 +1,573 @@
+//
+//  MRBrewInotifyWatcherBackend.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewInotifyWatcherBackend.h"
+
+#if defined(__linux__)
+
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+static const uint32_t MRBrewInotifyWatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW;
+
+// the ancestor of a missing root is only watched for the creation of the next
+// directory towards the root; the mask is added to that of any watch the
+// ancestor already has within a watched tree
+static const uint32_t MRBrewInotifyAncestorWatchMask = IN_CREATE | IN_MOVED_TO | IN_MOVE_SELF | IN_ONLYDIR | IN_MASK_ADD;
+enum { MRBrewInotifyReadBufferSize = 64 * 1024 };
+
+/* An MRBrewInotifySession owns the inotify and wake descriptors for a single
+ * call to startWatchingPaths:latency:handler:, along with the state that is
+ * accessed by its reading thread. Keeping this state out of the backend means a
+ * backend can be restarted while a previous reading thread is still exiting.
+ */
+@interface MRBrewInotifySession : NSObject
+{
+    @private
+    int _inotifyDescriptor;
+    int _wakeDescriptors[2];
+    volatile BOOL _stopRequested;
+    NSTimeInterval _latency;
+    NSArray *_rootPaths;
+    MRBrewWatcherBackendHandler _handler;
+    MRBrewInotifyWatchErrorHandler _errorHandler;
+    NSOperationQueue *_handlerQueue;
+    NSMutableDictionary *_pathsByWatchDescriptor;
+    NSMutableSet *_pendingRootPaths;
+    NSMutableDictionary *_ancestorPathsByWatchDescriptor;
+    NSMutableIndexSet *_changedWatchDescriptors;
+    NSMutableSet *_changedPaths;
+}
+
+- (instancetype)initWithPaths:(NSArray *)paths latency:(NSTimeInterval)latency handler:(MRBrewWatcherBackendHandler)handler errorHandler:(MRBrewInotifyWatchErrorHandler)errorHandler queue:(NSOperationQueue *)queue;
+- (BOOL)start;
+- (void)stop;
+
+@end
+
+@interface MRBrewInotifyWatcherBackend ()
+{
+    @private
+    MRBrewInotifySession *_session;
+    NSOperationQueue *_privateHandlerQueue;
+}
+
+@end
+
+@implementation MRBrewInotifyWatcherBackend
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        // handlers are invoked serially and in order, as they would be on the
+        // main thread, without depending on the main thread running
+        _privateHandlerQueue = [[NSOperationQueue alloc] init];
+        [_privateHandlerQueue setMaxConcurrentOperationCount:1];
+        [_privateHandlerQueue setName:@"uk.co.fidgetbox.MRBrew.inotify.handler"];
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    [self stopWatching];
+}
+
+#pragma mark - Control
+
+- (BOOL)startWatchingPaths:(NSArray *)paths latency:(NSTimeInterval)latency handler:(MRBrewWatcherBackendHandler)handler
+{
+    if ([self isWatching]) {
+        [self stopWatching];
+    }
+
+    NSOperationQueue *queue = [self handlerQueue] ? [self handlerQueue] : _privateHandlerQueue;
+    MRBrewInotifySession *session = [[MRBrewInotifySession alloc] initWithPaths:paths
+                                                                       latency:latency
+                                                                       handler:handler
+                                                                  errorHandler:[self watchErrorHandler]
+                                                                         queue:queue];
+    if (![session start]) {
+        return NO;
+    }
+
+    _session = session;
+
+    return YES;
+}
+
+- (void)stopWatching
+{
+    [_session stop];
+    _session = nil;
+}
+
+- (BOOL)isWatching
+{
+    return _session != nil;
+}
+
+@end
+
+@implementation MRBrewInotifySession
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithPaths:(NSArray *)paths latency:(NSTimeInterval)latency handler:(MRBrewWatcherBackendHandler)handler errorHandler:(MRBrewInotifyWatchErrorHandler)errorHandler queue:(NSOperationQueue *)queue
+{
+    if (self = [super init]) {
+        _inotifyDescriptor = -1;
+        _wakeDescriptors[0] = -1;
+        _wakeDescriptors[1] = -1;
+        _latency = latency;
+        _rootPaths = [paths copy];
+        _handler = [handler copy];
+        _errorHandler = [errorHandler copy];
+        _handlerQueue = queue;
+        _pathsByWatchDescriptor = [NSMutableDictionary dictionary];
+        _pendingRootPaths = [NSMutableSet set];
+        _ancestorPathsByWatchDescriptor = [NSMutableDictionary dictionary];
+        _changedWatchDescriptors = [NSMutableIndexSet indexSet];
+        _changedPaths = [NSMutableSet set];
+    }
+
+    return self;
+}
+
+#pragma mark - Control
+
+- (BOOL)start
+{
+    _inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotifyDescriptor < 0) {
+        return NO;
+    }
+
+    // a pipe is used to wake the reading thread when watching is stopped
+    if (pipe(_wakeDescriptors) != 0) {
+        close(_inotifyDescriptor);
+        _inotifyDescriptor = -1;
+        return NO;
+    }
+
+    [_pendingRootPaths addObjectsFromArray:_rootPaths];
+    [self watchPendingRootsReportingChanges:NO];
+
+    // the thread retains the session until it has finished reading
+    [NSThread detachNewThreadSelector:@selector(readEvents) toTarget:self withObject:nil];
+
+    return YES;
+}
+
+- (void)stop
+{
+    if (_wakeDescriptors[1] < 0) {
+        return;
+    }
+
+    // closing the write end of the pipe wakes the reading thread, which
+    // closes the remaining descriptors before exiting
+    _stopRequested = YES;
+    close(_wakeDescriptors[1]);
+    _wakeDescriptors[1] = -1;
+}
+
+#pragma mark - Watch Management (private)
+
+/* Adds a watch for the directory at the specified path and for each of its
+ * subdirectories. Symbolic links are not followed. If reportChanges is YES, each
+ * newly watched directory is reported as changed, since files may have been
+ * created in it before its watch was added. Returns NO if no more watches can
+ * be added, so that the caller can stop scanning.
+ */
+- (BOOL)addWatchesForDirectory:(NSString *)path reportChanges:(BOOL)reportChanges isRoot:(BOOL)isRoot
+{
+    const char *fileSystemPath = [path fileSystemRepresentation];
+    int watchDescriptor = inotify_add_watch(_inotifyDescriptor, fileSystemPath, MRBrewInotifyWatchMask);
+    if (watchDescriptor < 0) {
+        int error = errno;
+        
+        // a root that does not exist yet is watched once it is created
+        if (isRoot && error == ENOENT) {
+            [_pendingRootPaths addObject:path];
+            return YES;
+        }
+        
+        // a directory below a root may have been removed or replaced since it
+        // was seen, which is reported by the event on its parent instead
+        if (isRoot || (error != ENOENT && error != ENOTDIR)) {
+            [self reportWatchError:error forPath:path];
+        }
+        
+        return error != ENOSPC && error != ENOMEM;
+    }
+
+    [_pathsByWatchDescriptor setObject:path forKey:@(watchDescriptor)];
+    if (reportChanges) {
+        [_changedWatchDescriptors addIndex:(NSUInteger)watchDescriptor];
+    }
+
+    DIR *directory = opendir(fileSystemPath);
+    if (!directory) {
+        return YES;
+    }
+
+    BOOL canAddWatches = YES;
+
+    struct dirent *entry;
+    while (canAddWatches && (entry = readdir(directory)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        BOOL isDirectory = (entry->d_type == DT_DIR);
+        NSString *childPath = nil;
+
+        // not all file systems report the entry type, so fall back to lstat
+        if (entry->d_type == DT_UNKNOWN) {
+            struct stat status;
+            childPath = [path stringByAppendingPathComponent:[NSString stringWithUTF8String:entry->d_name]];
+            isDirectory = (lstat([childPath fileSystemRepresentation], &status) == 0 && S_ISDIR(status.st_mode));
+        }
+
+        if (isDirectory) {
+            if (!childPath) {
+                childPath = [path stringByAppendingPathComponent:[NSString stringWithUTF8String:entry->d_name]];
+            }
+            canAddWatches = [self addWatchesForDirectory:childPath reportChanges:reportChanges isRoot:NO];
+        }
+    }
+
+    closedir(directory);
+
+    return canAddWatches;
+}
+
+/* Adds watches for the roots that did not exist when they were last added,
+ * e.g. PinnedKegs before the first formula is pinned, or a root that has been
+ * deleted. Roots that still do not exist are waited for by watching their
+ * nearest existing ancestor, which is watched again each time a directory is
+ * created in it, until the root itself can be watched.
+ */
+- (void)watchPendingRootsReportingChanges:(BOOL)reportChanges
+{
+    NSSet *rootPaths = [_pendingRootPaths copy];
+    [_pendingRootPaths removeAllObjects];
+    
+    // the nearest existing ancestor of each root is watched before the root is
+    // added, so that a root created in between is not missed
+    NSMutableDictionary *ancestorPathsByRootPath = [NSMutableDictionary dictionary];
+    for (NSString *rootPath in rootPaths) {
+        NSString *ancestorPath = [rootPath stringByDeletingLastPathComponent];
+        struct stat status;
+        while ([ancestorPath length] > 1 && !(stat([ancestorPath fileSystemRepresentation], &status) == 0 && S_ISDIR(status.st_mode))) {
+            ancestorPath = [ancestorPath stringByDeletingLastPathComponent];
+        }
+        [ancestorPathsByRootPath setObject:ancestorPath forKey:rootPath];
+        
+        if ([[_ancestorPathsByWatchDescriptor allKeysForObject:ancestorPath] count] > 0) {
+            continue;
+        }
+        
+        int watchDescriptor = inotify_add_watch(_inotifyDescriptor, [ancestorPath fileSystemRepresentation], MRBrewInotifyAncestorWatchMask);
+        if (watchDescriptor < 0) {
+            if (errno != ENOENT) {
+                [self reportWatchError:errno forPath:ancestorPath];
+            }
+            continue;
+        }
+        [_ancestorPathsByWatchDescriptor setObject:ancestorPath forKey:@(watchDescriptor)];
+    }
+    
+    for (NSString *rootPath in rootPaths) {
+        [self addWatchesForDirectory:rootPath reportChanges:reportChanges isRoot:YES];
+    }
+    
+    // ancestors that no missing root is waiting on are no longer watched,
+    // unless they are also within a watched tree
+    NSMutableSet *ancestorPaths = [NSMutableSet set];
+    for (NSString *rootPath in _pendingRootPaths) {
+        NSString *ancestorPath = [ancestorPathsByRootPath objectForKey:rootPath];
+        if (ancestorPath) {
+            [ancestorPaths addObject:ancestorPath];
+        }
+    }
+    
+    for (NSNumber *watchDescriptor in [_ancestorPathsByWatchDescriptor allKeys]) {
+        if ([ancestorPaths containsObject:[_ancestorPathsByWatchDescriptor objectForKey:watchDescriptor]]) {
+            continue;
+        }
+        
+        if (![_pathsByWatchDescriptor objectForKey:watchDescriptor]) {
+            inotify_rm_watch(_inotifyDescriptor, [watchDescriptor intValue]);
+        }
+        [_ancestorPathsByWatchDescriptor removeObjectForKey:watchDescriptor];
+    }
+}
+
+/* Removes the watches for the directory at the specified path and for each of
+ * its subdirectories, e.g. after the directory has been moved. The IN_IGNORED
+ * events that follow find no path and are skipped.
+ */
+- (void)removeWatchesForDirectory:(NSString *)path
+{
+    NSString *prefix = [path stringByAppendingString:@"/"];
+    NSMutableArray *watchDescriptors = [NSMutableArray array];
+
+    [_pathsByWatchDescriptor enumerateKeysAndObjectsUsingBlock:^(NSNumber *watchDescriptor, NSString *watchedPath, BOOL *stop) {
+        if ([watchedPath isEqualToString:path] || [watchedPath hasPrefix:prefix]) {
+            [watchDescriptors addObject:watchDescriptor];
+        }
+    }];
+
+    for (NSNumber *watchDescriptor in watchDescriptors) {
+        inotify_rm_watch(_inotifyDescriptor, [watchDescriptor intValue]);
+        [_pathsByWatchDescriptor removeObjectForKey:watchDescriptor];
+        [_changedWatchDescriptors removeIndex:[watchDescriptor unsignedIntegerValue]];
+    }
+}
+
+/* Reports a directory that could not be watched to the error handler. */
+- (void)reportWatchError:(int)error forPath:(NSString *)path
+{
+    MRBrewInotifyWatchErrorHandler errorHandler = _errorHandler;
+    if (!errorHandler) {
+        return;
+    }
+
+    NSError *watchError = [NSError errorWithDomain:NSPOSIXErrorDomain code:error userInfo:@{NSFilePathErrorKey : path}];
+    [_handlerQueue addOperationWithBlock:^{
+        errorHandler(path, watchError);
+    }];
+}
+
+#pragma mark - Event Handling (private)
+
+static NSTimeInterval MRBrewInotifyMonotonicTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (NSTimeInterval)now.tv_sec + (NSTimeInterval)now.tv_nsec / 1e9;
+}
+
+- (void)readEvents
+{
+    [[NSThread currentThread] setName:@"uk.co.fidgetbox.MRBrew.inotify"];
+
+    struct pollfd descriptors[2];
+    descriptors[0].fd = _inotifyDescriptor;
+    descriptors[0].events = POLLIN;
+    descriptors[1].fd = _wakeDescriptors[0];
+    descriptors[1].events = POLLIN;
+
+    NSTimeInterval firstEventTime = 0;
+    BOOL eventsPending = NO;
+
+    while (!_stopRequested) {
+        int timeout = -1;
+        if (eventsPending) {
+            NSTimeInterval remaining = firstEventTime + _latency - MRBrewInotifyMonotonicTime();
+            timeout = remaining > 0 ? (int)(remaining * 1000.0) + 1 : 0;
+        }
+
+        int ready = poll(descriptors, 2, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        if (descriptors[1].revents) {
+            break;
+        }
+
+        if (ready > 0 && (descriptors[0].revents & POLLIN)) {
+            @autoreleasepool {
+                [self readAvailableEvents];
+            }
+
+            if (!eventsPending && ([_changedWatchDescriptors count] > 0 || [_changedPaths count] > 0)) {
+                eventsPending = YES;
+                firstEventTime = MRBrewInotifyMonotonicTime();
+            }
+        }
+
+        if (eventsPending && MRBrewInotifyMonotonicTime() - firstEventTime >= _latency) {
+            @autoreleasepool {
+                [self flushChanges];
+            }
+            eventsPending = NO;
+        }
+    }
+
+    close(_inotifyDescriptor);
+    close(_wakeDescriptors[0]);
+    _inotifyDescriptor = -1;
+    _wakeDescriptors[0] = -1;
+}
+
+/* Drains the inotify descriptor. Events are recorded by watch descriptor only,
+ * deferring the construction of path strings until the changes are flushed.
+ */
+- (void)readAvailableEvents
+{
+    char buffer[MRBrewInotifyReadBufferSize] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    for (;;) {
+        ssize_t length = read(_inotifyDescriptor, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+
+        const char *position = buffer;
+        while (position < buffer + length) {
+            const struct inotify_event *event = (const struct inotify_event *)position;
+            position += sizeof(struct inotify_event) + event->len;
+
+            // events were dropped by the kernel, so report every root path
+            if (event->mask & IN_Q_OVERFLOW) {
+                [_changedPaths addObjectsFromArray:_rootPaths];
+                continue;
+            }
+
+            if (event->wd < 0) {
+                continue;
+            }
+
+            // the watch was removed along with its directory, so resolve the
+            // path now rather than when the changes are flushed; a root is
+            // watched again once it is recreated
+            if (event->mask & IN_IGNORED) {
+                NSString *path = [_pathsByWatchDescriptor objectForKey:@(event->wd)];
+                if (path) {
+                    [_changedPaths addObject:path];
+                    [_pathsByWatchDescriptor removeObjectForKey:@(event->wd)];
+                    if ([_rootPaths containsObject:path]) {
+                        [_pendingRootPaths addObject:path];
+                    }
+                }
+                [_ancestorPathsByWatchDescriptor removeObjectForKey:@(event->wd)];
+                [_changedWatchDescriptors removeIndex:(NSUInteger)event->wd];
+                
+                if ([_pendingRootPaths count] > 0) {
+                    [self watchPendingRootsReportingChanges:YES];
+                }
+                continue;
+            }
+            
+            NSString *watchedPath = [_pathsByWatchDescriptor objectForKey:@(event->wd)];
+            
+            // a root that is moved away keeps its watches, which would report
+            // its old path, so it is treated as deleted
+            if ((event->mask & IN_MOVE_SELF) && watchedPath && [_rootPaths containsObject:watchedPath]) {
+                [_changedPaths addObject:watchedPath];
+                [self removeWatchesForDirectory:watchedPath];
+                [_pendingRootPaths addObject:watchedPath];
+                [self watchPendingRootsReportingChanges:YES];
+                continue;
+            }
+            
+            // events on the ancestor of a missing root are not reported, but
+            // may mean the root, or a directory towards it, now exists
+            if (!watchedPath) {
+                if ([_ancestorPathsByWatchDescriptor objectForKey:@(event->wd)]) {
+                    if (event->mask & IN_MOVE_SELF) {
+                        inotify_rm_watch(_inotifyDescriptor, event->wd);
+                        [_ancestorPathsByWatchDescriptor removeObjectForKey:@(event->wd)];
+                    }
+                    [self watchPendingRootsReportingChanges:YES];
+                }
+                continue;
+            }
+
+            [_changedWatchDescriptors addIndex:(NSUInteger)event->wd];
+
+            if (!(event->mask & IN_ISDIR) || event->len == 0) {
+                continue;
+            }
+
+            NSString *directoryPath = [watchedPath stringByAppendingPathComponent:[NSString stringWithUTF8String:event->name]];
+
+            // a moved directory keeps its watches, which would report its old
+            // path, so they are removed and added again at the new path if it
+            // is still within a watched tree
+            if (event->mask & IN_MOVED_FROM) {
+                [self removeWatchesForDirectory:directoryPath];
+            }
+
+            // watch directories that are created or moved into a watched tree,
+            // which may include a missing root or one of its ancestors
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                [self addWatchesForDirectory:directoryPath reportChanges:YES isRoot:NO];
+                
+                if ([_pendingRootPaths count] > 0) {
+                    [self watchPendingRootsReportingChanges:YES];
+                }
+            }
+        }
+    }
+}
+
+/* Resolves the changed watch descriptors to paths and delivers them to the
+ * handler on the handler queue.
+ */
+- (void)flushChanges
+{
+    NSMutableSet *paths = [NSMutableSet setWithSet:_changedPaths];
+
+    [_changedWatchDescriptors enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        NSString *path = [_pathsByWatchDescriptor objectForKey:@(index)];
+        if (path) {
+            [paths addObject:path];
+        }
+    }];
+
+    [_changedWatchDescriptors removeAllIndexes];
+    [_changedPaths removeAllObjects];
+
+    MRBrewWatcherBackendHandler handler = _handler;
+    if ([paths count] == 0 || !handler || _stopRequested) {
+        return;
+    }
+
+    NSArray *modifiedPaths = [paths allObjects];
+    [_handlerQueue addOperationWithBlock:^{
+        handler(modifiedPaths);
+    }];
+}
+
+@end
+
+#endif
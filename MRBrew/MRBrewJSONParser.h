@@ -0,0 +1,97 @@
+//
+//  MRBrewJSONParser.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+@class MRBrewJSONParser;
+
+/** The `MRBrewJSONParserDelegate` protocol defines the methods an
+ * MRBrewJSONParser calls as it encounters each element of a JSON document.
+ */
+@protocol MRBrewJSONParserDelegate <NSObject>
+
+- (void)parserDidStartObject:(MRBrewJSONParser *)parser;
+- (void)parserDidEndObject:(MRBrewJSONParser *)parser;
+- (void)parserDidStartArray:(MRBrewJSONParser *)parser;
+- (void)parserDidEndArray:(MRBrewJSONParser *)parser;
+
+/** Called for each object member name. The delegate may call skipNextValue
+ * from this method to ignore the member's value.
+ */
+- (void)parser:(MRBrewJSONParser *)parser foundKey:(NSString *)key;
+- (void)parser:(MRBrewJSONParser *)parser foundString:(NSString *)string;
+- (void)parser:(MRBrewJSONParser *)parser foundNumber:(NSNumber *)number;
+- (void)parser:(MRBrewJSONParser *)parser foundBool:(BOOL)value;
+- (void)parserFoundNull:(MRBrewJSONParser *)parser;
+
+@end
+
+/** An `MRBrewJSONParser` object is an incremental, event-driven JSON parser.
+ *
+ * Data can be passed to the parser in chunks of any size as it becomes
+ * available, for example as a brew task writes its output, and the delegate is
+ * informed of each element as soon as it is complete. Only the bytes of a token
+ * that spans chunks are retained between calls, and a string split across many
+ * chunks is scanned once, in linear time.
+ *
+ * Values the delegate is not interested in can be skipped by calling
+ * skipNextValue when their key is reported; the parser then steps over the
+ * value without creating any objects for it.
+ */
+@interface MRBrewJSONParser : NSObject
+
+/** The parser's delegate. */
+@property (weak) id<MRBrewJSONParserDelegate> delegate;
+
+/** Returns an initialized `MRBrewJSONParser` object with the specified
+ * delegate.
+ *
+ * @param delegate The delegate to inform of parsed elements.
+ * @return A parser with the specified delegate.
+ */
+- (instancetype)initWithDelegate:(id<MRBrewJSONParserDelegate>)delegate;
+
+/** Parses the next chunk of the document.
+ *
+ * @param data The bytes following those passed to the previous call.
+ * @return `NO` if the document is malformed, otherwise `YES`.
+ */
+- (BOOL)parseData:(NSData *)data;
+
+/** Indicates that no more data will be passed to the parser.
+ *
+ * @return `YES` if the data passed to the parser formed a complete document,
+ * otherwise `NO`.
+ */
+- (BOOL)finish;
+
+/** Causes the parser to skip the value following the key currently being
+ * reported, including any nested objects or arrays, without informing the
+ * delegate of its contents. Call this method only from
+ * parser:foundKey:.
+ */
+- (void)skipNextValue;
+
+@end
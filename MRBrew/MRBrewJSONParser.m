@@ -0,0 +1,626 @@
+//
+//  MRBrewJSONParser.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewJSONParser.h"
+
+typedef NS_ENUM(NSInteger, MRBrewJSONParserState) {
+    MRBrewJSONParserStateValue,
+    MRBrewJSONParserStateValueOrEnd,
+    MRBrewJSONParserStateKeyOrEnd,
+    MRBrewJSONParserStateKey,
+    MRBrewJSONParserStateColon,
+    MRBrewJSONParserStateCommaOrEnd,
+    MRBrewJSONParserStateDone,
+    MRBrewJSONParserStateError
+};
+
+typedef NS_ENUM(NSInteger, MRBrewJSONScanResult) {
+    MRBrewJSONScanComplete,
+    MRBrewJSONScanIncomplete,
+    MRBrewJSONScanInvalid
+};
+
+enum { MRBrewJSONMaximumNumberLength = 63 };
+
+static inline BOOL MRBrewJSONIsWhitespace(uint8_t c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline BOOL MRBrewJSONIsNumberByte(uint8_t c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+static inline int MRBrewJSONHexValue(uint8_t c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+@interface MRBrewJSONParser ()
+{
+    @private
+    MRBrewJSONParserState _state;
+    NSMutableData *_containers;
+    NSMutableData *_pending;
+    NSMutableData *_resumedBuffer;
+    NSUInteger _pendingStringScanLength;
+    BOOL _pendingStringEscaped;
+    NSMutableData *_scratch;
+    NSUInteger _skipDepth;
+    BOOL _skipsNextValue;
+}
+
+@end
+
+@implementation MRBrewJSONParser
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    return [self initWithDelegate:nil];
+}
+
+- (instancetype)initWithDelegate:(id<MRBrewJSONParserDelegate>)delegate
+{
+    if (self = [super init]) {
+        _delegate = delegate;
+        _state = MRBrewJSONParserStateValue;
+        _containers = [NSMutableData data];
+        _pending = [NSMutableData data];
+        _scratch = [NSMutableData data];
+    }
+
+    return self;
+}
+
+#pragma mark - Parsing
+
+- (BOOL)parseData:(NSData *)data
+{
+    if (_state == MRBrewJSONParserStateError) {
+        return NO;
+    }
+
+    // a token was split across chunks, so parse it together with the new data
+    if ([_pending length]) {
+        NSMutableData *buffer = _pending;
+        [buffer appendData:data];
+        _pending = [NSMutableData data];
+
+        _resumedBuffer = buffer;
+        BOOL result = [self parseBytes:[buffer bytes] length:[buffer length] final:NO];
+        _resumedBuffer = nil;
+
+        return result;
+    }
+
+    return [self parseBytes:[data bytes] length:[data length] final:NO];
+}
+
+- (BOOL)finish
+{
+    if (_state == MRBrewJSONParserStateError) {
+        return NO;
+    }
+
+    if ([_pending length]) {
+        NSMutableData *buffer = _pending;
+        _pending = [NSMutableData data];
+
+        if (![self parseBytes:[buffer bytes] length:[buffer length] final:YES]) {
+            return NO;
+        }
+    }
+
+    return _state == MRBrewJSONParserStateDone;
+}
+
+- (void)skipNextValue
+{
+    _skipsNextValue = YES;
+}
+
+- (BOOL)parseBytes:(const uint8_t *)bytes length:(NSUInteger)length final:(BOOL)final
+{
+    const uint8_t *position = bytes;
+    const uint8_t *end = bytes + length;
+
+    while (position < end) {
+        uint8_t c = *position;
+
+        if (MRBrewJSONIsWhitespace(c)) {
+            position++;
+            continue;
+        }
+
+        const uint8_t *tokenStart = position;
+        MRBrewJSONScanResult result;
+
+        switch (c) {
+            case '{':
+            case '[':
+                result = [self beginContainer:c];
+                position++;
+                break;
+            case '}':
+            case ']':
+                result = [self endContainer:c];
+                position++;
+                break;
+            case ',':
+                result = [self scanComma];
+                position++;
+                break;
+            case ':':
+                result = [self scanColon];
+                position++;
+                break;
+            case '"':
+                result = [self scanString:&position end:end final:final];
+                break;
+            default:
+                result = [self scanLiteral:&position end:end final:final];
+                break;
+        }
+
+        if (result == MRBrewJSONScanIncomplete) {
+            // a token that still spans the whole of a resumed buffer, such as a
+            // long string, keeps the buffer rather than copying it again
+            if (_resumedBuffer && tokenStart == (const uint8_t *)[_resumedBuffer bytes]) {
+                _pending = _resumedBuffer;
+            }
+            else {
+                [_pending appendBytes:tokenStart length:(NSUInteger)(end - tokenStart)];
+            }
+            return YES;
+        }
+
+        if (result == MRBrewJSONScanInvalid) {
+            _state = MRBrewJSONParserStateError;
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+#pragma mark - Tokens
+
+/* Returns YES if the value about to be read should not be reported to the
+ * delegate, either because it is being skipped or it is inside a skipped value.
+ */
+- (BOOL)willReadValue
+{
+    BOOL skip = _skipDepth > 0 || _skipsNextValue;
+    _skipsNextValue = NO;
+
+    return skip;
+}
+
+- (void)didReadValue
+{
+    _state = [_containers length] ? MRBrewJSONParserStateCommaOrEnd : MRBrewJSONParserStateDone;
+}
+
+- (BOOL)acceptsValue
+{
+    return _state == MRBrewJSONParserStateValue || _state == MRBrewJSONParserStateValueOrEnd;
+}
+
+- (uint8_t)innermostContainer
+{
+    NSUInteger depth = [_containers length];
+
+    return depth ? ((const uint8_t *)[_containers bytes])[depth - 1] : 0;
+}
+
+- (MRBrewJSONScanResult)beginContainer:(uint8_t)c
+{
+    if (![self acceptsValue]) {
+        return MRBrewJSONScanInvalid;
+    }
+
+    BOOL skip = [self willReadValue];
+    [_containers appendBytes:&c length:1];
+
+    if (c == '{') {
+        _state = MRBrewJSONParserStateKeyOrEnd;
+    }
+    else {
+        _state = MRBrewJSONParserStateValueOrEnd;
+    }
+
+    if (skip) {
+        _skipDepth++;
+    }
+    else if (c == '{') {
+        [[self delegate] parserDidStartObject:self];
+    }
+    else {
+        [[self delegate] parserDidStartArray:self];
+    }
+
+    return MRBrewJSONScanComplete;
+}
+
+- (MRBrewJSONScanResult)endContainer:(uint8_t)c
+{
+    uint8_t open = (c == '}') ? '{' : '[';
+    MRBrewJSONParserState emptyState = (c == '}') ? MRBrewJSONParserStateKeyOrEnd : MRBrewJSONParserStateValueOrEnd;
+
+    if ([self innermostContainer] != open || (_state != emptyState && _state != MRBrewJSONParserStateCommaOrEnd)) {
+        return MRBrewJSONScanInvalid;
+    }
+
+    [_containers setLength:[_containers length] - 1];
+    [self didReadValue];
+
+    if (_skipDepth) {
+        _skipDepth--;
+    }
+    else if (c == '}') {
+        [[self delegate] parserDidEndObject:self];
+    }
+    else {
+        [[self delegate] parserDidEndArray:self];
+    }
+
+    return MRBrewJSONScanComplete;
+}
+
+- (MRBrewJSONScanResult)scanComma
+{
+    if (_state != MRBrewJSONParserStateCommaOrEnd) {
+        return MRBrewJSONScanInvalid;
+    }
+
+    _state = ([self innermostContainer] == '{') ? MRBrewJSONParserStateKey : MRBrewJSONParserStateValue;
+
+    return MRBrewJSONScanComplete;
+}
+
+- (MRBrewJSONScanResult)scanColon
+{
+    if (_state != MRBrewJSONParserStateColon) {
+        return MRBrewJSONScanInvalid;
+    }
+
+    _state = MRBrewJSONParserStateValue;
+
+    return MRBrewJSONScanComplete;
+}
+
+- (MRBrewJSONScanResult)scanString:(const uint8_t **)position end:(const uint8_t *)end final:(BOOL)final
+{
+    BOOL isKey = (_state == MRBrewJSONParserStateKeyOrEnd || _state == MRBrewJSONParserStateKey);
+    if (!isKey && ![self acceptsValue]) {
+        return MRBrewJSONScanInvalid;
+    }
+
+    // find the closing quote before doing anything else, since the string may
+    // continue in the next chunk; a string that was split is pending from its
+    // opening quote, and is scanned from where the previous chunk ended
+    const uint8_t *start = *position + 1;
+    const uint8_t *cursor = _pendingStringScanLength ? *position + _pendingStringScanLength : start;
+    BOOL escaped = _pendingStringEscaped;
+    _pendingStringScanLength = 0;
+    _pendingStringEscaped = NO;
+
+    while (cursor < end && *cursor != '"') {
+        if (*cursor == '\\') {
+            // the escaped character is in the next chunk
+            if (end - cursor < 2) {
+                break;
+            }
+            escaped = YES;
+            cursor += 2;
+        }
+        else if (*cursor < 0x20) {
+            return MRBrewJSONScanInvalid;
+        }
+        else {
+            cursor++;
+        }
+    }
+
+    if (cursor >= end || *cursor != '"') {
+        if (final) {
+            return MRBrewJSONScanInvalid;
+        }
+        _pendingStringScanLength = (NSUInteger)(cursor - *position);
+        _pendingStringEscaped = escaped;
+        return MRBrewJSONScanIncomplete;
+    }
+
+    BOOL skip = isKey ? (_skipDepth > 0) : [self willReadValue];
+    NSString *string = nil;
+
+    if (!skip) {
+        string = [self stringWithBytes:start length:(NSUInteger)(cursor - start) escaped:escaped];
+        if (!string) {
+            return MRBrewJSONScanInvalid;
+        }
+    }
+
+    *position = cursor + 1;
+
+    if (isKey) {
+        _state = MRBrewJSONParserStateColon;
+        if (!skip) {
+            [[self delegate] parser:self foundKey:string];
+        }
+    }
+    else {
+        [self didReadValue];
+        if (!skip) {
+            [[self delegate] parser:self foundString:string];
+        }
+    }
+
+    return MRBrewJSONScanComplete;
+}
+
+- (MRBrewJSONScanResult)scanLiteral:(const uint8_t **)position end:(const uint8_t *)end final:(BOOL)final
+{
+    if (![self acceptsValue]) {
+        return MRBrewJSONScanInvalid;
+    }
+
+    const uint8_t *start = *position;
+
+    if (*start == 't' || *start == 'f' || *start == 'n') {
+        const char *word = (*start == 't') ? "true" : (*start == 'f') ? "false" : "null";
+        size_t wordLength = strlen(word);
+        size_t available = (size_t)(end - start);
+
+        if (available < wordLength) {
+            if (final || memcmp(start, word, available) != 0) {
+                return MRBrewJSONScanInvalid;
+            }
+            return MRBrewJSONScanIncomplete;
+        }
+
+        if (memcmp(start, word, wordLength) != 0) {
+            return MRBrewJSONScanInvalid;
+        }
+
+        *position = start + wordLength;
+        BOOL skip = [self willReadValue];
+        [self didReadValue];
+
+        if (!skip) {
+            if (*start == 'n') {
+                [[self delegate] parserFoundNull:self];
+            }
+            else {
+                [[self delegate] parser:self foundBool:(*start == 't')];
+            }
+        }
+
+        return MRBrewJSONScanComplete;
+    }
+
+    if (*start != '-' && !(*start >= '0' && *start <= '9')) {
+        return MRBrewJSONScanInvalid;
+    }
+
+    const uint8_t *cursor = start;
+    BOOL isInteger = YES;
+    while (cursor < end && MRBrewJSONIsNumberByte(*cursor)) {
+        if (*cursor == '.' || *cursor == 'e' || *cursor == 'E') {
+            isInteger = NO;
+        }
+        cursor++;
+    }
+
+    // the number may continue in the next chunk
+    if (cursor == end && !final) {
+        return MRBrewJSONScanIncomplete;
+    }
+
+    size_t numberLength = (size_t)(cursor - start);
+    if (numberLength > MRBrewJSONMaximumNumberLength) {
+        return MRBrewJSONScanInvalid;
+    }
+
+    char buffer[MRBrewJSONMaximumNumberLength + 1];
+    memcpy(buffer, start, numberLength);
+    buffer[numberLength] = '\0';
+
+    char *numberEnd = NULL;
+    NSNumber *number = nil;
+    if (isInteger) {
+        number = [NSNumber numberWithLongLong:strtoll(buffer, &numberEnd, 10)];
+    }
+    else {
+        number = [NSNumber numberWithDouble:strtod(buffer, &numberEnd)];
+    }
+
+    if (numberEnd != buffer + numberLength) {
+        return MRBrewJSONScanInvalid;
+    }
+
+    *position = cursor;
+    BOOL skip = [self willReadValue];
+    [self didReadValue];
+
+    if (!skip) {
+        [[self delegate] parser:self foundNumber:number];
+    }
+
+    return MRBrewJSONScanComplete;
+}
+
+#pragma mark - Strings
+
+/* Returns a string for the UTF-8 bytes between a pair of quotes, resolving any
+ * escape sequences into a reusable scratch buffer. Returns nil if an escape
+ * sequence or the encoding is invalid.
+ */
+- (NSString *)stringWithBytes:(const uint8_t *)bytes length:(NSUInteger)length escaped:(BOOL)escaped
+{
+    if (!escaped) {
+        return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+    }
+
+    [_scratch setLength:0];
+
+    const uint8_t *cursor = bytes;
+    const uint8_t *end = bytes + length;
+
+    while (cursor < end) {
+        // copy the run of bytes up to the next escape sequence
+        const uint8_t *run = cursor;
+        while (cursor < end && *cursor != '\\') {
+            cursor++;
+        }
+        [_scratch appendBytes:run length:(NSUInteger)(cursor - run)];
+
+        if (cursor == end) {
+            break;
+        }
+
+        if (end - cursor < 2) {
+            return nil;
+        }
+
+        uint8_t unescaped;
+        switch (cursor[1]) {
+            case '"':  unescaped = '"';  break;
+            case '\\': unescaped = '\\'; break;
+            case '/':  unescaped = '/';  break;
+            case 'b':  unescaped = '\b'; break;
+            case 'f':  unescaped = '\f'; break;
+            case 'n':  unescaped = '\n'; break;
+            case 'r':  unescaped = '\r'; break;
+            case 't':  unescaped = '\t'; break;
+            case 'u': {
+                uint32_t codePoint;
+                if (![self scanUnicodeEscape:&cursor end:end codePoint:&codePoint]) {
+                    return nil;
+                }
+                [self appendCodePoint:codePoint];
+                continue;
+            }
+            default:
+                return nil;
+        }
+
+        [_scratch appendBytes:&unescaped length:1];
+        cursor += 2;
+    }
+
+    return [[NSString alloc] initWithBytes:[_scratch bytes] length:[_scratch length] encoding:NSUTF8StringEncoding];
+}
+
+/* Reads a \uXXXX escape sequence, combining it with a following low surrogate
+ * escape where necessary.
+ */
+- (BOOL)scanUnicodeEscape:(const uint8_t **)position end:(const uint8_t *)end codePoint:(uint32_t *)codePoint
+{
+    uint32_t units[2] = {0, 0};
+    NSUInteger unitCount = 0;
+    const uint8_t *cursor = *position;
+
+    while (unitCount < 2 && end - cursor >= 6 && cursor[0] == '\\' && cursor[1] == 'u') {
+        uint32_t unit = 0;
+        for (int i = 2; i < 6; i++) {
+            int value = MRBrewJSONHexValue(cursor[i]);
+            if (value < 0) {
+                return NO;
+            }
+            unit = (unit << 4) | (uint32_t)value;
+        }
+
+        // only continue to a second unit for a surrogate pair
+        if (unitCount == 1 && (unit < 0xDC00 || unit > 0xDFFF)) {
+            break;
+        }
+
+        units[unitCount++] = unit;
+        cursor += 6;
+
+        if (unit < 0xD800 || unit > 0xDBFF) {
+            break;
+        }
+    }
+
+    if (unitCount == 0) {
+        return NO;
+    }
+
+    if (unitCount == 2) {
+        *codePoint = 0x10000 + ((units[0] - 0xD800) << 10) + (units[1] - 0xDC00);
+    }
+    else if (units[0] >= 0xD800 && units[0] <= 0xDFFF) {
+        // unpaired surrogate
+        *codePoint = 0xFFFD;
+    }
+    else {
+        *codePoint = units[0];
+    }
+
+    *position = cursor;
+
+    return YES;
+}
+
+- (void)appendCodePoint:(uint32_t)codePoint
+{
+    uint8_t encoded[4];
+    NSUInteger length;
+
+    if (codePoint < 0x80) {
+        encoded[0] = (uint8_t)codePoint;
+        length = 1;
+    }
+    else if (codePoint < 0x800) {
+        encoded[0] = (uint8_t)(0xC0 | (codePoint >> 6));
+        encoded[1] = (uint8_t)(0x80 | (codePoint & 0x3F));
+        length = 2;
+    }
+    else if (codePoint < 0x10000) {
+        encoded[0] = (uint8_t)(0xE0 | (codePoint >> 12));
+        encoded[1] = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+        encoded[2] = (uint8_t)(0x80 | (codePoint & 0x3F));
+        length = 3;
+    }
+    else {
+        encoded[0] = (uint8_t)(0xF0 | (codePoint >> 18));
+        encoded[1] = (uint8_t)(0x80 | ((codePoint >> 12) & 0x3F));
+        encoded[2] = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+        encoded[3] = (uint8_t)(0x80 | (codePoint & 0x3F));
+        length = 4;
+    }
+
+    [_scratch appendBytes:encoded length:length];
+}
+
+@end
@@ -0,0 +1,169 @@
+//
+//  MRBrewLocations.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/** An `MRBrewLocations` object describes where a Homebrew installation keeps
+ * its executable, prefix, `Cellar`, repository and download cache, the paths
+ * printed by `brew --prefix`, `brew --cellar`, `brew --repository` and
+ * `brew --cache`.
+ *
+ * Asking Homebrew for each of these paths costs a Ruby process apiece. Instead
+ * the locations are resolved from the layout of the installation around its
+ * executable, and only if the layout is not recognised is Homebrew run, once,
+ * to describe its configuration. The result is stored in a property list,
+ * together with the inode number and modification date of the executable, so
+ * that later launches resolve the same installation without reading its layout
+ * or running any process. Replacing or updating the executable, creating or
+ * removing the `Cellar` in the prefix, or changing the `HOMEBREW_CACHE`
+ * environment variable invalidates the stored locations.
+ *
+ * Use defaultLocations for the installation found on the `PATH` or at one of
+ * the well-known prefixes. `MRBrew`, `MRBrewWatcher`, `MRBrewSnapshot` and
+ * `MRBrewOutdatedScanner` use these locations unless given others.
+ */
+@interface MRBrewLocations : NSObject <NSCopying>
+
+/** The absolute path of the Homebrew executable, such as `/usr/local/bin/brew`. */
+@property (readonly, copy) NSString *brewPath;
+
+/** The prefix formulae are linked into, such as `/usr/local`. */
+@property (readonly, copy) NSString *prefixPath;
+
+/** The directory formulae are installed into, such as `/usr/local/Cellar`. */
+@property (readonly, copy) NSString *cellarPath;
+
+/** The directory containing Homebrew's own code and formulae, such as
+ * `/usr/local`.
+ */
+@property (readonly, copy) NSString *repositoryPath;
+
+/** The directory downloads are cached in, such as
+ * `~/Library/Caches/Homebrew`, or `~/.cache/Homebrew` on Linux.
+ */
+@property (readonly, copy) NSString *cachePath;
+
+/**-----------------------------------------------------------------------------
+ * @name Discovering Locations
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns the locations of the Homebrew installation whose executable is
+ * found first on the `PATH` or, failing that, at one of the well-known
+ * prefixes `/usr/local`, `/opt/homebrew`, `~/homebrew` and `~/.homebrew`, or
+ * the Linuxbrew prefixes `/home/linuxbrew/.linuxbrew` and `~/.linuxbrew`.
+ *
+ * Discovery happens once per process. If no executable is found, the
+ * locations of a default installation at `/usr/local`, or at
+ * `/home/linuxbrew/.linuxbrew` on Linux, are returned.
+ *
+ * @return The locations of the default Homebrew installation.
+ */
++ (instancetype)defaultLocations;
+
+/** Returns the absolute path of the first Homebrew executable found on the
+ * `PATH` or at one of the well-known prefixes.
+ *
+ * @return The path of a Homebrew executable, or `nil` if none is found.
+ */
++ (NSString *)discoverBrewPath;
+
+/** Returns the locations of the Homebrew installation with the specified
+ * executable, using those stored by a previous call if the executable has not
+ * changed since.
+ *
+ * @param brewPath The absolute path of a Homebrew executable.
+ * @return The locations of the installation, or `nil` if the executable does
+ * not exist or its locations cannot be determined.
+ */
++ (instancetype)locationsForBrewPath:(NSString *)brewPath;
+
+/** Returns the locations of the Homebrew installation with the specified
+ * executable, reading and updating the stored locations at the specified path.
+ *
+ * @param brewPath The absolute path of a Homebrew executable.
+ * @param storePath The path of the property list the locations are stored in,
+ * or `nil` to neither read nor store them.
+ * @return The locations of the installation, or `nil` if the executable does
+ * not exist or its locations cannot be determined.
+ */
++ (instancetype)locationsForBrewPath:(NSString *)brewPath storePath:(NSString *)storePath;
+
+/** Returns the path of the property list locations are stored in by
+ * locationsForBrewPath:, inside the current user's caches directory.
+ *
+ * @return The default store path.
+ */
++ (NSString *)defaultStorePath;
+
+/**-----------------------------------------------------------------------------
+ * @name Creating Locations
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns the locations of a standard Homebrew installation at the specified
+ * prefix, whose executable, `Cellar` and repository are all inside the
+ * prefix. Nothing is read from the file system.
+ *
+ * @param prefixPath The prefix of the installation, such as `/usr/local`.
+ * @return The locations of the installation.
+ */
++ (instancetype)locationsWithPrefixPath:(NSString *)prefixPath;
+
+/** Returns an initialized `MRBrewLocations` object with the specified paths.
+ *
+ * @param brewPath The absolute path of the Homebrew executable.
+ * @param prefixPath The prefix formulae are linked into.
+ * @param cellarPath The directory formulae are installed into.
+ * @param repositoryPath The directory containing Homebrew's code and formulae.
+ * @param cachePath The directory downloads are cached in.
+ * @return Locations with the specified paths.
+ */
+- (instancetype)initWithBrewPath:(NSString *)brewPath prefixPath:(NSString *)prefixPath cellarPath:(NSString *)cellarPath repositoryPath:(NSString *)repositoryPath cachePath:(NSString *)cachePath;
+
+/**-----------------------------------------------------------------------------
+ * @name Accessing Library Locations
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns the path of the repository's `Library` directory. */
+- (NSString *)libraryPath;
+
+/** Returns the path of the directory containing the core formulae. */
+- (NSString *)formulaPath;
+
+/** Returns the path of the directory containing tapped repositories. */
+- (NSString *)tapsPath;
+
+/** Returns the path of the directory containing formula aliases. */
+- (NSString *)aliasesPath;
+
+/** Returns the path of the directory containing links to linked kegs. */
+- (NSString *)linkedKegsPath;
+
+/** Returns the path of the directory containing links to pinned kegs. */
+- (NSString *)pinnedKegsPath;
+
+@end
@@ -0,0 +1,392 @@
+//
+//  MRBrewLocations.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewLocations.h"
+
+#if defined(__linux__)
+static NSString * const MRBrewLocationsDefaultPrefixPath = @"/home/linuxbrew/.linuxbrew";
+#else
+static NSString * const MRBrewLocationsDefaultPrefixPath = @"/usr/local";
+#endif
+
+/* Keys of each installation's entry in the store. */
+static NSString * const MRBrewLocationsFileNumberKey = @"FileNumber";
+static NSString * const MRBrewLocationsModificationTimeKey = @"ModificationTime";
+static NSString * const MRBrewLocationsPrefixPathKey = @"PrefixPath";
+static NSString * const MRBrewLocationsCellarPathKey = @"CellarPath";
+static NSString * const MRBrewLocationsRepositoryPathKey = @"RepositoryPath";
+static NSString * const MRBrewLocationsCachePathKey = @"CachePath";
+static NSString * const MRBrewLocationsDependenciesKey = @"Dependencies";
+
+/* Keys of the values besides the executable that stored locations depend on. */
+static NSString * const MRBrewLocationsCacheEnvironmentKey = @"CacheEnvironment";
+static NSString * const MRBrewLocationsPrefixCellarKey = @"PrefixCellar";
+
+@implementation MRBrewLocations
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithBrewPath:(NSString *)brewPath prefixPath:(NSString *)prefixPath cellarPath:(NSString *)cellarPath repositoryPath:(NSString *)repositoryPath cachePath:(NSString *)cachePath
+{
+    if (self = [super init]) {
+        _brewPath = [brewPath copy];
+        _prefixPath = [prefixPath copy];
+        _cellarPath = [cellarPath copy];
+        _repositoryPath = [repositoryPath copy];
+        _cachePath = [cachePath copy];
+    }
+    
+    return self;
+}
+
++ (instancetype)locationsWithPrefixPath:(NSString *)prefixPath
+{
+    prefixPath = [prefixPath stringByStandardizingPath];
+    
+    return [[self alloc] initWithBrewPath:[prefixPath stringByAppendingPathComponent:@"bin/brew"]
+                               prefixPath:prefixPath
+                               cellarPath:[prefixPath stringByAppendingPathComponent:@"Cellar"]
+                           repositoryPath:prefixPath
+                                cachePath:[self defaultCachePath]];
+}
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    return self;
+}
+
+- (BOOL)isEqual:(id)object
+{
+    if (object == self) {
+        return YES;
+    }
+    if (![object isKindOfClass:[MRBrewLocations class]]) {
+        return NO;
+    }
+    
+    MRBrewLocations *locations = object;
+    return [[self brewPath] isEqualToString:[locations brewPath]] &&
+           [[self prefixPath] isEqualToString:[locations prefixPath]] &&
+           [[self cellarPath] isEqualToString:[locations cellarPath]] &&
+           [[self repositoryPath] isEqualToString:[locations repositoryPath]] &&
+           [[self cachePath] isEqualToString:[locations cachePath]];
+}
+
+- (NSUInteger)hash
+{
+    return [[self brewPath] hash] ^ [[self cellarPath] hash];
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p brew: %@ prefix: %@ cellar: %@ repository: %@ cache: %@>", [self class], self, [self brewPath], [self prefixPath], [self cellarPath], [self repositoryPath], [self cachePath]];
+}
+
+#pragma mark - Library Locations
+
+- (NSString *)libraryPath
+{
+    return [[self repositoryPath] stringByAppendingPathComponent:@"Library"];
+}
+
+- (NSString *)formulaPath
+{
+    return [[self libraryPath] stringByAppendingPathComponent:@"Formula"];
+}
+
+- (NSString *)tapsPath
+{
+    return [[self libraryPath] stringByAppendingPathComponent:@"Taps"];
+}
+
+- (NSString *)aliasesPath
+{
+    return [[self libraryPath] stringByAppendingPathComponent:@"Aliases"];
+}
+
+- (NSString *)linkedKegsPath
+{
+    return [[self libraryPath] stringByAppendingPathComponent:@"LinkedKegs"];
+}
+
+- (NSString *)pinnedKegsPath
+{
+    return [[self libraryPath] stringByAppendingPathComponent:@"PinnedKegs"];
+}
+
+#pragma mark - Discovery
+
++ (instancetype)defaultLocations
+{
+    static MRBrewLocations *locations = nil;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        NSString *brewPath = [self discoverBrewPath];
+        locations = brewPath ? [self locationsForBrewPath:brewPath] : nil;
+        if (!locations) {
+            locations = [self locationsWithPrefixPath:MRBrewLocationsDefaultPrefixPath];
+        }
+    });
+    
+    return locations;
+}
+
++ (NSString *)discoverBrewPath
+{
+    NSMutableArray *directories = [NSMutableArray array];
+    
+    NSString *searchPath = [[[NSProcessInfo processInfo] environment] objectForKey:@"PATH"];
+    for (NSString *directory in [searchPath componentsSeparatedByString:@":"]) {
+        if ([directory isAbsolutePath]) {
+            [directories addObject:directory];
+        }
+    }
+    
+    [directories addObjectsFromArray:@[@"/usr/local/bin",
+                                       @"/opt/homebrew/bin",
+                                       [NSHomeDirectory() stringByAppendingPathComponent:@"homebrew/bin"],
+                                       [NSHomeDirectory() stringByAppendingPathComponent:@".homebrew/bin"],
+                                       @"/home/linuxbrew/.linuxbrew/bin",
+                                       [NSHomeDirectory() stringByAppendingPathComponent:@".linuxbrew/bin"]]];
+    
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    for (NSString *directory in directories) {
+        NSString *brewPath = [directory stringByAppendingPathComponent:@"brew"];
+        BOOL isDirectory = NO;
+        if ([fileManager fileExistsAtPath:brewPath isDirectory:&isDirectory] && !isDirectory && [fileManager isExecutableFileAtPath:brewPath]) {
+            return brewPath;
+        }
+    }
+    
+    return nil;
+}
+
++ (instancetype)locationsForBrewPath:(NSString *)brewPath
+{
+    return [self locationsForBrewPath:brewPath storePath:[self defaultStorePath]];
+}
+
++ (instancetype)locationsForBrewPath:(NSString *)brewPath storePath:(NSString *)storePath
+{
+    brewPath = [brewPath stringByStandardizingPath];
+    
+    // the executable is identified by the file a symlink to it resolves to, so
+    // that an update replacing the file is noticed
+    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:[brewPath stringByResolvingSymlinksInPath] error:NULL];
+    if (!attributes) {
+        return nil;
+    }
+    
+    NSNumber *fileNumber = [attributes objectForKey:NSFileSystemFileNumber];
+    // dates lose their fractional seconds in a property list, so the time
+    // interval is stored instead
+    NSNumber *modificationTime = @([[attributes objectForKey:NSFileModificationDate] timeIntervalSinceReferenceDate]);
+    
+    @synchronized(self) {
+        NSDictionary *store = storePath ? [NSDictionary dictionaryWithContentsOfFile:storePath] : nil;
+        NSDictionary *entry = [store objectForKey:brewPath];
+        
+        // the Cellar and cache also depend on the file system and environment,
+        // which may have changed while the executable has not
+        if ([[entry objectForKey:MRBrewLocationsFileNumberKey] isEqual:fileNumber] &&
+            [[entry objectForKey:MRBrewLocationsModificationTimeKey] isEqual:modificationTime] &&
+            [[entry objectForKey:MRBrewLocationsDependenciesKey] isEqual:[self dependenciesForPrefixPath:[entry objectForKey:MRBrewLocationsPrefixPathKey]]]) {
+            MRBrewLocations *locations = [self locationsWithBrewPath:brewPath entry:entry];
+            if (locations) {
+                return locations;
+            }
+        }
+        
+        MRBrewLocations *locations = [self locationsFromLayoutForBrewPath:brewPath];
+        if (!locations) {
+            locations = [self locationsFromConfigurationForBrewPath:brewPath];
+        }
+        
+        if (locations && storePath) {
+            NSMutableDictionary *updatedStore = [NSMutableDictionary dictionaryWithDictionary:store];
+            [updatedStore setObject:@{MRBrewLocationsFileNumberKey: fileNumber,
+                                      MRBrewLocationsModificationTimeKey: modificationTime,
+                                      MRBrewLocationsPrefixPathKey: [locations prefixPath],
+                                      MRBrewLocationsCellarPathKey: [locations cellarPath],
+                                      MRBrewLocationsRepositoryPathKey: [locations repositoryPath],
+                                      MRBrewLocationsCachePathKey: [locations cachePath],
+                                      MRBrewLocationsDependenciesKey: [self dependenciesForPrefixPath:[locations prefixPath]]}
+                             forKey:brewPath];
+            
+            [[NSFileManager defaultManager] createDirectoryAtPath:[storePath stringByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:NULL];
+            [updatedStore writeToFile:storePath atomically:YES];
+        }
+        
+        return locations;
+    }
+}
+
++ (NSString *)defaultStorePath
+{
+    NSString *cachesPath = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) firstObject];
+    NSString *bundleIdentifier = [[NSBundle mainBundle] bundleIdentifier];
+    
+    return [[cachesPath stringByAppendingPathComponent:(bundleIdentifier ? bundleIdentifier : @"MRBrew")] stringByAppendingPathComponent:@"BrewLocations.plist"];
+}
+
+/* Returns the values, besides the executable, that the locations of an
+ * installation with the specified prefix are resolved from: the HOMEBREW_CACHE
+ * environment variable, and whether the prefix contains the Cellar.
+ */
++ (NSDictionary *)dependenciesForPrefixPath:(NSString *)prefixPath
+{
+    NSString *cacheEnvironment = [[[NSProcessInfo processInfo] environment] objectForKey:@"HOMEBREW_CACHE"];
+    
+    BOOL isDirectory = NO;
+    BOOL hasPrefixCellar = prefixPath && [[NSFileManager defaultManager] fileExistsAtPath:[prefixPath stringByAppendingPathComponent:@"Cellar"] isDirectory:&isDirectory] && isDirectory;
+    
+    return @{MRBrewLocationsCacheEnvironmentKey: (cacheEnvironment ? cacheEnvironment : @""),
+             MRBrewLocationsPrefixCellarKey: @(hasPrefixCellar)};
+}
+
+/* Returns locations from a store entry, or nil if the entry is incomplete. */
++ (instancetype)locationsWithBrewPath:(NSString *)brewPath entry:(NSDictionary *)entry
+{
+    NSString *prefixPath = [entry objectForKey:MRBrewLocationsPrefixPathKey];
+    NSString *cellarPath = [entry objectForKey:MRBrewLocationsCellarPathKey];
+    NSString *repositoryPath = [entry objectForKey:MRBrewLocationsRepositoryPathKey];
+    NSString *cachePath = [entry objectForKey:MRBrewLocationsCachePathKey];
+    if (!prefixPath || !cellarPath || !repositoryPath || !cachePath) {
+        return nil;
+    }
+    
+    return [[self alloc] initWithBrewPath:brewPath prefixPath:prefixPath cellarPath:cellarPath repositoryPath:repositoryPath cachePath:cachePath];
+}
+
+/* Resolves the locations of an installation the way Homebrew does at startup:
+ * the repository contains the file the executable resolves to, the prefix
+ * contains the executable as it was found, and the Cellar is in the prefix if
+ * it exists there and in the repository otherwise. Returns nil if the
+ * repository is not laid out as expected.
+ */
++ (instancetype)locationsFromLayoutForBrewPath:(NSString *)brewPath
+{
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSString *repositoryPath = [[[brewPath stringByResolvingSymlinksInPath] stringByDeletingLastPathComponent] stringByDeletingLastPathComponent];
+    NSString *prefixPath = [[brewPath stringByDeletingLastPathComponent] stringByDeletingLastPathComponent];
+    
+    BOOL isDirectory = NO;
+    if (![fileManager fileExistsAtPath:[repositoryPath stringByAppendingPathComponent:@"Library/Homebrew"] isDirectory:&isDirectory] || !isDirectory) {
+        return nil;
+    }
+    
+    NSString *cellarPath = [prefixPath stringByAppendingPathComponent:@"Cellar"];
+    if (![fileManager fileExistsAtPath:cellarPath isDirectory:&isDirectory] || !isDirectory) {
+        cellarPath = [repositoryPath stringByAppendingPathComponent:@"Cellar"];
+    }
+    
+    return [[self alloc] initWithBrewPath:brewPath prefixPath:prefixPath cellarPath:cellarPath repositoryPath:repositoryPath cachePath:[self defaultCachePath]];
+}
+
+/* Runs `brew --config` and reads the locations from the configuration it
+ * prints. Homebrew omits the repository and Cellar when they have their
+ * default values, so these are derived from the prefix when missing.
+ */
++ (instancetype)locationsFromConfigurationForBrewPath:(NSString *)brewPath
+{
+    NSTask *task = [[NSTask alloc] init];
+    NSPipe *pipe = [NSPipe pipe];
+    [task setLaunchPath:brewPath];
+    [task setArguments:@[@"--config"]];
+    [task setStandardOutput:pipe];
+    [task setStandardError:[NSFileHandle fileHandleWithNullDevice]];
+    
+    NSData *output = nil;
+    @try {
+        [task launch];
+        output = [[pipe fileHandleForReading] readDataToEndOfFile];
+        [task waitUntilExit];
+    }
+    @catch (NSException *exception) {
+        NSLog(@"MRBrewLocations: Unable to run %@ (%@: %@)", brewPath, [exception name], exception);
+        return nil;
+    }
+    
+    if ([task terminationStatus] != 0) {
+        return nil;
+    }
+    
+    NSMutableDictionary *configuration = [NSMutableDictionary dictionary];
+    NSString *outputString = [[NSString alloc] initWithData:output encoding:NSUTF8StringEncoding];
+    for (NSString *line in [outputString componentsSeparatedByString:@"\n"]) {
+        NSRange separator = [line rangeOfString:@": "];
+        if (separator.location != NSNotFound) {
+            [configuration setObject:[line substringFromIndex:NSMaxRange(separator)] forKey:[line substringToIndex:separator.location]];
+        }
+    }
+    
+    NSString *prefixPath = [configuration objectForKey:@"HOMEBREW_PREFIX"];
+    if (!prefixPath) {
+        return nil;
+    }
+    
+    NSString *repositoryPath = [configuration objectForKey:@"HOMEBREW_REPOSITORY"];
+    NSString *cellarPath = [configuration objectForKey:@"HOMEBREW_CELLAR"];
+    NSString *cachePath = [configuration objectForKey:@"HOMEBREW_CACHE"];
+    
+    return [[self alloc] initWithBrewPath:brewPath
+                               prefixPath:prefixPath
+                               cellarPath:(cellarPath ? cellarPath : [prefixPath stringByAppendingPathComponent:@"Cellar"])
+                           repositoryPath:(repositoryPath ? repositoryPath : prefixPath)
+                                cachePath:(cachePath ? cachePath : [self defaultCachePath])];
+}
+
+/* Homebrew caches downloads in the user's caches directory if it can write
+ * there, and in the system caches directory otherwise, unless overridden by
+ * the HOMEBREW_CACHE environment variable. Linuxbrew uses the XDG cache
+ * directory, `~/.cache` unless overridden by XDG_CACHE_HOME.
+ */
++ (NSString *)defaultCachePath
+{
+    NSDictionary *environment = [[NSProcessInfo processInfo] environment];
+    NSString *cachePath = [environment objectForKey:@"HOMEBREW_CACHE"];
+    if (cachePath) {
+        return cachePath;
+    }
+    
+#if defined(__linux__)
+    NSString *xdgCachePath = [environment objectForKey:@"XDG_CACHE_HOME"];
+    if (!xdgCachePath) {
+        xdgCachePath = [NSHomeDirectory() stringByAppendingPathComponent:@".cache"];
+    }
+    
+    return [xdgCachePath stringByAppendingPathComponent:@"Homebrew"];
+#else
+    NSString *userCachesPath = [NSHomeDirectory() stringByAppendingPathComponent:@"Library/Caches"];
+    if ([[NSFileManager defaultManager] isWritableFileAtPath:userCachesPath]) {
+        return [userCachesPath stringByAppendingPathComponent:@"Homebrew"];
+    }
+    
+    return @"/Library/Caches/Homebrew";
+#endif
+}
+
+@end
@@ -97,6 +97,21 @@ typedef NS_ENUM(NSInteger, MRBrewOperationType) {
  */
 @property (copy) NSArray *parameters;
 
+/** Environment variables to set for this operation only.
+ *
+ * When the operation is performed these variables are merged with the
+ * environment of the `MRBrew` instance performing it (or, if that instance has
+ * no environment set, the environment of the current process). A value
+ * replaces any variable of the same name, and an `NSNull` value removes the
+ * variable. Operations with different environments can run concurrently.
+ */
+@property (copy) NSDictionary *environment;
+
+/** The directory in which the operation is performed, or `nil` to use the
+ * current directory of the process.
+ */
+@property (copy) NSString *workingDirectory;
+
 /**-----------------------------------------------------------------------------
  * @name Initialising an Operation
  * -----------------------------------------------------------------------------
@@ -192,6 +207,23 @@ typedef NS_ENUM(NSInteger, MRBrewOperationType) {
  */
 + (instancetype)infoOperation:(MRBrewFormula *)formula;
 
+/** Returns an info operation that describes the specified formulae as JSON.
+ *
+ * A single invocation of brew describes every formula, and the output can be
+ * parsed by `MRBrewOutputParser` into `MRBrewFormula` objects with their
+ * versions, installed kegs, dependencies, options, and pinned and outdated
+ * states populated.
+ *
+ * @param formulae An array of `MRBrewFormula` objects.
+ */
++ (instancetype)infoOperationForFormulae:(NSArray *)formulae;
+
+/** Returns an info operation that describes all installed formulae as JSON.
+ *
+ * See infoOperationForFormulae: for details.
+ */
++ (instancetype)installedInfoOperation;
+
 /** Returns a remove operation with the specified formula.
  *
  * @param formula The formula.
@@ -207,6 +239,35 @@ typedef NS_ENUM(NSInteger, MRBrewOperationType) {
 /** Returns an outdated operation. */
 + (instancetype)outdatedOperation;
 
+/** Returns an outdated operation whose output lists the installed versions of
+ * each outdated formula, the version available to upgrade to, and whether the
+ * formula is pinned.
+ *
+ * The output can be parsed by `MRBrewOutputParser`, or read as it is generated
+ * by an `MRBrewOutdatedReader`.
+ */
++ (instancetype)verboseOutdatedOperation;
+
+/** Returns an outdated operation that describes each outdated formula as JSON.
+ *
+ * See verboseOutdatedOperation for details.
+ */
++ (instancetype)outdatedJSONOperation;
+
+/**-----------------------------------------------------------------------------
+* @name Describing Operations
+* -----------------------------------------------------------------------------
+*/
+
+/** Returns whether the operation only reads from the Homebrew installation.
+ *
+ * List, search, info, options and outdated operations are read-only. Any other
+ * operation (e.g. install, remove or update) may modify the installation.
+ *
+ * @return YES if the operation does not modify the installation, otherwise NO.
+ */
+- (BOOL)isReadOnly;
+
 /**-----------------------------------------------------------------------------
 * @name Comparing Operations
 * -----------------------------------------------------------------------------
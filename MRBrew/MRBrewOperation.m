@@ -118,6 +118,21 @@
     return [[self alloc] initWithType:MRBrewOperationInfo formula:formula parameters:nil];
 }
 
++ (instancetype)infoOperationForFormulae:(NSArray *)formulae
+{
+    NSMutableArray *parameters = [NSMutableArray arrayWithObject:MRBrewOperationJSONInfoParameter];
+    for (MRBrewFormula *formula in formulae) {
+        [parameters addObject:[formula name]];
+    }
+    
+    return [[self alloc] initWithType:MRBrewOperationInfo formula:nil parameters:parameters];
+}
+
++ (instancetype)installedInfoOperation
+{
+    return [[self alloc] initWithType:MRBrewOperationInfo formula:nil parameters:@[MRBrewOperationJSONInfoParameter, @"--installed"]];
+}
+
 + (instancetype)removeOperation:(MRBrewFormula *)formula
 {
     return [[self alloc] initWithType:MRBrewOperationRemove formula:formula parameters:nil];
@@ -133,6 +148,33 @@
     return [[self alloc] initWithType:MRBrewOperationOutdated formula:nil parameters:nil];
 }
 
++ (instancetype)verboseOutdatedOperation
+{
+    return [[self alloc] initWithType:MRBrewOperationOutdated formula:nil parameters:@[@"--verbose"]];
+}
+
++ (instancetype)outdatedJSONOperation
+{
+    return [[self alloc] initWithType:MRBrewOperationOutdated formula:nil parameters:@[MRBrewOperationJSONInfoParameter]];
+}
+
+#pragma mark - Describing
+
+- (BOOL)isReadOnly
+{
+    static NSSet *readOnlyNames = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        readOnlyNames = [NSSet setWithObjects:MRBrewOperationListIdentifier,
+                                              MRBrewOperationSearchIdentifier,
+                                              MRBrewOperationInfoIdentifier,
+                                              MRBrewOperationOptionsIdentifier,
+                                              MRBrewOperationOutdatedIdentifier, nil];
+    });
+    
+    return [readOnlyNames containsObject:[self name]];
+}
+
 #pragma mark - Equality
 
 - (BOOL)isEqualToOperation:(MRBrewOperation *)operation
@@ -164,6 +206,11 @@
         return NO;
     }
     
+    if ([self environment] != [operation environment] && ![[self environment] isEqualToDictionary:[operation environment]])
+        return NO;
+    if ([self workingDirectory] != [operation workingDirectory] && ![[self workingDirectory] isEqualToString:[operation workingDirectory]])
+        return NO;
+    
     return YES;
 }
 
@@ -175,6 +222,8 @@
     [copy setName:[[self name] copy]];
     [copy setFormula:[[self formula] copy]];
     [copy setParameters:[[self parameters] copy]];
+    [copy setEnvironment:[self environment]];
+    [copy setWorkingDirectory:[self workingDirectory]];
     
     return copy;
 }
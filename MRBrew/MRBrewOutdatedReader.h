@@ -0,0 +1,98 @@
+//
+//  MRBrewOutdatedReader.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+@class MRBrewFormula;
+
+/** These constants indicate the form of an outdated operation's output. */
+typedef NS_ENUM(NSInteger, MRBrewOutdatedFormat) {
+    /** One formula per line, either a name alone or, with `--verbose`, a name
+     * followed by its installed versions and the available version.
+     */
+    MRBrewOutdatedFormatText,
+    /** A JSON array of formulae, produced with `--json=v1`. */
+    MRBrewOutdatedFormatJSON
+};
+
+/** The block type used to deliver each formula as soon as it has been read.
+ *
+ * @param formula An outdated formula.
+ */
+typedef void (^MRBrewOutdatedReaderHandler)(MRBrewFormula *formula);
+
+/** An `MRBrewOutdatedReader` object builds `MRBrewFormula` objects from the
+ * output of an outdated operation created with `MRBrewOperation`'s
+ * outdatedOperation, verboseOutdatedOperation or outdatedJSONOperation
+ * methods.
+ *
+ * Each formula has its isInstalled and isOutdated properties set, and where the
+ * output provides them, its installedVersions, availableVersion and isPinned
+ * properties.
+ *
+ * Output can be read in chunks as it is generated. Each formula is built as
+ * soon as the output describing it is complete and passed to the reader's
+ * handler, so an upgrade plan can be acted on before brew has finished. Only
+ * the bytes of an incomplete line or token are retained between chunks.
+ */
+@interface MRBrewOutdatedReader : NSObject
+
+/** A block called with each formula as soon as it has been read, or `nil`. The
+ * block is called on the thread that calls readData: or finishReading.
+ */
+@property (copy) MRBrewOutdatedReaderHandler handler;
+
+/** Returns an initialized `MRBrewOutdatedReader` object for output of the
+ * specified format.
+ *
+ * @param format The format of the output.
+ * @return A reader for the specified format.
+ */
+- (instancetype)initWithFormat:(MRBrewOutdatedFormat)format;
+
+/** Returns an array of formulae read from the specified output.
+ *
+ * @param data The complete output of an outdated operation.
+ * @param format The format of the output.
+ * @return An array of `MRBrewFormula` objects, or `nil` if the output is
+ * malformed.
+ */
++ (NSArray *)formulaeFromData:(NSData *)data format:(MRBrewOutdatedFormat)format;
+
+/** Reads the next chunk of output.
+ *
+ * @param data The output following that passed to the previous call.
+ * @return `NO` if the output is malformed, otherwise `YES`.
+ */
+- (BOOL)readData:(NSData *)data;
+
+/** Indicates that all of the output has been read.
+ *
+ * @return An array of `MRBrewFormula` objects, or `nil` if the output is
+ * malformed or incomplete.
+ */
+- (NSArray *)finishReading;
+
+@end
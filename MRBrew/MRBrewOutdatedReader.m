@@ -0,0 +1,377 @@
+//
+//  MRBrewOutdatedReader.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewOutdatedReader.h"
+#import "MRBrewJSONParser.h"
+#import "MRBrewFormula.h"
+#import "MRBrewFormula+Private.h"
+
+/* The members of a formula's JSON object that are read. */
+typedef NS_ENUM(NSInteger, MRBrewOutdatedMember) {
+    MRBrewOutdatedMemberNone,
+    MRBrewOutdatedMemberName,
+    MRBrewOutdatedMemberInstalledVersions,
+    MRBrewOutdatedMemberCurrentVersion,
+    MRBrewOutdatedMemberPinned
+};
+
+/* Nesting depths of the JSON elements that are read: the top level array of
+ * formulae, each formula object, and the elements of its installed versions
+ * array.
+ */
+enum {
+    MRBrewOutdatedDepthFormula = 2,
+    MRBrewOutdatedDepthMember = 3
+};
+
+static inline NSString * MRBrewOutdatedString(const char *bytes, NSUInteger length)
+{
+    return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+}
+
+/* Returns the number of bytes before the first occurrence of any of the
+ * specified delimiters, or length if none occurs.
+ */
+static inline NSUInteger MRBrewOutdatedTokenLength(const char *bytes, NSUInteger length, const char *delimiters)
+{
+    NSUInteger i = 0;
+    while (i < length && !strchr(delimiters, bytes[i])) {
+        i++;
+    }
+    
+    return i;
+}
+
+static inline NSUInteger MRBrewOutdatedSkipSpaces(const char *bytes, NSUInteger length, NSUInteger position)
+{
+    while (position < length && bytes[position] == ' ') {
+        position++;
+    }
+    
+    return position;
+}
+
+@interface MRBrewOutdatedReader () <MRBrewJSONParserDelegate>
+{
+    @private
+    MRBrewOutdatedFormat _format;
+    MRBrewJSONParser *_parser;
+    NSMutableData *_pending;
+    NSMutableArray *_formulae;
+    BOOL _failed;
+    NSUInteger _depth;
+    MRBrewOutdatedMember _member;
+    MRBrewFormula *_formula;
+    NSMutableArray *_installedVersions;
+}
+
+@end
+
+@implementation MRBrewOutdatedReader
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    return [self initWithFormat:MRBrewOutdatedFormatText];
+}
+
+- (instancetype)initWithFormat:(MRBrewOutdatedFormat)format
+{
+    if (self = [super init]) {
+        _format = format;
+        _formulae = [NSMutableArray array];
+        
+        if (format == MRBrewOutdatedFormatJSON) {
+            _parser = [[MRBrewJSONParser alloc] initWithDelegate:self];
+        }
+        else {
+            _pending = [NSMutableData data];
+        }
+    }
+    
+    return self;
+}
+
++ (NSArray *)formulaeFromData:(NSData *)data format:(MRBrewOutdatedFormat)format
+{
+    MRBrewOutdatedReader *reader = [[self alloc] initWithFormat:format];
+    if (![reader readData:data]) {
+        return nil;
+    }
+    
+    return [reader finishReading];
+}
+
+#pragma mark - Reading
+
+- (BOOL)readData:(NSData *)data
+{
+    if (_failed) {
+        return NO;
+    }
+    
+    if (_format == MRBrewOutdatedFormatJSON) {
+        _failed = ![_parser parseData:data];
+    }
+    else {
+        _failed = ![self readLinesInBytes:[data bytes] length:[data length]];
+    }
+    
+    return !_failed;
+}
+
+- (NSArray *)finishReading
+{
+    if (_failed) {
+        return nil;
+    }
+    
+    if (_format == MRBrewOutdatedFormatJSON) {
+        _failed = ![_parser finish];
+    }
+    else if ([_pending length]) {
+        _failed = ![self readLine:[_pending bytes] length:[_pending length]];
+        [_pending setLength:0];
+    }
+    
+    return _failed ? nil : [NSArray arrayWithArray:_formulae];
+}
+
+- (void)addFormula:(MRBrewFormula *)formula
+{
+    [_formulae addObject:formula];
+    
+    MRBrewOutdatedReaderHandler handler = [self handler];
+    if (handler) {
+        handler(formula);
+    }
+}
+
+#pragma mark - Text Parsing (private)
+
+/* Reads each complete line in the specified bytes, retaining an incomplete
+ * final line until the rest of it is read.
+ */
+- (BOOL)readLinesInBytes:(const char *)bytes length:(NSUInteger)length
+{
+    if (length == 0) {
+        return YES;
+    }
+    
+    NSUInteger lineStart = 0;
+    const char *newline;
+    
+    while ((newline = memchr(bytes + lineStart, '\n', length - lineStart))) {
+        NSUInteger lineLength = newline - (bytes + lineStart);
+        BOOL lineRead;
+        
+        if ([_pending length]) {
+            [_pending appendBytes:bytes + lineStart length:lineLength];
+            lineRead = [self readLine:[_pending bytes] length:[_pending length]];
+            [_pending setLength:0];
+        }
+        else {
+            lineRead = [self readLine:bytes + lineStart length:lineLength];
+        }
+        
+        if (!lineRead) {
+            return NO;
+        }
+        
+        lineStart += lineLength + 1;
+    }
+    
+    [_pending appendBytes:bytes + lineStart length:length - lineStart];
+    
+    return YES;
+}
+
+/* Reads a line of the form "name" or, for verbose output, one of the forms
+ * "name (1.0, 1.1) < 1.2" and "name (1.1) != 1.2", optionally followed by
+ * "[pinned at 1.1]".
+ */
+- (BOOL)readLine:(const char *)bytes length:(NSUInteger)length
+{
+    while (length > 0 && (bytes[length - 1] == ' ' || bytes[length - 1] == '\r')) {
+        length--;
+    }
+    
+    if (length == 0) {
+        return YES;
+    }
+    
+    NSUInteger position = MRBrewOutdatedTokenLength(bytes, length, " ");
+    if (position == 0) {
+        return NO;
+    }
+    
+    MRBrewFormula *formula = [[MRBrewFormula alloc] init];
+    [formula setName:MRBrewOutdatedString(bytes, position)];
+    [formula setIsInstalled:YES];
+    [formula setIsOutdated:YES];
+    
+    position = MRBrewOutdatedSkipSpaces(bytes, length, position);
+    
+    if (position < length) {
+        if (bytes[position] != '(') {
+            return NO;
+        }
+        
+        // installed versions
+        NSMutableArray *installedVersions = [NSMutableArray array];
+        position++;
+        
+        while (YES) {
+            position = MRBrewOutdatedSkipSpaces(bytes, length, position);
+            NSUInteger versionLength = MRBrewOutdatedTokenLength(bytes + position, length - position, ",)");
+            if (position + versionLength >= length) {
+                return NO;
+            }
+            
+            [installedVersions addObject:MRBrewOutdatedString(bytes + position, versionLength)];
+            position += versionLength + 1;
+            
+            if (bytes[position - 1] == ')') {
+                break;
+            }
+        }
+        
+        [formula setInstalledVersions:installedVersions];
+        
+        // comparison operator and available version
+        position = MRBrewOutdatedSkipSpaces(bytes, length, position);
+        position += MRBrewOutdatedTokenLength(bytes + position, length - position, " ");
+        position = MRBrewOutdatedSkipSpaces(bytes, length, position);
+        
+        NSUInteger versionLength = MRBrewOutdatedTokenLength(bytes + position, length - position, " ");
+        if (versionLength > 0) {
+            [formula setAvailableVersion:MRBrewOutdatedString(bytes + position, versionLength)];
+        }
+        
+        position = MRBrewOutdatedSkipSpaces(bytes, length, position + versionLength);
+        
+        static const char pinnedPrefix[] = "[pinned at ";
+        if (length - position >= sizeof(pinnedPrefix) - 1 && memcmp(bytes + position, pinnedPrefix, sizeof(pinnedPrefix) - 1) == 0) {
+            [formula setIsPinned:YES];
+        }
+    }
+    
+    [self addFormula:formula];
+    
+    return YES;
+}
+
+#pragma mark - MRBrewJSONParserDelegate protocol
+
+- (void)parserDidStartObject:(MRBrewJSONParser *)parser
+{
+    _depth++;
+    
+    if (_depth == MRBrewOutdatedDepthFormula) {
+        _formula = [[MRBrewFormula alloc] init];
+        [_formula setIsInstalled:YES];
+        [_formula setIsOutdated:YES];
+        _member = MRBrewOutdatedMemberNone;
+        _installedVersions = [NSMutableArray array];
+    }
+}
+
+- (void)parserDidEndObject:(MRBrewJSONParser *)parser
+{
+    if (_depth == MRBrewOutdatedDepthFormula && _formula) {
+        [_formula setInstalledVersions:_installedVersions];
+        [self addFormula:_formula];
+        _formula = nil;
+    }
+    
+    _depth--;
+}
+
+- (void)parserDidStartArray:(MRBrewJSONParser *)parser
+{
+    _depth++;
+}
+
+- (void)parserDidEndArray:(MRBrewJSONParser *)parser
+{
+    _depth--;
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundKey:(NSString *)key
+{
+    _member = MRBrewOutdatedMemberNone;
+    
+    if (_depth == MRBrewOutdatedDepthFormula) {
+        if ([key isEqualToString:@"name"]) {
+            _member = MRBrewOutdatedMemberName;
+        }
+        else if ([key isEqualToString:@"installed_versions"]) {
+            _member = MRBrewOutdatedMemberInstalledVersions;
+        }
+        else if ([key isEqualToString:@"current_version"]) {
+            _member = MRBrewOutdatedMemberCurrentVersion;
+        }
+        else if ([key isEqualToString:@"pinned"]) {
+            _member = MRBrewOutdatedMemberPinned;
+        }
+    }
+    
+    if (_member == MRBrewOutdatedMemberNone) {
+        [parser skipNextValue];
+    }
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundString:(NSString *)string
+{
+    if (_depth == MRBrewOutdatedDepthFormula) {
+        if (_member == MRBrewOutdatedMemberName) {
+            [_formula setName:string];
+        }
+        else if (_member == MRBrewOutdatedMemberCurrentVersion) {
+            [_formula setAvailableVersion:string];
+        }
+    }
+    else if (_depth == MRBrewOutdatedDepthMember && _member == MRBrewOutdatedMemberInstalledVersions) {
+        [_installedVersions addObject:string];
+    }
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundBool:(BOOL)value
+{
+    if (_depth == MRBrewOutdatedDepthFormula && _member == MRBrewOutdatedMemberPinned) {
+        [_formula setIsPinned:value];
+    }
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundNumber:(NSNumber *)number
+{
+}
+
+- (void)parserFoundNull:(MRBrewJSONParser *)parser
+{
+}
+
+@end
@@ -0,0 +1,138 @@
+//
+//  MRBrewOutdatedScanner.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+@class MRBrewOperation;
+@class MRBrewLocations;
+
+/** An `MRBrewOutdatedScanner` object determines which installed formulae are
+ * outdated without running `brew outdated`.
+ *
+ * The scanner compares the versions of each formula installed in the `Cellar`
+ * with the version described by the formula's source in `Library/Formula`, or
+ * in a tap under `Library/Taps`, using Homebrew's version ordering (see
+ * MRBrewVersion). A formula is outdated when none of its installed versions is
+ * as new as the version its source describes, including the formula's
+ * revision. Formulae whose source cannot be found or whose version cannot be
+ * determined, and formulae installed from `HEAD`, are never reported as
+ * outdated.
+ *
+ * Formulae are compared concurrently, and no Ruby code is run, so a scan costs
+ * a few directory reads and the parsing of one source file per installed
+ * formula.
+ *
+ * Assign a scanner to `MRBrew`'s outdatedScanner property to have outdated
+ * operations with plain or verbose output answered by the scanner instead of
+ * by Homebrew.
+ */
+@interface MRBrewOutdatedScanner : NSObject
+
+/** The locations of the Homebrew installation that is scanned. */
+@property (readonly, copy) MRBrewLocations *locations;
+
+/** The prefix of the Homebrew installation that is scanned, such as
+ * `/usr/local`.
+ */
+@property (readonly, copy) NSString *prefix;
+
+/**-----------------------------------------------------------------------------
+ * @name Creating a Scanner
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns an initialized `MRBrewOutdatedScanner` object for the Homebrew
+ * installation described by `MRBrewLocations`' defaultLocations.
+ *
+ * @return A scanner for the default installation.
+ */
+- (instancetype)init;
+
+/** Returns an initialized `MRBrewOutdatedScanner` object for the Homebrew
+ * installation at the specified locations.
+ *
+ * @param locations The locations of the installation to scan.
+ * @return A scanner for the specified installation.
+ */
+- (instancetype)initWithLocations:(MRBrewLocations *)locations;
+
+/** Returns an initialized `MRBrewOutdatedScanner` object for a standard
+ * Homebrew installation at the specified prefix.
+ *
+ * @param prefix The absolute path of the directory containing Homebrew's
+ * `Cellar` and `Library` directories.
+ * @return A scanner for the specified prefix.
+ */
+- (instancetype)initWithPrefix:(NSString *)prefix;
+
+/**-----------------------------------------------------------------------------
+ * @name Scanning
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns the outdated formulae among those installed.
+ *
+ * Each formula has its isInstalled, isOutdated, installedVersions,
+ * availableVersion and isPinned properties set, as they are by
+ * `MRBrewOutdatedReader`.
+ *
+ * @param names The names of the formulae to check, or `nil` to check every
+ * installed formula.
+ * @return An array of `MRBrewFormula` objects ordered by name.
+ */
+- (NSArray *)outdatedFormulaeWithNames:(NSArray *)names;
+
+/** Returns the version described by a formula's source, including its
+ * revision if it has one, such as `1.15` or `2.0_1`.
+ *
+ * The version is read from the formula's `version` statement if it has one,
+ * and otherwise detected from its `url`. Only the stable specification is
+ * read; `devel` and `head` specifications are ignored.
+ *
+ * @param path The path of the formula's Ruby source file.
+ * @return The formula's version, or `nil` if it cannot be determined.
+ */
+- (NSString *)versionOfFormulaAtPath:(NSString *)path;
+
+/** Indicates whether the receiver can produce the output of the specified
+ * operation, which is true for outdated operations that do not request JSON
+ * output.
+ *
+ * @param operation An operation.
+ * @return `YES` if outputForOperation: supports the operation, otherwise `NO`.
+ */
+- (BOOL)canProduceOutputForOperation:(MRBrewOperation *)operation;
+
+/** Returns the output `brew outdated` would print for the specified operation:
+ * the name of each outdated formula on its own line or, if the operation has
+ * the `--verbose` parameter, each name followed by its installed and available
+ * versions.
+ *
+ * @param operation An outdated operation.
+ * @return The output of the operation.
+ */
+- (NSData *)outputForOperation:(MRBrewOperation *)operation;
+
+@end
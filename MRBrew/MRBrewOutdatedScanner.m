@@ -0,0 +1,357 @@
+//
+//  MRBrewOutdatedScanner.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewOutdatedScanner.h"
+#import "MRBrewOperation.h"
+#import "MRBrewConstants.h"
+#import "MRBrewFormula.h"
+#import "MRBrewFormula+Private.h"
+#import "MRBrewSnapshot.h"
+#import "MRBrewVersion.h"
+#import "MRBrewLocations.h"
+
+/* Returns the first word of a line of Ruby, such as `url` or `def`. */
+static NSString *MRBrewFirstWord(NSString *line)
+{
+    NSRange separator = [line rangeOfCharacterFromSet:[NSCharacterSet characterSetWithCharactersInString:@" \t(;"]];
+    
+    return separator.location == NSNotFound ? line : [line substringToIndex:separator.location];
+}
+
+/* Returns the contents of the first string literal in a line of Ruby, such as
+ * the URL of `url "https://example.com/foo-1.0.tar.gz", :using => :curl`.
+ */
+static NSString *MRBrewFirstStringLiteral(NSString *line)
+{
+    NSRange open = [line rangeOfCharacterFromSet:[NSCharacterSet characterSetWithCharactersInString:@"\"'"]];
+    if (open.location == NSNotFound) {
+        return nil;
+    }
+    
+    NSString *quote = [line substringWithRange:open];
+    NSRange close = [line rangeOfString:quote options:0 range:NSMakeRange(NSMaxRange(open), [line length] - NSMaxRange(open))];
+    if (close.location == NSNotFound) {
+        return nil;
+    }
+    
+    return [line substringWithRange:NSMakeRange(NSMaxRange(open), close.location - NSMaxRange(open))];
+}
+
+/* Returns the terminator of a heredoc opened on a line of Ruby, such as `EOS`
+ * for `<<-EOS.undent`, or nil if the line does not open one.
+ */
+static NSString *MRBrewHeredocTerminator(NSString *line)
+{
+    NSRange opener = [line rangeOfString:@"<<-"];
+    if (opener.location == NSNotFound) {
+        opener = [line rangeOfString:@"<<~"];
+    }
+    if (opener.location == NSNotFound) {
+        return nil;
+    }
+    
+    NSScanner *scanner = [NSScanner scannerWithString:[line substringFromIndex:NSMaxRange(opener)]];
+    [scanner setCharactersToBeSkipped:[NSCharacterSet characterSetWithCharactersInString:@"'\""]];
+    
+    NSMutableCharacterSet *identifierCharacters = [NSMutableCharacterSet alphanumericCharacterSet];
+    [identifierCharacters addCharactersInString:@"_"];
+    
+    NSString *terminator = nil;
+    [scanner scanCharactersFromSet:identifierCharacters intoString:&terminator];
+    
+    return terminator;
+}
+
+@implementation MRBrewOutdatedScanner
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    return [self initWithLocations:[MRBrewLocations defaultLocations]];
+}
+
+- (instancetype)initWithLocations:(MRBrewLocations *)locations
+{
+    if (self = [super init]) {
+        _locations = [locations copy];
+    }
+    
+    return self;
+}
+
+- (instancetype)initWithPrefix:(NSString *)prefix
+{
+    return [self initWithLocations:[MRBrewLocations locationsWithPrefixPath:prefix]];
+}
+
+- (NSString *)prefix
+{
+    return [[self locations] prefixPath];
+}
+
+#pragma mark - Scanning
+
+- (NSArray *)outdatedFormulaeWithNames:(NSArray *)names
+{
+    MRBrewLocations *locations = [self locations];
+    MRBrewSnapshot *snapshot = [MRBrewSnapshot snapshotWithCellarPath:[locations cellarPath]
+                                                       linkedKegsPath:[locations linkedKegsPath]
+                                                       pinnedKegsPath:[locations pinnedKegsPath]];
+    [snapshot reload];
+    
+    NSMutableArray *formulaNames = [NSMutableArray array];
+    for (NSString *name in (names ? names : [[snapshot installedFormulaNames] allObjects])) {
+        if ([snapshot versionsForFormula:name]) {
+            [formulaNames addObject:name];
+        }
+    }
+    [formulaNames sortUsingSelector:@selector(compare:)];
+    
+    // installed state and formula locations are gathered up front so that the
+    // concurrent part of the scan reads only the formula sources
+    NSMutableArray *installedVersions = [NSMutableArray arrayWithCapacity:[formulaNames count]];
+    NSMutableArray *pinnedVersions = [NSMutableArray arrayWithCapacity:[formulaNames count]];
+    for (NSString *name in formulaNames) {
+        [installedVersions addObject:[[[snapshot versionsForFormula:name] allObjects] sortedArrayUsingComparator:^NSComparisonResult(NSString *version, NSString *otherVersion) {
+            return [MRBrewVersion compareVersion:version toVersion:otherVersion];
+        }]];
+        
+        NSString *pinnedVersion = [snapshot isFormulaPinned:name] ? [self pinnedVersionOfFormula:name] : nil;
+        [pinnedVersions addObject:(pinnedVersion ? pinnedVersion : [NSNull null])];
+    }
+    
+    NSDictionary *tapFormulaPaths = [self tapFormulaPaths];
+    NSString *formulaPath = [locations formulaPath];
+    
+    NSMutableArray *results = [NSMutableArray arrayWithCapacity:[formulaNames count]];
+    for (NSUInteger i = 0; i < [formulaNames count]; i++) {
+        [results addObject:[NSNull null]];
+    }
+    
+    dispatch_apply([formulaNames count], dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        @autoreleasepool {
+            NSString *name = [formulaNames objectAtIndex:i];
+            NSArray *versions = [installedVersions objectAtIndex:i];
+            
+            NSString *path = [formulaPath stringByAppendingPathComponent:[name stringByAppendingPathExtension:@"rb"]];
+            if (![[NSFileManager defaultManager] fileExistsAtPath:path]) {
+                path = [tapFormulaPaths objectForKey:name];
+            }
+            
+            NSString *availableVersion = path ? [self versionOfFormulaAtPath:path] : nil;
+            if (!availableVersion || ![self isOutdatedWithInstalledVersions:versions availableVersion:availableVersion]) {
+                return;
+            }
+            
+            id pinnedVersion = [pinnedVersions objectAtIndex:i];
+            
+            MRBrewFormula *formula = [[MRBrewFormula alloc] init];
+            [formula setName:name];
+            [formula setIsInstalled:YES];
+            [formula setIsOutdated:YES];
+            [formula setInstalledVersions:versions];
+            [formula setAvailableVersion:availableVersion];
+            [formula setIsPinned:(pinnedVersion != [NSNull null])];
+            
+            @synchronized(results) {
+                [results replaceObjectAtIndex:i withObject:formula];
+            }
+        }
+    });
+    
+    [results removeObjectIdenticalTo:[NSNull null]];
+    
+    return results;
+}
+
+/* A formula is outdated when none of its installed versions is as new as the
+ * available version. Formulae installed from HEAD are never outdated.
+ */
+- (BOOL)isOutdatedWithInstalledVersions:(NSArray *)installedVersions availableVersion:(NSString *)availableVersion
+{
+    for (NSString *version in installedVersions) {
+        if ([version hasPrefix:@"HEAD"]) {
+            return NO;
+        }
+        if ([MRBrewVersion compareVersion:version toVersion:availableVersion] != NSOrderedAscending) {
+            return NO;
+        }
+    }
+    
+    return [installedVersions count] > 0;
+}
+
+- (NSString *)versionOfFormulaAtPath:(NSString *)path
+{
+    NSString *source = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:NULL];
+    if (!source) {
+        return nil;
+    }
+    
+    static NSSet *blockKeywords = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        blockKeywords = [NSSet setWithObjects:@"class", @"module", @"def", @"if", @"unless", @"case", @"begin", @"while", @"until", nil];
+    });
+    
+    NSCharacterSet *whitespace = [NSCharacterSet whitespaceCharacterSet];
+    NSMutableArray *blocks = [NSMutableArray array];
+    NSString *heredocTerminator = nil;
+    NSString *URLString = nil;
+    NSString *version = nil;
+    NSInteger revision = 0;
+    
+    for (NSString *sourceLine in [source componentsSeparatedByString:@"\n"]) {
+        NSString *line = [sourceLine stringByTrimmingCharactersInSet:whitespace];
+        
+        if (heredocTerminator) {
+            if ([line isEqualToString:heredocTerminator]) {
+                heredocTerminator = nil;
+            }
+            continue;
+        }
+        
+        if ([line isEqualToString:@"__END__"]) {
+            break;
+        }
+        if ([line length] == 0 || [line hasPrefix:@"#"]) {
+            continue;
+        }
+        
+        NSString *keyword = MRBrewFirstWord(line);
+        
+        // statements in the class body, or in its stable block, describe the
+        // stable version
+        BOOL isStableLevel = [blocks count] == 1 || ([blocks count] == 2 && [[blocks lastObject] isEqualToString:@"stable"]);
+        if (isStableLevel) {
+            if ([keyword isEqualToString:@"url"] && !URLString) {
+                URLString = MRBrewFirstStringLiteral(line);
+            }
+            else if ([keyword isEqualToString:@"version"] && !version) {
+                version = MRBrewFirstStringLiteral(line);
+            }
+            else if ([keyword isEqualToString:@"revision"]) {
+                revision = [[line substringFromIndex:[keyword length]] integerValue];
+            }
+        }
+        
+        heredocTerminator = MRBrewHeredocTerminator(line);
+        
+        BOOL isOneLineBlock = [line hasSuffix:@" end"] || [line hasSuffix:@";end"];
+        if ([keyword isEqualToString:@"end"]) {
+            if ([blocks count]) {
+                [blocks removeLastObject];
+            }
+        }
+        else if (!isOneLineBlock && ([blockKeywords containsObject:keyword] || [line hasSuffix:@" do"] || [line rangeOfString:@" do |"].location != NSNotFound)) {
+            [blocks addObject:keyword];
+        }
+    }
+    
+    if (!version && URLString) {
+        version = [MRBrewVersion versionFromURLString:URLString];
+    }
+    if (!version) {
+        return nil;
+    }
+    
+    return revision > 0 ? [NSString stringWithFormat:@"%@_%ld", version, (long)revision] : version;
+}
+
+#pragma mark - Output
+
+- (BOOL)canProduceOutputForOperation:(MRBrewOperation *)operation
+{
+    return [[operation name] isEqualToString:MRBrewOperationOutdatedIdentifier] && ![[operation parameters] containsObject:MRBrewOperationJSONInfoParameter];
+}
+
+- (NSData *)outputForOperation:(MRBrewOperation *)operation
+{
+    BOOL verbose = [[operation parameters] containsObject:@"--verbose"] || [[operation parameters] containsObject:@"-v"];
+    NSArray *names = [operation formula] ? @[[[operation formula] name]] : nil;
+    NSMutableString *output = [NSMutableString string];
+    
+    for (MRBrewFormula *formula in [self outdatedFormulaeWithNames:names]) {
+        if (verbose) {
+            [output appendFormat:@"%@ (%@) < %@", [formula name], [[formula installedVersions] componentsJoinedByString:@", "], [formula availableVersion]];
+            if ([formula isPinned]) {
+                [output appendFormat:@" [pinned at %@]", [self pinnedVersionOfFormula:[formula name]]];
+            }
+        }
+        else {
+            [output appendString:[formula name]];
+        }
+        [output appendString:@"\n"];
+    }
+    
+    return [output dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+#pragma mark - File System
+
+/* Returns the version a pinned formula is pinned at, read from its link in
+ * `PinnedKegs`.
+ */
+- (NSString *)pinnedVersionOfFormula:(NSString *)name
+{
+    NSString *linkPath = [[[self locations] pinnedKegsPath] stringByAppendingPathComponent:name];
+    
+    return [[[NSFileManager defaultManager] destinationOfSymbolicLinkAtPath:linkPath error:NULL] lastPathComponent];
+}
+
+/* Returns a dictionary mapping the name of each formula in a tap to the path
+ * of its source. Where taps share a formula name, the first tap in
+ * alphabetical order is used.
+ */
+- (NSDictionary *)tapFormulaPaths
+{
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSString *tapsPath = [[self locations] tapsPath];
+    NSMutableDictionary *paths = [NSMutableDictionary dictionary];
+    
+    for (NSString *user in [[fileManager contentsOfDirectoryAtPath:tapsPath error:NULL] sortedArrayUsingSelector:@selector(compare:)]) {
+        NSString *userPath = [tapsPath stringByAppendingPathComponent:user];
+        
+        for (NSString *repository in [[fileManager contentsOfDirectoryAtPath:userPath error:NULL] sortedArrayUsingSelector:@selector(compare:)]) {
+            NSString *repositoryPath = [userPath stringByAppendingPathComponent:repository];
+            
+            for (NSString *directory in @[@"Formula", @"HomebrewFormula", @""]) {
+                NSString *directoryPath = [repositoryPath stringByAppendingPathComponent:directory];
+                
+                for (NSString *file in [[fileManager contentsOfDirectoryAtPath:directoryPath error:NULL] sortedArrayUsingSelector:@selector(compare:)]) {
+                    NSString *name = [file stringByDeletingPathExtension];
+                    if ([[file pathExtension] isEqualToString:@"rb"] && ![paths objectForKey:name]) {
+                        [paths setObject:[directoryPath stringByAppendingPathComponent:file] forKey:name];
+                    }
+                }
+            }
+        }
+    }
+    
+    return paths;
+}
+
+@end
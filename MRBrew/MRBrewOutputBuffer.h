@@ -0,0 +1,86 @@
+//
+//  MRBrewOutputBuffer.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "MRBrew.h"
+
+/** An `MRBrewOutputBuffer` object holds the output of one of a task's streams
+ * between the thread that reads it and the queue it is delivered on.
+ *
+ * The reading thread appends each chunk as it is read, and a drain is
+ * scheduled on the delivery queue when the buffer goes from empty to holding
+ * output. The drain takes everything that has been appended in the meantime,
+ * so at most one drain is waiting at a time however fast output arrives.
+ *
+ * The number of bytes held is bounded by the buffer's limit. What happens to
+ * output read while the buffer is full is determined by its policy (see
+ * `MRBrewOutputBufferPolicy`).
+ */
+@interface MRBrewOutputBuffer : NSObject
+
+/** The number of bytes the buffer holds before its policy is applied. */
+@property (readonly) NSUInteger limit;
+
+/** The policy applied to output read while the buffer is full. */
+@property (readonly) MRBrewOutputBufferPolicy policy;
+
+/** The number of bytes discarded because the buffer was full. */
+@property (readonly) NSUInteger droppedLength;
+
+/** Returns an initialized `MRBrewOutputBuffer` object.
+ *
+ * @param limit The number of bytes the buffer holds before its policy is
+ * applied. A limit of `0` is treated as `1`.
+ * @param policy The policy applied to output read while the buffer is full.
+ * @return An initialized buffer.
+ */
+- (instancetype)initWithLimit:(NSUInteger)limit policy:(MRBrewOutputBufferPolicy)policy;
+
+/** Appends a chunk of output.
+ *
+ * With the `MRBrewOutputBufferPolicyBlock` policy this method does not return
+ * while the buffer is full, until a drain makes room or the buffer is closed.
+ *
+ * @param data The chunk of output. Empty chunks are ignored.
+ * @return `YES` if the caller must schedule a drain, otherwise `NO`.
+ */
+- (BOOL)appendData:(NSData *)data;
+
+/** Removes and returns the output held by the buffer.
+ *
+ * @return An array of `NSData` objects in the order they were read, which may
+ * be empty. With the `MRBrewOutputBufferPolicyCoalesce` policy the array holds
+ * at most one object.
+ */
+- (NSArray *)drain;
+
+/** Indicates that the stream has ended. Output appended after the buffer is
+ * closed never blocks; it is held beyond the limit with the
+ * `MRBrewOutputBufferPolicyBlock` policy, so that the last of a task's output
+ * is not lost.
+ */
+- (void)close;
+
+@end
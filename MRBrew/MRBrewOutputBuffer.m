@@ -0,0 +1,165 @@
+//
+//  MRBrewOutputBuffer.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewOutputBuffer.h"
+
+@interface MRBrewOutputBuffer ()
+{
+    @private
+    NSCondition *_condition;
+    NSMutableArray *_chunks;
+    NSUInteger _length;
+    NSUInteger _droppedLength;
+    NSMutableData *_merged;
+    BOOL _drainScheduled;
+    BOOL _closed;
+}
+
+@end
+
+@implementation MRBrewOutputBuffer
+
+- (instancetype)initWithLimit:(NSUInteger)limit policy:(MRBrewOutputBufferPolicy)policy
+{
+    if (self = [super init]) {
+        _limit = MAX(limit, 1);
+        _policy = policy;
+        _condition = [[NSCondition alloc] init];
+        _chunks = [NSMutableArray array];
+    }
+    
+    return self;
+}
+
+- (NSUInteger)droppedLength
+{
+    [_condition lock];
+    NSUInteger droppedLength = _droppedLength;
+    [_condition unlock];
+    
+    return droppedLength;
+}
+
+#pragma mark - Buffering
+
+- (BOOL)appendData:(NSData *)data
+{
+    NSUInteger length = [data length];
+    if (length == 0) {
+        return NO;
+    }
+    
+    [_condition lock];
+    
+    switch (_policy) {
+        case MRBrewOutputBufferPolicyBlock:
+            // the reading thread waits, so the task blocks once the pipe fills
+            while (_length >= _limit && !_closed) {
+                [_condition wait];
+            }
+            [_chunks addObject:data];
+            _length += length;
+            break;
+        case MRBrewOutputBufferPolicyCoalesce:
+            [self coalesceData:data];
+            break;
+        case MRBrewOutputBufferPolicyDrop:
+            if (_length + length > _limit) {
+                _droppedLength += length;
+            }
+            else {
+                [_chunks addObject:data];
+                _length += length;
+            }
+            break;
+    }
+    
+    BOOL scheduleDrain = !_drainScheduled && _length > 0;
+    if (scheduleDrain) {
+        _drainScheduled = YES;
+    }
+    
+    [_condition unlock];
+    
+    return scheduleDrain;
+}
+
+/* Merges a chunk with the output already held, discarding the oldest bytes if
+ * the result exceeds the limit. Must be called with the condition locked.
+ */
+- (void)coalesceData:(NSData *)data
+{
+    if (![_chunks count] && [data length] <= _limit) {
+        // a lone chunk is held as read, and only copied if more arrives
+        [_chunks addObject:data];
+        _length = [data length];
+        return;
+    }
+    
+    if (!_merged) {
+        _merged = [NSMutableData dataWithCapacity:_length + [data length]];
+        for (NSData *chunk in _chunks) {
+            [_merged appendData:chunk];
+        }
+        [_chunks setArray:@[_merged]];
+    }
+    
+    NSMutableData *merged = _merged;
+    [merged appendData:data];
+    
+    NSUInteger excess = [merged length] > _limit ? [merged length] - _limit : 0;
+    if (excess > 0) {
+        [merged replaceBytesInRange:NSMakeRange(0, excess) withBytes:NULL length:0];
+        _droppedLength += excess;
+    }
+    
+    _length = [merged length];
+}
+
+- (NSArray *)drain
+{
+    [_condition lock];
+    
+    NSArray *chunks = _chunks;
+    _chunks = [NSMutableArray array];
+    _merged = nil;
+    _length = 0;
+    _drainScheduled = NO;
+    [_condition broadcast];
+    
+    [_condition unlock];
+    
+    return chunks;
+}
+
+- (void)close
+{
+    [_condition lock];
+    _closed = YES;
+    [_condition broadcast];
+    [_condition unlock];
+}
+
+@end
@@ -62,6 +62,22 @@ typedef NS_ENUM(NSInteger, MRBrewOutputParserError) {
  */
 + (instancetype)outputParser;
 
+/**-----------------------------------------------------------------------------
+ * @name Parsing in Parallel
+ * -----------------------------------------------------------------------------
+ */
+
+/** The length, in characters, at or above which the output of list, search
+ * and options operations is parsed in parallel. The default is 524288.
+ *
+ * Output at or above the threshold is divided into chunks at line boundaries
+ * (or, for options output, at option boundaries), the chunks are parsed
+ * concurrently, and their objects are joined in the order they appear in the
+ * output. The objects returned are the same as those returned when parsing
+ * serially. Set the threshold to `NSUIntegerMax` to always parse serially.
+ */
+@property (assign) NSUInteger parallelParsingThreshold;
+
 /**-----------------------------------------------------------------------------
  * @name Parsing Objects
  * -----------------------------------------------------------------------------
@@ -74,7 +90,9 @@ typedef NS_ENUM(NSInteger, MRBrewOutputParserError) {
  * Parsing is only supported for output generated by `MRBrewOperation` objects
  * whose `name` property (equivalent to the _command_ in Homebrew terminology)
  * matches one of the constants `MRBrewOperationListIdentifier`,
- * `MRBrewOperationSearchIdentifier` or `MRBrewOperationOptionsIdentifier`.
+ * `MRBrewOperationSearchIdentifier`, `MRBrewOperationOptionsIdentifier` or
+ * `MRBrewOperationOutdatedIdentifier`, and for JSON info operations created with `MRBrewOperation`'s
+ * infoOperationForFormulae: or installedInfoOperation methods.
  *
  * This method blocks execution of the current thread until the receiver has
  * finished parsing.
@@ -89,12 +107,20 @@ typedef NS_ENUM(NSInteger, MRBrewOutputParserError) {
  * (i.e. the output string is empty or yieled no objects). For operations
  * whose `name` property is equal to one of the constants
  * `MRBrewOperationListIdentifier` or `MRBrewOperationSearchIdentifier`,
- * the returned array will contain one or more `MRBrewFormula` objects.
+ * the returned array is an `MRBrewFormulaResultSet` containing one or more
+ * `MRBrewFormula` objects.
  * In addition, for `MRBrewOperationListIdentifier` operations, each operation
  * object will have its `isInstalled` property set to `YES`. For operations
  * whose `name` property matches the `MRBrewOperationOptionsIdentifier`
  * constant, the returned array will contain one or more `MRBrewInstallOption`
- * objects.
+ * objects. For JSON info operations, the returned array will contain an
+ * `MRBrewFormula` object for each formula described, with its versions,
+ * installed kegs, dependencies, options, and pinned and outdated states set.
+ * For operations whose `name` property matches the
+ * `MRBrewOperationOutdatedIdentifier` constant, the returned array will contain
+ * an `MRBrewFormula` object for each outdated formula, with its installed
+ * versions, available version and pinned state set where the output provides
+ * them (see MRBrewOutdatedReader).
  */
 - (NSArray *)objectsForOperation:(MRBrewOperation *)operation output:(NSString *)output error:(NSError **)error;
 
@@ -28,15 +28,35 @@
 #import "MRBrewConstants.h"
 #import "MRBrewFormula.h"
 #import "MRBrewInstallOption.h"
+#import "MRBrewFormulaInfoReader.h"
+#import "MRBrewFormulaResultSet.h"
+#import "MRBrewFormulaResultSet+Private.h"
+#import "MRBrewOutdatedReader.h"
 
 NSString * const MRBrewOutputParserErrorDomain = @"uk.co.fidgetbox.MRBrew";
 
+static const NSUInteger MRBrewOutputParserDefaultParallelParsingThreshold = 512 * 1024;
+
+/* Output is divided into several chunks per processor so that a chunk that is
+ * slow to parse does not leave the other processors idle.
+ */
+static const NSUInteger MRBrewOutputParserChunksPerProcessor = 4;
+
+/* The separators at which output may be divided into chunks. Each begins with a
+ * newline, so a chunk never ends part way through a line.
+ */
+static const char * const MRBrewOutputParserLineSeparator = "\n";
+static const char * const MRBrewOutputParserOptionSeparator = "\n--";
+
 @interface MRBrewOutputParser ()
 
 - (NSArray *)parseFormulaeFromOutput:(NSString *)output;
+- (NSArray *)parseFormulaeFromOutput:(NSString *)output isInstalled:(BOOL)isInstalled;
 - (NSArray *)parseFormulaeFromSearchOperationOutput:(NSString *)output;
 - (NSArray *)parseFormulaeFromListOperationOutput:(NSString *)output;
 - (NSArray *)parseInstallOptionsFromOutput:(NSString *)output;
+- (NSArray *)parseSerialInstallOptionsFromOutput:(NSString *)output;
+- (NSArray *)parseChunksOfOutput:(NSString *)output separator:(const char *)separator usingBlock:(id (^)(const char *bytes, NSUInteger length))parseChunk;
 
 @end
 
@@ -44,6 +64,15 @@ NSString * const MRBrewOutputParserErrorDomain = @"uk.co.fidgetbox.MRBrew";
 
 #pragma mark - Lifecycle
 
+- (instancetype)init
+{
+    if (self = [super init]) {
+        _parallelParsingThreshold = MRBrewOutputParserDefaultParallelParsingThreshold;
+    }
+    
+    return self;
+}
+
 + (instancetype)outputParser
 {
     return [[self alloc] init];
@@ -74,6 +103,23 @@ NSString * const MRBrewOutputParserErrorDomain = @"uk.co.fidgetbox.MRBrew";
             errorOccurred = YES;
         }
     }
+    else if ([[operation name] isEqualToString:MRBrewOperationInfoIdentifier] && [[operation parameters] containsObject:MRBrewOperationJSONInfoParameter]) {
+        objects = [MRBrewFormulaInfoReader formulaeFromData:[output dataUsingEncoding:NSUTF8StringEncoding]];
+        
+        if (!objects) {
+            [self errorForErrorType:MRBrewOutputParserErrorSyntax usingPointer:error];
+            errorOccurred = YES;
+        }
+    }
+    else if ([[operation name] isEqualToString:MRBrewOperationOutdatedIdentifier]) {
+        MRBrewOutdatedFormat format = [[operation parameters] containsObject:MRBrewOperationJSONInfoParameter] ? MRBrewOutdatedFormatJSON : MRBrewOutdatedFormatText;
+        objects = [MRBrewOutdatedReader formulaeFromData:[output dataUsingEncoding:NSUTF8StringEncoding] format:format];
+        
+        if (!objects) {
+            [self errorForErrorType:MRBrewOutputParserErrorSyntax usingPointer:error];
+            errorOccurred = YES;
+        }
+    }
     else if ([[operation name] isEqualToString:MRBrewOperationOptionsIdentifier]) {
         objects = [self parseInstallOptionsFromOutput:output];
         
@@ -94,23 +140,27 @@ NSString * const MRBrewOutputParserErrorDomain = @"uk.co.fidgetbox.MRBrew";
 #pragma mark - Object Parsing (private)
 
 /* Parse output string in which each line is expected to contain the name of a
- * formula, and return an array of one or more MRBrewFormula objects.
+ * formula, and return a result set of one or more MRBrewFormula objects.
  */
 - (NSArray *)parseFormulaeFromOutput:(NSString *)output
 {
-    NSMutableArray *objects = [NSMutableArray array];
-    
-    NSArray *names = [output componentsSeparatedByString:@"\n"];
+    return [self parseFormulaeFromOutput:output isInstalled:NO];
+}
+
+- (NSArray *)parseFormulaeFromOutput:(NSString *)output isInstalled:(BOOL)isInstalled
+{
+    MRBrewFormulaStatus status = isInstalled ? MRBrewFormulaStatusInstalled : 0;
     
-    for (NSString *name in names) {
-        if ([name isEqualToString:@""]) {
-            continue;
-        }
+    if ([output length] >= [self parallelParsingThreshold]) {
+        NSArray *resultSets = [self parseChunksOfOutput:output separator:MRBrewOutputParserLineSeparator usingBlock:^id(const char *bytes, NSUInteger length) {
+            return [MRBrewFormulaResultSet resultSetWithLineBytes:bytes length:length status:status];
+        }];
         
-        [objects addObject:[MRBrewFormula formulaWithName:name]];
+        return [MRBrewFormulaResultSet resultSetByJoiningResultSets:resultSets];
     }
     
-    return [NSArray arrayWithArray:objects];
+    // formula objects are only created as the result set is accessed
+    return [MRBrewFormulaResultSet resultSetWithLines:output status:status];
 }
 
 /* Parse output string in which each line is expected to contain the name of a
@@ -129,13 +179,7 @@ NSString * const MRBrewOutputParserErrorDomain = @"uk.co.fidgetbox.MRBrew";
 
 - (NSArray *)parseFormulaeFromListOperationOutput:(NSString *)output
 {
-    NSArray *formulae = [self parseFormulaeFromOutput:output];
-    
-    for (MRBrewFormula *formula in formulae) {
-        [formula setIsInstalled:YES];
-    }
-    
-    return [NSArray arrayWithArray:formulae];
+    return [self parseFormulaeFromOutput:output isInstalled:YES];
 }
 
 /* Parse output string that is expected to contain two lines of text for each
@@ -145,6 +189,32 @@ NSString * const MRBrewOutputParserErrorDomain = @"uk.co.fidgetbox.MRBrew";
  * array of one or more MRBrewFormula objects if parsing was successful.
  */
 - (NSArray *)parseInstallOptionsFromOutput:(NSString *)output
+{
+    if ([output length] >= [self parallelParsingThreshold]) {
+        // each chunk begins after a separator, exactly as each record does
+        // when the whole output is separated into records
+        NSArray *chunkOptions = [self parseChunksOfOutput:output separator:MRBrewOutputParserOptionSeparator usingBlock:^id(const char *bytes, NSUInteger length) {
+            NSString *chunk = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+            return [self parseSerialInstallOptionsFromOutput:chunk];
+        }];
+        
+        if (!chunkOptions) {
+            return nil;
+        }
+        
+        NSMutableArray *objects = [NSMutableArray array];
+        for (NSArray *options in chunkOptions) {
+            [objects addObjectsFromArray:options];
+        }
+        
+        return [NSArray arrayWithArray:objects];
+    }
+    
+    return [self parseSerialInstallOptionsFromOutput:output];
+}
+
+/* Parse options output on the current thread. */
+- (NSArray *)parseSerialInstallOptionsFromOutput:(NSString *)output
 {
     NSMutableArray *objects = [NSMutableArray array];
 
@@ -184,6 +254,64 @@ NSString * const MRBrewOutputParserErrorDomain = @"uk.co.fidgetbox.MRBrew";
     return [NSArray arrayWithArray:objects];
 }
 
+/* Divides the output into chunks at occurrences of the separator and parses
+ * the chunks concurrently with the specified block, which must be safe to call
+ * from several threads at once. Each chunk begins immediately after a
+ * separator, or at the start of the output. Returns the objects returned for
+ * each chunk in the order the chunks appear in the output, or nil if the block
+ * returned nil for any chunk.
+ */
+- (NSArray *)parseChunksOfOutput:(NSString *)output separator:(const char *)separator usingBlock:(id (^)(const char *bytes, NSUInteger length))parseChunk
+{
+    const char *bytes = [output UTF8String];
+    NSUInteger length = bytes ? strlen(bytes) : 0;
+    NSUInteger separatorLength = strlen(separator);
+    NSUInteger chunkCount = MAX([[NSProcessInfo processInfo] activeProcessorCount], 1) * MRBrewOutputParserChunksPerProcessor;
+    NSUInteger chunkLength = MAX(length / chunkCount, 1);
+    
+    // each chunk ends at the first separator after its nominal length; output
+    // ending in a separator ends with an empty chunk, as it would end with an
+    // empty record if separated serially
+    NSMutableArray *ranges = [NSMutableArray array];
+    NSUInteger chunkStart = 0;
+    NSUInteger chunkEnd;
+    do {
+        chunkEnd = length;
+        if (chunkStart + chunkLength < length) {
+            const char *boundary = memmem(bytes + chunkStart + chunkLength, length - chunkStart - chunkLength, separator, separatorLength);
+            if (boundary) {
+                chunkEnd = boundary - bytes;
+            }
+        }
+        
+        [ranges addObject:[NSValue valueWithRange:NSMakeRange(chunkStart, chunkEnd - chunkStart)]];
+        chunkStart = chunkEnd + separatorLength;
+    } while (chunkEnd < length);
+    
+    NSMutableArray *results = [NSMutableArray arrayWithCapacity:[ranges count]];
+    for (NSUInteger i = 0; i < [ranges count]; i++) {
+        [results addObject:[NSNull null]];
+    }
+    
+    __block BOOL failed = NO;
+    dispatch_apply([ranges count], dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        @autoreleasepool {
+            NSRange range = [[ranges objectAtIndex:i] rangeValue];
+            id result = parseChunk(bytes + range.location, range.length);
+            
+            @synchronized(results) {
+                if (result) {
+                    [results replaceObjectAtIndex:i withObject:result];
+                }
+                else {
+                    failed = YES;
+                }
+            }
+        }
+    });
+    
+    return failed ? nil : results;
+}
 
 /* Sets the error pointer (if provided) to a newly instantiated error object
  * with a default error domain and the specified error code.
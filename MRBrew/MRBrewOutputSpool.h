@@ -0,0 +1,125 @@
+//
+//  MRBrewOutputSpool.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/** An `MRBrewOutputSpool` object collects the complete output of an operation
+ * while keeping its memory use bounded.
+ *
+ * Output is held in memory until it exceeds the spool's memory threshold,
+ * after which all of it is written to an append-only temporary file. When
+ * writing has finished the output is exposed as a single buffer, memory-mapped
+ * from the file if one was used, with random access to its lines and a search
+ * API. A mapped buffer's pages are read from disk as they are accessed and can
+ * be reclaimed by the system at any time, so the output itself does not add to
+ * the resident size of a spool however much an operation generates. Reading
+ * lines builds an index of where each line begins, which is held in memory and
+ * costs 8 bytes per line (4 bytes on 32-bit systems).
+ *
+ * The temporary file is removed once it has been mapped, or when the spool is
+ * deallocated.
+ *
+ * Use `MRBrew`'s performOperation:spool:queue:completion:failure: to spool an
+ * operation's output, or call appendData: and finishWriting directly.
+ */
+@interface MRBrewOutputSpool : NSObject
+
+/** The number of bytes of output held in memory before output is written to a
+ * temporary file. The default is 1MB.
+ */
+@property (readonly) NSUInteger memoryThreshold;
+
+/** A boolean value indicating whether the output has been written to a
+ * temporary file.
+ */
+@property (readonly, getter=isSpooledToDisk) BOOL spooledToDisk;
+
+/** An error describing why output could not be written to the temporary file,
+ * or `nil`. Output received after such an error is discarded.
+ */
+@property (readonly) NSError *error;
+
+/**-----------------------------------------------------------------------------
+ * @name Creating a Spool
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns an initialized `MRBrewOutputSpool` object with the specified memory
+ * threshold.
+ *
+ * @param memoryThreshold The number of bytes held in memory before output is
+ * written to a temporary file.
+ * @return An empty spool.
+ */
+- (instancetype)initWithMemoryThreshold:(NSUInteger)memoryThreshold;
+
+/**-----------------------------------------------------------------------------
+ * @name Writing Output
+ * -----------------------------------------------------------------------------
+ */
+
+/** Appends output to the spool. This method may be called from any thread.
+ * Output appended after finishWriting has been called is ignored.
+ *
+ * @param data The output following that previously appended.
+ */
+- (void)appendData:(NSData *)data;
+
+/** Indicates that all of the output has been appended, making it available
+ * through the methods below.
+ */
+- (void)finishWriting;
+
+/**-----------------------------------------------------------------------------
+ * @name Reading Output
+ * -----------------------------------------------------------------------------
+ */
+
+/** All of the output, or `nil` if writing has not finished. The returned object
+ * is memory-mapped if the output was written to a temporary file.
+ */
+@property (readonly) NSData *data;
+
+/** The number of lines in the output. A final line without a trailing newline
+ * is counted. Returns `0` if writing has not finished.
+ */
+- (NSUInteger)lineCount;
+
+/** Returns the line at the specified index, without its trailing newline.
+ *
+ * @param index An index less than lineCount.
+ * @return The line.
+ */
+- (NSString *)lineAtIndex:(NSUInteger)index;
+
+/** Returns the indexes of the lines that contain the specified string. The
+ * comparison is case sensitive.
+ *
+ * @param string The string to search for.
+ * @return The indexes of the matching lines.
+ */
+- (NSIndexSet *)indexesOfLinesContainingString:(NSString *)string;
+
+@end
@@ -0,0 +1,285 @@
+//
+//  MRBrewOutputSpool.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewOutputSpool.h"
+#include <unistd.h>
+#include <errno.h>
+
+static const NSUInteger MRBrewOutputSpoolDefaultMemoryThreshold = 1024 * 1024;
+
+/* Returns the range of the line at the specified index of the output, without
+ * its trailing newline, from the offsets returned by lineOffsets.
+ */
+static inline NSRange MRBrewOutputSpoolLineRange(const NSUInteger *offsets, const char *bytes, NSUInteger index)
+{
+    NSRange range = NSMakeRange(offsets[index], offsets[index + 1] - offsets[index]);
+    
+    if (range.length > 0 && bytes[NSMaxRange(range) - 1] == '\n') {
+        range.length--;
+    }
+    
+    return range;
+}
+
+@interface MRBrewOutputSpool ()
+{
+    @private
+    NSMutableData *_buffer;
+    NSString *_path;
+    int _fileDescriptor;
+    BOOL _finished;
+    NSMutableData *_lineOffsets;
+}
+
+@property (readwrite, getter=isSpooledToDisk) BOOL spooledToDisk;
+@property (readwrite) NSError *error;
+@property (readwrite) NSData *data;
+
+@end
+
+@implementation MRBrewOutputSpool
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    return [self initWithMemoryThreshold:MRBrewOutputSpoolDefaultMemoryThreshold];
+}
+
+- (instancetype)initWithMemoryThreshold:(NSUInteger)memoryThreshold
+{
+    if (self = [super init]) {
+        _memoryThreshold = memoryThreshold;
+        _buffer = [NSMutableData data];
+        _fileDescriptor = -1;
+    }
+    
+    return self;
+}
+
+- (void)dealloc
+{
+    [self closeFile];
+}
+
+#pragma mark - Writing
+
+- (void)appendData:(NSData *)data
+{
+    @synchronized(self) {
+        if (_finished || [self error]) {
+            return;
+        }
+        
+        if (_fileDescriptor < 0 && [_buffer length] + [data length] <= _memoryThreshold) {
+            [_buffer appendData:data];
+            return;
+        }
+        
+        // the threshold has been exceeded, so move the output to disk
+        if (_fileDescriptor < 0) {
+            if (![self openFile] || ![self writeBytes:[_buffer bytes] length:[_buffer length]]) {
+                return;
+            }
+            _buffer = nil;
+        }
+        
+        [self writeBytes:[data bytes] length:[data length]];
+    }
+}
+
+- (void)finishWriting
+{
+    @synchronized(self) {
+        if (_finished) {
+            return;
+        }
+        _finished = YES;
+        
+        if (_fileDescriptor < 0) {
+            [self setData:[_buffer copy]];
+            _buffer = nil;
+            return;
+        }
+        
+        close(_fileDescriptor);
+        _fileDescriptor = -1;
+        
+        NSError *error = nil;
+        NSData *data = [NSData dataWithContentsOfFile:_path options:NSDataReadingMappedAlways error:&error];
+        if (!data) {
+            [self setError:error];
+        }
+        [self setData:data];
+        
+        // the mapping keeps the file's contents available after it is removed
+        [self closeFile];
+    }
+}
+
+#pragma mark - Temporary File (private)
+
+- (BOOL)openFile
+{
+    NSString *template = [NSTemporaryDirectory() stringByAppendingPathComponent:@"MRBrewOutputSpool.XXXXXX"];
+    char *path = strdup([template fileSystemRepresentation]);
+    
+    _fileDescriptor = mkstemp(path);
+    if (_fileDescriptor < 0) {
+        [self setError:[NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil]];
+    }
+    else {
+        _path = [[NSFileManager defaultManager] stringWithFileSystemRepresentation:path length:strlen(path)];
+        [self setSpooledToDisk:YES];
+    }
+    
+    free(path);
+    
+    return _fileDescriptor >= 0;
+}
+
+- (BOOL)writeBytes:(const void *)bytes length:(NSUInteger)length
+{
+    while (length > 0) {
+        ssize_t written = write(_fileDescriptor, bytes, length);
+        
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            
+            [self setError:[NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil]];
+            return NO;
+        }
+        
+        bytes = (const uint8_t *)bytes + written;
+        length -= written;
+    }
+    
+    return YES;
+}
+
+- (void)closeFile
+{
+    if (_fileDescriptor >= 0) {
+        close(_fileDescriptor);
+        _fileDescriptor = -1;
+    }
+    
+    if (_path) {
+        unlink([_path fileSystemRepresentation]);
+        _path = nil;
+    }
+}
+
+#pragma mark - Reading
+
+/* Returns the offset at which each line begins, followed by the length of the
+ * output, indexing the lines the first time it is called.
+ */
+- (NSData *)lineOffsets
+{
+    @synchronized(self) {
+        NSData *data = [self data];
+        
+        if (!_lineOffsets && data) {
+            _lineOffsets = [NSMutableData data];
+            
+            const char *bytes = [data bytes];
+            NSUInteger length = [data length];
+            NSUInteger lineStart = 0;
+            
+            while (lineStart < length) {
+                [_lineOffsets appendBytes:&lineStart length:sizeof(lineStart)];
+                
+                const char *newline = memchr(bytes + lineStart, '\n', length - lineStart);
+                lineStart = newline ? (NSUInteger)(newline - bytes) + 1 : length;
+            }
+            
+            [_lineOffsets appendBytes:&length length:sizeof(length)];
+        }
+        
+        return _lineOffsets;
+    }
+}
+
+- (NSUInteger)lineCount
+{
+    NSData *offsets = [self lineOffsets];
+    
+    return offsets ? [offsets length] / sizeof(NSUInteger) - 1 : 0;
+}
+
+- (NSString *)lineAtIndex:(NSUInteger)index
+{
+    // the index and output do not change once built, so they are read once
+    NSData *lineOffsets = [self lineOffsets];
+    NSUInteger lineCount = lineOffsets ? [lineOffsets length] / sizeof(NSUInteger) - 1 : 0;
+    if (index >= lineCount) {
+        [NSException raise:NSRangeException format:@"Line index %lu beyond bounds [0 .. %lu]", (unsigned long)index, (unsigned long)lineCount];
+    }
+    
+    const char *bytes = [[self data] bytes];
+    NSRange range = MRBrewOutputSpoolLineRange([lineOffsets bytes], bytes, index);
+    
+    return [[NSString alloc] initWithBytes:bytes + range.location length:range.length encoding:NSUTF8StringEncoding];
+}
+
+- (NSIndexSet *)indexesOfLinesContainingString:(NSString *)string
+{
+    NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+    const char *search = [string UTF8String];
+    NSUInteger searchLength = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    
+    // the index is built, and the lock taken, once for the whole search
+    NSData *lineOffsets = [self lineOffsets];
+    const NSUInteger *offsets = [lineOffsets bytes];
+    NSUInteger lineCount = lineOffsets ? [lineOffsets length] / sizeof(NSUInteger) - 1 : 0;
+    const char *bytes = [[self data] bytes];
+    
+    if (searchLength == 0) {
+        [indexes addIndexesInRange:NSMakeRange(0, lineCount)];
+        return indexes;
+    }
+    
+    for (NSUInteger index = 0; index < lineCount; index++) {
+        NSRange range = MRBrewOutputSpoolLineRange(offsets, bytes, index);
+        const char *line = bytes + range.location;
+        const char *end = line + range.length;
+        
+        // find candidate positions using the first byte, then compare
+        while ((NSUInteger)(end - line) >= searchLength && (line = memchr(line, search[0], end - line - searchLength + 1))) {
+            if (memcmp(line, search, searchLength) == 0) {
+                [indexes addIndex:index];
+                break;
+            }
+            line++;
+        }
+    }
+    
+    return indexes;
+}
+
+@end
@@ -0,0 +1,101 @@
+//
+//  MRBrewProgress.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/** These constants indicate the phase of an install operation described by an
+ * MRBrewProgress object.
+ */
+typedef NS_ENUM(NSInteger, MRBrewProgressPhase) {
+    /** A formula's source or bottle is being downloaded. */
+    MRBrewProgressPhaseDownloading,
+    /** A bottle is being poured into the Cellar. */
+    MRBrewProgressPhasePouring,
+    /** A formula, or one of its dependencies, has started installing. */
+    MRBrewProgressPhaseInstalling,
+    /** A formula is being built from source. */
+    MRBrewProgressPhaseBuilding,
+    /** Homebrew is reporting a formula's caveats. */
+    MRBrewProgressPhaseCaveats,
+    /** Homebrew is summarising a completed installation. */
+    MRBrewProgressPhaseSummary
+};
+
+/** An `MRBrewProgress` object describes the progress of an install operation
+ * at one point in time, as recognised from Homebrew's output by an
+ * MRBrewProgressReader.
+ *
+ * Progress objects are immutable.
+ */
+@interface MRBrewProgress : NSObject <NSCopying>
+
+/** The phase the operation has reached. */
+@property (readonly) MRBrewProgressPhase phase;
+
+/** The name of the formula the phase applies to, which may be a dependency of
+ * the formula being installed, or `nil` if it is not known.
+ */
+@property (readonly, copy) NSString *formulaName;
+
+/** The percentage of the current download that has completed, from `0` to
+ * `100`, or `-1` if it is not known. Only MRBrewProgressPhaseDownloading
+ * progress reports a percentage.
+ */
+@property (readonly) double percentComplete;
+
+/**-----------------------------------------------------------------------------
+ * @name Creating Progress
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns an initialized `MRBrewProgress` object with the specified phase,
+ * formula name and percentage.
+ *
+ * @param phase The phase the operation has reached.
+ * @param formulaName The name of the formula the phase applies to, or `nil`.
+ * @param percentComplete The percentage of the current download that has
+ * completed, or `-1`.
+ * @return Progress with the specified properties.
+ */
+- (instancetype)initWithPhase:(MRBrewProgressPhase)phase formulaName:(NSString *)formulaName percentComplete:(double)percentComplete;
+
+/** Returns progress with the specified phase, formula name and percentage.
+ *
+ * @param phase The phase the operation has reached.
+ * @param formulaName The name of the formula the phase applies to, or `nil`.
+ * @param percentComplete The percentage of the current download that has
+ * completed, or `-1`.
+ * @return Progress with the specified properties.
+ */
++ (instancetype)progressWithPhase:(MRBrewProgressPhase)phase formulaName:(NSString *)formulaName percentComplete:(double)percentComplete;
+
+/** Compares the receiver to other progress.
+ *
+ * @param progress The progress with which to compare the receiver.
+ * @return YES if the receiver is equal to _progress_, otherwise NO.
+ */
+- (BOOL)isEqualToProgress:(MRBrewProgress *)progress;
+
+@end
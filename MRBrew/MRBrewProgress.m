@@ -0,0 +1,93 @@
+//
+//  MRBrewProgress.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewProgress.h"
+
+@implementation MRBrewProgress
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithPhase:(MRBrewProgressPhase)phase formulaName:(NSString *)formulaName percentComplete:(double)percentComplete
+{
+    if (self = [super init]) {
+        _phase = phase;
+        _formulaName = [formulaName copy];
+        _percentComplete = percentComplete;
+    }
+    
+    return self;
+}
+
++ (instancetype)progressWithPhase:(MRBrewProgressPhase)phase formulaName:(NSString *)formulaName percentComplete:(double)percentComplete
+{
+    return [[self alloc] initWithPhase:phase
+                           formulaName:formulaName
+                       percentComplete:percentComplete];
+}
+
+#pragma mark - Equality
+
+- (BOOL)isEqualToProgress:(MRBrewProgress *)progress
+{
+    if (self == progress)
+        return YES;
+    
+    if (!progress || ![progress isKindOfClass:[self class]])
+        return NO;
+    
+    if ([self phase] != [progress phase])
+        return NO;
+    if ([self formulaName] != [progress formulaName] && ![[self formulaName] isEqualToString:[progress formulaName]])
+        return NO;
+    if ([self percentComplete] != [progress percentComplete])
+        return NO;
+    
+    return YES;
+}
+
+- (BOOL)isEqual:(id)object
+{
+    return [self isEqualToProgress:object];
+}
+
+- (NSUInteger)hash
+{
+    return [[self formulaName] hash] ^ (NSUInteger)[self phase] ^ (NSUInteger)([self percentComplete] * 10);
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p phase=%ld formula=%@ percent=%.1f>", [self class], self, (long)[self phase], [self formulaName], [self percentComplete]];
+}
+
+#pragma mark - NSCopying protocol
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // immutable
+    return self;
+}
+
+@end
@@ -0,0 +1,78 @@
+//
+//  MRBrewProgressReader.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/** An `MRBrewProgressReader` object recognises the progress of an install
+ * operation in Homebrew's output and describes it with `MRBrewProgress`
+ * objects.
+ *
+ * The reader recognises Homebrew's `==>` phase markers (downloading, pouring,
+ * installing a formula or dependency, build steps, caveats and the summary) and
+ * curl's progress bar lines, from which the percentage of a download is read.
+ * Other output is skipped without being decoded.
+ *
+ * Output can be read in chunks as it is generated; lines may be terminated by
+ * either a newline or the carriage return curl uses to redraw its progress bar.
+ * Only the bytes of an incomplete line are retained between chunks.
+ *
+ * Homebrew writes its phase markers to standard output, while curl draws its
+ * progress bar on standard error. Both streams can be read by the same reader,
+ * each keeping its own incomplete line, so that a download percentage read from
+ * error output is reported for the formula most recently named in output.
+ */
+@interface MRBrewProgressReader : NSObject
+
+/** Returns an initialized `MRBrewProgressReader` object.
+ *
+ * @param formulaName The name of the formula being installed, which is reported
+ * until the output names another formula, or `nil`.
+ * @return An initialized reader.
+ */
+- (instancetype)initWithFormulaName:(NSString *)formulaName;
+
+/** Reads the next chunk of output.
+ *
+ * @param data The output following that passed to the previous call.
+ * @return An array of `MRBrewProgress` objects for the lines completed by
+ * _data_, in the order they were output, which may be empty.
+ */
+- (NSArray *)progressFromData:(NSData *)data;
+
+/** Reads the next chunk of output or error output.
+ *
+ * Phase markers are only recognised in output; error output is only read for
+ * download percentages.
+ *
+ * @param data The output following that passed to the previous call for the
+ * same stream.
+ * @param errorOutput `YES` if _data_ was read from standard error, otherwise
+ * `NO`.
+ * @return An array of `MRBrewProgress` objects for the lines completed by
+ * _data_, in the order they were output, which may be empty.
+ */
+- (NSArray *)progressFromData:(NSData *)data errorOutput:(BOOL)errorOutput;
+
+@end
@@ -0,0 +1,233 @@
+//
+//  MRBrewProgressReader.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewProgressReader.h"
+#import "MRBrewProgress.h"
+
+/* Lines longer than this cannot be progress and are discarded as they are
+ * read, so that a long line of build output is never buffered.
+ */
+static const NSUInteger MRBrewProgressReaderMaximumLineLength = 4096;
+
+@interface MRBrewProgressReader ()
+{
+    @private
+    NSMutableData *_partialLine;
+    NSMutableData *_errorPartialLine;
+    BOOL _discardingLine;
+    BOOL _discardingErrorLine;
+    NSString *_formulaName;
+    BOOL _installing;
+}
+
+@end
+
+@implementation MRBrewProgressReader
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    return [self initWithFormulaName:nil];
+}
+
+- (instancetype)initWithFormulaName:(NSString *)formulaName
+{
+    if (self = [super init]) {
+        _partialLine = [NSMutableData data];
+        _errorPartialLine = [NSMutableData data];
+        _formulaName = [formulaName copy];
+    }
+    
+    return self;
+}
+
+#pragma mark - Reading
+
+- (NSArray *)progressFromData:(NSData *)data
+{
+    return [self progressFromData:data errorOutput:NO];
+}
+
+- (NSArray *)progressFromData:(NSData *)data errorOutput:(BOOL)errorOutput
+{
+    // each stream has its own incomplete line, while the formula is shared
+    NSMutableData *partialLine = errorOutput ? _errorPartialLine : _partialLine;
+    BOOL *discardingLine = errorOutput ? &_discardingErrorLine : &_discardingLine;
+    
+    NSMutableArray *progress = [NSMutableArray array];
+    const char *bytes = [data bytes];
+    NSUInteger length = [data length];
+    NSUInteger lineStart = 0;
+    
+    for (NSUInteger i = 0; i < length; i++) {
+        if (bytes[i] != '\n' && bytes[i] != '\r') {
+            continue;
+        }
+        
+        if (*discardingLine) {
+            *discardingLine = NO;
+        }
+        else if ([partialLine length] > 0) {
+            [partialLine appendBytes:bytes + lineStart length:i - lineStart];
+            [self readLine:[partialLine bytes] length:[partialLine length] errorOutput:errorOutput progress:progress];
+        }
+        else {
+            [self readLine:bytes + lineStart length:i - lineStart errorOutput:errorOutput progress:progress];
+        }
+        
+        [partialLine setLength:0];
+        lineStart = i + 1;
+    }
+    
+    if (lineStart < length && !*discardingLine) {
+        [partialLine appendBytes:bytes + lineStart length:length - lineStart];
+        if ([partialLine length] > MRBrewProgressReaderMaximumLineLength) {
+            [partialLine setLength:0];
+            *discardingLine = YES;
+        }
+    }
+    
+    return progress;
+}
+
+- (void)readLine:(const char *)line length:(NSUInteger)length errorOutput:(BOOL)errorOutput progress:(NSMutableArray *)progress
+{
+    // colourised output is only produced for a terminal, but strip any escape
+    // sequences rather than fail to recognise a marker
+    NSMutableData *plainLine = nil;
+    if (memchr(line, '\033', length)) {
+        plainLine = [NSMutableData dataWithCapacity:length];
+        for (NSUInteger i = 0; i < length; i++) {
+            if (line[i] == '\033') {
+                // skip the escape sequence up to and including its final byte
+                while (i + 1 < length && !(line[i + 1] >= '@' && line[i + 1] <= '~' && line[i + 1] != '[')) {
+                    i++;
+                }
+                i++;
+                continue;
+            }
+            [plainLine appendBytes:line + i length:1];
+        }
+        line = [plainLine bytes];
+        length = [plainLine length];
+    }
+    
+    if (length > 4 && memcmp(line, "==> ", 4) == 0) {
+        // markers written to error output, e.g. by a build, are not phases
+        if (errorOutput) {
+            return;
+        }
+        
+        NSString *message = [[NSString alloc] initWithBytes:line + 4 length:length - 4 encoding:NSUTF8StringEncoding];
+        MRBrewProgress *messageProgress = [self progressForMessage:message];
+        if (messageProgress) {
+            [progress addObject:messageProgress];
+        }
+    }
+    else {
+        double percentComplete = [self percentCompleteFromLine:line length:length];
+        if (percentComplete >= 0) {
+            [progress addObject:[MRBrewProgress progressWithPhase:MRBrewProgressPhaseDownloading formulaName:_formulaName percentComplete:percentComplete]];
+        }
+    }
+}
+
+- (MRBrewProgress *)progressForMessage:(NSString *)message
+{
+    MRBrewProgressPhase phase;
+    
+    if ([message hasPrefix:@"Downloading "]) {
+        phase = MRBrewProgressPhaseDownloading;
+    }
+    else if ([message hasPrefix:@"Pouring "]) {
+        phase = MRBrewProgressPhasePouring;
+    }
+    else if ([message hasPrefix:@"Installing dependencies for "]) {
+        // each dependency is announced separately
+        return nil;
+    }
+    else if ([message hasPrefix:@"Installing "]) {
+        // "Installing wget" or "Installing wget dependency: openssl"
+        NSRange dependencyRange = [message rangeOfString:@" dependency: "];
+        NSString *formulaName = dependencyRange.location != NSNotFound ? [message substringFromIndex:NSMaxRange(dependencyRange)] : [message substringFromIndex:[@"Installing " length]];
+        _formulaName = [[formulaName componentsSeparatedByString:@" "] firstObject];
+        _installing = YES;
+        phase = MRBrewProgressPhaseInstalling;
+    }
+    else if ([message isEqualToString:@"Caveats"]) {
+        _installing = NO;
+        phase = MRBrewProgressPhaseCaveats;
+    }
+    else if ([message isEqualToString:@"Summary"]) {
+        _installing = NO;
+        phase = MRBrewProgressPhaseSummary;
+    }
+    else if (_installing) {
+        // the commands run while building from source, such as ./configure
+        phase = MRBrewProgressPhaseBuilding;
+    }
+    else {
+        return nil;
+    }
+    
+    return [MRBrewProgress progressWithPhase:phase formulaName:_formulaName percentComplete:-1];
+}
+
+/* Returns the percentage from a line of curl's progress bar, which consists of
+ * '#' characters and padding followed by a percentage such as " 45.3%", or -1
+ * if the line is not part of a progress bar.
+ */
+- (double)percentCompleteFromLine:(const char *)line length:(NSUInteger)length
+{
+    NSUInteger start = 0;
+    while (start < length && line[start] == ' ') {
+        start++;
+    }
+    
+    if (start == length || line[length - 1] != '%') {
+        return -1;
+    }
+    
+    NSUInteger numberStart = length - 1;
+    while (numberStart > start && ((line[numberStart - 1] >= '0' && line[numberStart - 1] <= '9') || line[numberStart - 1] == '.')) {
+        numberStart--;
+    }
+    
+    // before the first '#' is drawn the bar is padding and a percentage alone
+    BOOL isProgressBar = (line[start] == '#') || (start > 0 && numberStart == start);
+    NSUInteger numberLength = length - 1 - numberStart;
+    if (!isProgressBar || numberLength == 0 || numberLength > 8) {
+        return -1;
+    }
+    
+    char number[9];
+    memcpy(number, line + numberStart, numberLength);
+    number[numberLength] = '\0';
+    
+    return strtod(number, NULL);
+}
+
+@end
@@ -0,0 +1,140 @@
+//
+//  MRBrewSnapshot.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/** An `MRBrewSnapshot` object records the installed state of Homebrew formulae
+ * by reading the contents of the `Cellar`, `LinkedKegs` and `PinnedKegs`
+ * directories, and computes the changes to that state when given the paths at
+ * which file system events occurred.
+ *
+ * Only the parts of the snapshot affected by a path are read again: an event
+ * inside `Cellar/wget` rescans the versions of `wget` alone, an event in
+ * `Cellar` itself rescans the list of formula names, and `LinkedKegs` and
+ * `PinnedKegs` are each rescanned when an event occurs inside them. A snapshot
+ * therefore costs a handful of directory reads per event rather than a `brew`
+ * invocation.
+ *
+ * Assign a snapshot to an MRBrewWatcher's `snapshot` property to have the
+ * watcher deliver MRBrewChange objects to its delegate.
+ */
+@interface MRBrewSnapshot : NSObject
+
+/** The path of the Homebrew `Cellar` directory. */
+@property (readonly, copy) NSString *cellarPath;
+
+/** The path of the Homebrew `LinkedKegs` directory. */
+@property (readonly, copy) NSString *linkedKegsPath;
+
+/** The path of the Homebrew `PinnedKegs` directory. */
+@property (readonly, copy) NSString *pinnedKegsPath;
+
+/**-----------------------------------------------------------------------------
+ * @name Creating a Snapshot
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns an initialized `MRBrewSnapshot` object for the `Cellar`,
+ * `LinkedKegs` and `PinnedKegs` paths of `MRBrewLocations`' defaultLocations.
+ *
+ * The snapshot is empty until reload is called.
+ *
+ * @return A snapshot for the default Homebrew installation.
+ */
+- (instancetype)init;
+
+/** Returns an initialized `MRBrewSnapshot` object for the specified paths.
+ *
+ * The snapshot is empty until reload is called.
+ *
+ * @param cellarPath The absolute path of the Homebrew `Cellar` directory.
+ * @param linkedKegsPath The absolute path of the Homebrew `LinkedKegs`
+ * directory.
+ * @param pinnedKegsPath The absolute path of the Homebrew `PinnedKegs`
+ * directory.
+ * @return A snapshot for the specified paths.
+ */
+- (instancetype)initWithCellarPath:(NSString *)cellarPath linkedKegsPath:(NSString *)linkedKegsPath pinnedKegsPath:(NSString *)pinnedKegsPath;
+
+/** Returns a snapshot for the specified paths.
+ *
+ * @param cellarPath The absolute path of the Homebrew `Cellar` directory.
+ * @param linkedKegsPath The absolute path of the Homebrew `LinkedKegs`
+ * directory.
+ * @param pinnedKegsPath The absolute path of the Homebrew `PinnedKegs`
+ * directory.
+ * @return A snapshot for the specified paths.
+ */
++ (instancetype)snapshotWithCellarPath:(NSString *)cellarPath linkedKegsPath:(NSString *)linkedKegsPath pinnedKegsPath:(NSString *)pinnedKegsPath;
+
+/**-----------------------------------------------------------------------------
+ * @name Updating a Snapshot
+ * -----------------------------------------------------------------------------
+ */
+
+/** Reads the complete installed state, discarding the current contents of the
+ * receiver without computing any changes.
+ */
+- (void)reload;
+
+/** Rescans the parts of the receiver affected by the specified paths and
+ * returns the changes found.
+ *
+ * @param paths An array of strings containing the directory paths where file
+ * system events occurred, as delivered by MRBrewWatcher.
+ * @return An array of MRBrewChange objects, which is empty if the installed
+ * state has not changed.
+ */
+- (NSArray *)changesForPaths:(NSArray *)paths;
+
+/**-----------------------------------------------------------------------------
+ * @name Querying a Snapshot
+ * -----------------------------------------------------------------------------
+ */
+
+/** Returns the names of the installed formulae. */
+- (NSSet *)installedFormulaNames;
+
+/** Returns the installed versions of the named formula, or `nil` if it is not
+ * installed.
+ *
+ * @param name The name of the formula.
+ */
+- (NSSet *)versionsForFormula:(NSString *)name;
+
+/** Returns the linked version of the named formula, or `nil` if it is not
+ * linked.
+ *
+ * @param name The name of the formula.
+ */
+- (NSString *)linkedVersionForFormula:(NSString *)name;
+
+/** Indicates whether the named formula is pinned.
+ *
+ * @param name The name of the formula.
+ */
+- (BOOL)isFormulaPinned:(NSString *)name;
+
+@end
@@ -0,0 +1,345 @@
+//
+//  MRBrewSnapshot.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewSnapshot.h"
+#import "MRBrewChange.h"
+#import "MRBrewLocations.h"
+
+@interface MRBrewSnapshot ()
+{
+    @private
+    NSMutableDictionary *_versionsByName;
+    NSDictionary *_linkedVersionsByName;
+    NSDictionary *_pinnedVersionsByName;
+}
+
+@end
+
+/* Returns YES if path is equal to, or an ancestor of, otherPath. */
+static BOOL MRBrewPathContainsPath(NSString *path, NSString *otherPath)
+{
+    if ([otherPath isEqualToString:path]) {
+        return YES;
+    }
+    
+    NSString *prefix = [path hasSuffix:@"/"] ? path : [path stringByAppendingString:@"/"];
+    return [otherPath hasPrefix:prefix];
+}
+
+/* Returns the first path component of path below parentPath, e.g. `wget` for
+ * `Cellar/wget/1.15/bin`, or nil if path is not below parentPath.
+ */
+static NSString *MRBrewFirstComponentBelowPath(NSString *parentPath, NSString *path)
+{
+    if ([path isEqualToString:parentPath] || !MRBrewPathContainsPath(parentPath, path)) {
+        return nil;
+    }
+    
+    NSString *relativePath = [path substringFromIndex:[parentPath length] + 1];
+    NSRange separator = [relativePath rangeOfString:@"/"];
+    
+    return separator.location == NSNotFound ? relativePath : [relativePath substringToIndex:separator.location];
+}
+
+/* Returns the members of versions not present in excludedVersions, ordered
+ * from oldest to newest.
+ */
+static NSArray *MRBrewSortedVersions(NSSet *versions, NSSet *excludedVersions)
+{
+    NSMutableSet *result = [versions mutableCopy];
+    if (excludedVersions) {
+        [result minusSet:excludedVersions];
+    }
+    
+    return [[result allObjects] sortedArrayUsingComparator:^NSComparisonResult(NSString *a, NSString *b) {
+        return [a compare:b options:NSNumericSearch];
+    }];
+}
+
+static NSString *MRBrewVersionFromLink(id version)
+{
+    return [version isKindOfClass:[NSString class]] ? version : nil;
+}
+
+@implementation MRBrewSnapshot
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+    MRBrewLocations *locations = [MRBrewLocations defaultLocations];
+    
+    return [self initWithCellarPath:[locations cellarPath]
+                     linkedKegsPath:[locations linkedKegsPath]
+                     pinnedKegsPath:[locations pinnedKegsPath]];
+}
+
+- (instancetype)initWithCellarPath:(NSString *)cellarPath linkedKegsPath:(NSString *)linkedKegsPath pinnedKegsPath:(NSString *)pinnedKegsPath
+{
+    if (self = [super init]) {
+        _cellarPath = [[cellarPath stringByStandardizingPath] copy];
+        _linkedKegsPath = [[linkedKegsPath stringByStandardizingPath] copy];
+        _pinnedKegsPath = [[pinnedKegsPath stringByStandardizingPath] copy];
+        _versionsByName = [NSMutableDictionary dictionary];
+        _linkedVersionsByName = [NSDictionary dictionary];
+        _pinnedVersionsByName = [NSDictionary dictionary];
+    }
+    
+    return self;
+}
+
++ (instancetype)snapshotWithCellarPath:(NSString *)cellarPath linkedKegsPath:(NSString *)linkedKegsPath pinnedKegsPath:(NSString *)pinnedKegsPath
+{
+    return [[self alloc] initWithCellarPath:cellarPath
+                             linkedKegsPath:linkedKegsPath
+                             pinnedKegsPath:pinnedKegsPath];
+}
+
+#pragma mark - Updating
+
+- (void)reload
+{
+    @synchronized(self) {
+        [_versionsByName removeAllObjects];
+        
+        for (NSString *name in [self entriesAtPath:[self cellarPath]]) {
+            NSSet *versions = [self versionsAtPath:[[self cellarPath] stringByAppendingPathComponent:name]];
+            if ([versions count]) {
+                [_versionsByName setObject:versions forKey:name];
+            }
+        }
+        
+        _linkedVersionsByName = [self kegLinksAtPath:[self linkedKegsPath]];
+        _pinnedVersionsByName = [self kegLinksAtPath:[self pinnedKegsPath]];
+    }
+}
+
+- (NSArray *)changesForPaths:(NSArray *)paths
+{
+    NSMutableArray *changes = [NSMutableArray array];
+    NSMutableSet *namesToRescan = [NSMutableSet set];
+    BOOL rescanCellar = NO;
+    BOOL rescanLinkedKegs = NO;
+    BOOL rescanPinnedKegs = NO;
+    
+    // work out which parts of the snapshot each path can affect; a path that
+    // contains a watched directory (e.g. the prefix) may have replaced it
+    for (NSString *eventPath in paths) {
+        NSString *path = [eventPath stringByStandardizingPath];
+        
+        if (MRBrewPathContainsPath(path, [self cellarPath])) {
+            rescanCellar = YES;
+        }
+        else {
+            NSString *name = MRBrewFirstComponentBelowPath([self cellarPath], path);
+            if (name) {
+                [namesToRescan addObject:name];
+            }
+        }
+        
+        if (MRBrewPathContainsPath(path, [self linkedKegsPath]) || MRBrewPathContainsPath([self linkedKegsPath], path)) {
+            rescanLinkedKegs = YES;
+        }
+        
+        if (MRBrewPathContainsPath(path, [self pinnedKegsPath]) || MRBrewPathContainsPath([self pinnedKegsPath], path)) {
+            rescanPinnedKegs = YES;
+        }
+    }
+    
+    @synchronized(self) {
+        // a change to the Cellar itself only matters for formulae that have
+        // appeared or disappeared, which are then rescanned like any other
+        if (rescanCellar) {
+            NSMutableSet *currentNames = [NSMutableSet setWithArray:[self entriesAtPath:[self cellarPath]]];
+            NSSet *knownNames = [NSSet setWithArray:[_versionsByName allKeys]];
+            
+            NSMutableSet *removedNames = [knownNames mutableCopy];
+            [removedNames minusSet:currentNames];
+            [currentNames minusSet:knownNames];
+            
+            [namesToRescan unionSet:currentNames];
+            [namesToRescan unionSet:removedNames];
+        }
+        
+        NSArray *sortedNames = [[namesToRescan allObjects] sortedArrayUsingSelector:@selector(compare:)];
+        for (NSString *name in sortedNames) {
+            [self rescanFormula:name changes:changes];
+        }
+        
+        if (rescanLinkedKegs) {
+            NSDictionary *linked = [self kegLinksAtPath:[self linkedKegsPath]];
+            [self diffKegLinks:_linkedVersionsByName
+                    withLinks:linked
+                    addedType:MRBrewChangeFormulaLinked
+                  removedType:MRBrewChangeFormulaUnlinked
+                      changes:changes];
+            _linkedVersionsByName = linked;
+        }
+        
+        if (rescanPinnedKegs) {
+            NSDictionary *pinned = [self kegLinksAtPath:[self pinnedKegsPath]];
+            [self diffKegLinks:_pinnedVersionsByName
+                    withLinks:pinned
+                    addedType:MRBrewChangeFormulaPinned
+                  removedType:MRBrewChangeFormulaUnpinned
+                      changes:changes];
+            _pinnedVersionsByName = pinned;
+        }
+    }
+    
+    return changes;
+}
+
+/* Reads the installed versions of the named formula and appends the changes
+ * since the previous read. A formula directory without any versions, such as
+ * one part way through an install, is treated as not installed.
+ */
+- (void)rescanFormula:(NSString *)name changes:(NSMutableArray *)changes
+{
+    NSSet *oldVersions = [_versionsByName objectForKey:name];
+    NSSet *newVersions = [self versionsAtPath:[[self cellarPath] stringByAppendingPathComponent:name]];
+    
+    if (![oldVersions count] && ![newVersions count]) {
+        return;
+    }
+    
+    if (![newVersions count]) {
+        [changes addObject:[MRBrewChange changeWithType:MRBrewChangeFormulaRemoved formulaName:name version:nil]];
+        [_versionsByName removeObjectForKey:name];
+        return;
+    }
+    
+    NSArray *addedVersions = MRBrewSortedVersions(newVersions, oldVersions);
+    
+    if (![oldVersions count]) {
+        // the newest version is reported as the install, any others as
+        // additional versions
+        NSString *installedVersion = [addedVersions lastObject];
+        [changes addObject:[MRBrewChange changeWithType:MRBrewChangeFormulaInstalled formulaName:name version:installedVersion]];
+        addedVersions = [addedVersions subarrayWithRange:NSMakeRange(0, [addedVersions count] - 1)];
+    }
+    
+    for (NSString *version in addedVersions) {
+        [changes addObject:[MRBrewChange changeWithType:MRBrewChangeVersionAdded formulaName:name version:version]];
+    }
+    
+    for (NSString *version in MRBrewSortedVersions(oldVersions, newVersions)) {
+        [changes addObject:[MRBrewChange changeWithType:MRBrewChangeVersionRemoved formulaName:name version:version]];
+    }
+    
+    [_versionsByName setObject:newVersions forKey:name];
+}
+
+- (void)diffKegLinks:(NSDictionary *)oldLinks withLinks:(NSDictionary *)newLinks addedType:(MRBrewChangeType)addedType removedType:(MRBrewChangeType)removedType changes:(NSMutableArray *)changes
+{
+    NSMutableSet *names = [NSMutableSet setWithArray:[oldLinks allKeys]];
+    [names addObjectsFromArray:[newLinks allKeys]];
+    
+    for (NSString *name in [[names allObjects] sortedArrayUsingSelector:@selector(compare:)]) {
+        id oldVersion = [oldLinks objectForKey:name];
+        id newVersion = [newLinks objectForKey:name];
+        
+        if (newVersion && ![newVersion isEqual:oldVersion]) {
+            [changes addObject:[MRBrewChange changeWithType:addedType formulaName:name version:MRBrewVersionFromLink(newVersion)]];
+        }
+        else if (!newVersion) {
+            [changes addObject:[MRBrewChange changeWithType:removedType formulaName:name version:MRBrewVersionFromLink(oldVersion)]];
+        }
+    }
+}
+
+#pragma mark - Querying
+
+- (NSSet *)installedFormulaNames
+{
+    @synchronized(self) {
+        return [NSSet setWithArray:[_versionsByName allKeys]];
+    }
+}
+
+- (NSSet *)versionsForFormula:(NSString *)name
+{
+    @synchronized(self) {
+        return [_versionsByName objectForKey:name];
+    }
+}
+
+- (NSString *)linkedVersionForFormula:(NSString *)name
+{
+    @synchronized(self) {
+        return MRBrewVersionFromLink([_linkedVersionsByName objectForKey:name]);
+    }
+}
+
+- (BOOL)isFormulaPinned:(NSString *)name
+{
+    @synchronized(self) {
+        return [_pinnedVersionsByName objectForKey:name] != nil;
+    }
+}
+
+#pragma mark - File System
+
+/* Returns the names of the visible entries in the directory at path, or an
+ * empty array if the directory does not exist.
+ */
+- (NSArray *)entriesAtPath:(NSString *)path
+{
+    NSArray *contents = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:path error:NULL];
+    NSMutableArray *entries = [NSMutableArray arrayWithCapacity:[contents count]];
+    
+    for (NSString *entry in contents) {
+        if (![entry hasPrefix:@"."]) {
+            [entries addObject:entry];
+        }
+    }
+    
+    return entries;
+}
+
+- (NSSet *)versionsAtPath:(NSString *)kegPath
+{
+    return [NSSet setWithArray:[self entriesAtPath:kegPath]];
+}
+
+/* Returns a dictionary mapping each formula name in a `LinkedKegs` or
+ * `PinnedKegs` directory to the version its symbolic link points to, or to
+ * NSNull if the entry is not a link.
+ */
+- (NSDictionary *)kegLinksAtPath:(NSString *)path
+{
+    NSMutableDictionary *links = [NSMutableDictionary dictionary];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    
+    for (NSString *name in [self entriesAtPath:path]) {
+        NSString *destination = [fileManager destinationOfSymbolicLinkAtPath:[path stringByAppendingPathComponent:name] error:NULL];
+        id version = destination ? [destination lastPathComponent] : [NSNull null];
+        [links setObject:version forKey:name];
+    }
+    
+    return links;
+}
+
+@end
@@ -0,0 +1,62 @@
+//
+//  MRBrewVersion.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/** The `MRBrewVersion` class compares formula versions following Homebrew's
+ * ordering rules, and detects the version of a formula from the URL of its
+ * source.
+ *
+ * A version is compared token by token, where each token is a run of digits or
+ * a run of letters with any digits that follow it. Numeric tokens compare by
+ * value, so `1.10` is newer than `1.9`. Pre-release tokens such as `alpha1`,
+ * `b2`, `pre3` and `rc4` are older than a release, in that order, and a patch
+ * token such as `p1` is newer than its release but older than a further numeric
+ * component. A missing token is equivalent to `0`, so `1.0` and `1.0.0` are
+ * equal.
+ *
+ * Versions of installed kegs may carry a revision, such as the `_1` of
+ * `1.2.3_1`, which is compared after the rest of the version.
+ */
+@interface MRBrewVersion : NSObject
+
+/** Compares two versions.
+ *
+ * @param version A version, optionally followed by a revision.
+ * @param otherVersion The version with which to compare _version_.
+ * @return `NSOrderedAscending` if _version_ is older than _otherVersion_,
+ * `NSOrderedDescending` if it is newer, or `NSOrderedSame` if they are equal.
+ */
++ (NSComparisonResult)compareVersion:(NSString *)version toVersion:(NSString *)otherVersion;
+
+/** Returns the version detected in the file name of a source URL, such as
+ * `1.15` for `http://ftpmirror.gnu.org/wget/wget-1.15.tar.xz`.
+ *
+ * @param URLString The URL of a formula's source archive.
+ * @return The version detected in the URL, or `nil` if none is found.
+ */
++ (NSString *)versionFromURLString:(NSString *)URLString;
+
+@end
@@ -0,0 +1,263 @@
+//
+//  MRBrewVersion.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewVersion.h"
+
+/* The kinds of token a version is divided into. Pre-release and patch tokens
+ * are composite tokens of letters followed by a number.
+ */
+typedef NS_ENUM(NSInteger, MRBrewVersionTokenKind) {
+    MRBrewVersionTokenNull,
+    MRBrewVersionTokenNumeric,
+    MRBrewVersionTokenString,
+    MRBrewVersionTokenAlpha,
+    MRBrewVersionTokenBeta,
+    MRBrewVersionTokenPre,
+    MRBrewVersionTokenRC,
+    MRBrewVersionTokenPatch
+};
+
+typedef struct {
+    MRBrewVersionTokenKind kind;
+    unsigned long long number;
+    NSRange range;
+} MRBrewVersionToken;
+
+static inline BOOL MRBrewVersionTokenIsComposite(MRBrewVersionToken token)
+{
+    return token.kind >= MRBrewVersionTokenAlpha;
+}
+
+/* Divides a version into tokens, returning the number of tokens written. */
+static NSUInteger MRBrewVersionTokenize(const char *version, NSUInteger length, MRBrewVersionToken *tokens, NSUInteger maximumCount)
+{
+    NSUInteger count = 0;
+    NSUInteger i = 0;
+    
+    while (i < length && count < maximumCount) {
+        if (isdigit((unsigned char)version[i])) {
+            NSUInteger start = i;
+            unsigned long long number = 0;
+            while (i < length && isdigit((unsigned char)version[i])) {
+                number = number * 10 + (unsigned long long)(version[i++] - '0');
+            }
+            tokens[count++] = (MRBrewVersionToken){MRBrewVersionTokenNumeric, number, NSMakeRange(start, i - start)};
+        }
+        else if (isalpha((unsigned char)version[i])) {
+            NSUInteger start = i;
+            while (i < length && isalpha((unsigned char)version[i])) {
+                i++;
+            }
+            NSUInteger lettersLength = i - start;
+            NSUInteger digitsStart = i;
+            unsigned long long number = 0;
+            while (i < length && isdigit((unsigned char)version[i])) {
+                number = number * 10 + (unsigned long long)(version[i++] - '0');
+            }
+            
+            // letters are only a pre-release or patch marker when followed by
+            // a number, as in 1.0b2 or 1.0p1
+            MRBrewVersionTokenKind kind = MRBrewVersionTokenString;
+            if (i > digitsStart) {
+                const char *letters = version + start;
+                if ((lettersLength == 5 && strncasecmp(letters, "alpha", 5) == 0) || (lettersLength == 1 && tolower((unsigned char)*letters) == 'a')) {
+                    kind = MRBrewVersionTokenAlpha;
+                }
+                else if ((lettersLength == 4 && strncasecmp(letters, "beta", 4) == 0) || (lettersLength == 1 && tolower((unsigned char)*letters) == 'b')) {
+                    kind = MRBrewVersionTokenBeta;
+                }
+                else if (lettersLength == 3 && strncasecmp(letters, "pre", 3) == 0) {
+                    kind = MRBrewVersionTokenPre;
+                }
+                else if (lettersLength == 2 && strncasecmp(letters, "rc", 2) == 0) {
+                    kind = MRBrewVersionTokenRC;
+                }
+                else if (lettersLength == 1 && tolower((unsigned char)*letters) == 'p') {
+                    kind = MRBrewVersionTokenPatch;
+                }
+            }
+            tokens[count++] = (MRBrewVersionToken){kind, number, NSMakeRange(start, i - start)};
+        }
+        else {
+            i++;
+        }
+    }
+    
+    return count;
+}
+
+static inline NSComparisonResult MRBrewCompareNumbers(unsigned long long number, unsigned long long otherNumber)
+{
+    if (number == otherNumber) {
+        return NSOrderedSame;
+    }
+    
+    return number < otherNumber ? NSOrderedAscending : NSOrderedDescending;
+}
+
+static NSComparisonResult MRBrewCompareTokenText(const char *version, MRBrewVersionToken token, const char *otherVersion, MRBrewVersionToken otherToken)
+{
+    int result = strncmp(version + token.range.location, otherVersion + otherToken.range.location, MIN(token.range.length, otherToken.range.length));
+    if (result == 0) {
+        return MRBrewCompareNumbers(token.range.length, otherToken.range.length);
+    }
+    
+    return result < 0 ? NSOrderedAscending : NSOrderedDescending;
+}
+
+static NSComparisonResult MRBrewCompareTokens(const char *version, MRBrewVersionToken token, const char *otherVersion, MRBrewVersionToken otherToken)
+{
+    // a missing token is equivalent to zero, newer than a pre-release and
+    // older than anything else
+    if (token.kind == MRBrewVersionTokenNull || otherToken.kind == MRBrewVersionTokenNull) {
+        if (token.kind == otherToken.kind) {
+            return NSOrderedSame;
+        }
+        
+        MRBrewVersionToken presentToken = (token.kind == MRBrewVersionTokenNull) ? otherToken : token;
+        NSComparisonResult nullResult;
+        if (presentToken.kind == MRBrewVersionTokenNumeric) {
+            nullResult = presentToken.number == 0 ? NSOrderedSame : NSOrderedAscending;
+        }
+        else if (MRBrewVersionTokenIsComposite(presentToken) && presentToken.kind != MRBrewVersionTokenPatch) {
+            nullResult = NSOrderedDescending;
+        }
+        else {
+            nullResult = NSOrderedAscending;
+        }
+        
+        return (token.kind == MRBrewVersionTokenNull) ? nullResult : (NSComparisonResult)-nullResult;
+    }
+    
+    if (token.kind == MRBrewVersionTokenNumeric && otherToken.kind == MRBrewVersionTokenNumeric) {
+        return MRBrewCompareNumbers(token.number, otherToken.number);
+    }
+    
+    // numbers are newer than any letters
+    if (token.kind == MRBrewVersionTokenNumeric) {
+        return NSOrderedDescending;
+    }
+    if (otherToken.kind == MRBrewVersionTokenNumeric) {
+        return NSOrderedAscending;
+    }
+    
+    if (MRBrewVersionTokenIsComposite(token) && MRBrewVersionTokenIsComposite(otherToken)) {
+        if (token.kind != otherToken.kind) {
+            return token.kind < otherToken.kind ? NSOrderedAscending : NSOrderedDescending;
+        }
+        return MRBrewCompareNumbers(token.number, otherToken.number);
+    }
+    
+    return MRBrewCompareTokenText(version, token, otherVersion, otherToken);
+}
+
+/* Splits a keg version such as 1.2.3_1 into its version and revision. */
+static NSString *MRBrewVersionWithoutRevision(NSString *version, NSUInteger *revision)
+{
+    *revision = 0;
+    
+    NSRange separator = [version rangeOfString:@"_" options:NSBackwardsSearch];
+    if (separator.location == NSNotFound || separator.location == 0 || NSMaxRange(separator) == [version length]) {
+        return version;
+    }
+    
+    NSString *suffix = [version substringFromIndex:NSMaxRange(separator)];
+    if ([suffix rangeOfCharacterFromSet:[[NSCharacterSet decimalDigitCharacterSet] invertedSet]].location != NSNotFound) {
+        return version;
+    }
+    
+    *revision = (NSUInteger)[suffix integerValue];
+    
+    return [version substringToIndex:separator.location];
+}
+
+/* Versions with more tokens than this are compared on their first tokens. */
+enum {
+    MRBrewVersionMaximumTokenCount = 32
+};
+
+@implementation MRBrewVersion
+
++ (NSComparisonResult)compareVersion:(NSString *)version toVersion:(NSString *)otherVersion
+{
+    NSUInteger revision, otherRevision;
+    const char *bytes = [MRBrewVersionWithoutRevision(version, &revision) UTF8String];
+    const char *otherBytes = [MRBrewVersionWithoutRevision(otherVersion, &otherRevision) UTF8String];
+    
+    MRBrewVersionToken tokens[MRBrewVersionMaximumTokenCount];
+    MRBrewVersionToken otherTokens[MRBrewVersionMaximumTokenCount];
+    NSUInteger count = MRBrewVersionTokenize(bytes, strlen(bytes), tokens, MRBrewVersionMaximumTokenCount);
+    NSUInteger otherCount = MRBrewVersionTokenize(otherBytes, strlen(otherBytes), otherTokens, MRBrewVersionMaximumTokenCount);
+    
+    MRBrewVersionToken nullToken = {MRBrewVersionTokenNull, 0, NSMakeRange(0, 0)};
+    for (NSUInteger i = 0; i < MAX(count, otherCount); i++) {
+        NSComparisonResult result = MRBrewCompareTokens(bytes, (i < count ? tokens[i] : nullToken), otherBytes, (i < otherCount ? otherTokens[i] : nullToken));
+        if (result != NSOrderedSame) {
+            return result;
+        }
+    }
+    
+    return MRBrewCompareNumbers(revision, otherRevision);
+}
+
++ (NSString *)versionFromURLString:(NSString *)URLString
+{
+    static NSArray *extensions = nil;
+    static NSRegularExpression *stemExpression = nil;
+    static NSRegularExpression *suffixExpression = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        extensions = @[@".tar.gz", @".tar.bz2", @".tar.xz", @".tar.lz", @".tgz", @".tbz", @".tbz2", @".txz", @".zip", @".tar", @".gz", @".bz2", @".xz", @".7z", @".jar", @".dmg", @".pkg"];
+        
+        // a file name that is a version alone, as in GitHub's archive URLs
+        stemExpression = [NSRegularExpression regularExpressionWithPattern:@"^v?(\\d+(?:\\.\\d+)*[a-z]?\\d*)$" options:NSRegularExpressionCaseInsensitive error:NULL];
+        
+        // a version following the name, as in wget-1.15, openssl-1.0.1f,
+        // boost_1_55_0 or p7zip_9.20.1_src_all
+        suffixExpression = [NSRegularExpression regularExpressionWithPattern:@"[-_]v?(\\d+(?:[._]\\d+)*(?:-?(?:alpha|beta|rc|pre|a|b|p)\\d+)?[a-z]?)(?:[-_.][a-z]+)*$" options:NSRegularExpressionCaseInsensitive error:NULL];
+    });
+    
+    NSString *stem = [[[URLString componentsSeparatedByString:@"?"] firstObject] lastPathComponent];
+    for (NSString *extension in extensions) {
+        if ([[stem lowercaseString] hasSuffix:extension]) {
+            stem = [stem substringToIndex:[stem length] - [extension length]];
+            break;
+        }
+    }
+    
+    for (NSRegularExpression *expression in @[stemExpression, suffixExpression]) {
+        NSTextCheckingResult *match = [expression firstMatchInString:stem options:0 range:NSMakeRange(0, [stem length])];
+        if (match) {
+            // versions separated by underscores, as in boost_1_55_0, are
+            // written with dots since an underscore introduces a revision
+            NSString *version = [stem substringWithRange:[match rangeAtIndex:1]];
+            return [version stringByReplacingOccurrencesOfString:@"_" withString:@"."];
+        }
+    }
+    
+    return nil;
+}
+
+@end
@@ -25,6 +25,9 @@
 
 #import <Foundation/Foundation.h>
 #import "MRBrewWatcherDelegate.h"
+#import "MRBrewWatcherBackend.h"
+
+@class MRBrewSnapshot;
 
 /** These constants indicate the location to watch for events. */
 typedef NS_OPTIONS(NSInteger, MRBrewWatcherLocation) {
@@ -39,7 +42,9 @@ typedef NS_OPTIONS(NSInteger, MRBrewWatcherLocation) {
     /** The Homebrew `LinkedKegs` path */
     MRBrewWatcherLinkedKegsLocation = 1 << 4,
     /** The Homebrew `PinnedKegs` path */
-    MRBrewWatcherPinnedKegsLocation = 1 << 5
+    MRBrewWatcherPinnedKegsLocation = 1 << 5,
+    /** The Homebrew `Cellar` path */
+    MRBrewWatcherCellarLocation     = 1 << 6
 };
 
 /** An `MRBrewWatcher` waits for a file system event (e.g. file modification,
@@ -60,30 +65,90 @@ typedef NS_OPTIONS(NSInteger, MRBrewWatcherLocation) {
    MRBrewWatcherAliasesLocation
    MRBrewWatcherLinkedKegsLocation
    MRBrewWatcherPinnedKegsLocation
+   MRBrewWatcherCellarLocation
  
- These constants represent the default Homebrew paths for the named locations,
- and can be combined using the C-Bitwise OR operator in order to watch multiple
- locations for events with a single watcher object.
+ These constants represent the named locations of the Homebrew installation
+ described by `MRBrewLocations`' defaultLocations, and can be combined using the
+ C-Bitwise OR operator in order to watch multiple locations for events with a
+ single watcher object.
  
- If you have installed Homebrew outside of the default path, create your watcher
- object using either initWithPath:delegate: or watcherWithPath:delegate: and
- specify the absolute path to the directory to watch for events.
+ The default installation is the one found on the `PATH` or at one of the
+ well-known prefixes, wherever it is installed. To watch another installation,
+ or any other directory, create your watcher object using either
+ initWithPath:delegate: or watcherWithPath:delegate: and specify the absolute
+ path to the directory to watch for events.
  
  To start watching for events call the startWatching method, and to stop
  watching call the stopWatching method.
  
- @warning After starting a watcher object, calls to the MRBrew class method
- performOperation:delegate: may result in file system events occurring at the
- watched location, which will trigger a delegate callback. If you are only
- interested in external events then you should stop the watcher object prior to
- calling performOperation:delegate: and restart it once the operation has
- completed.
+ Events are observed using FSEvents on OS X and inotify on Linux (see
+ MRBrewWatcherBackend), and are coalesced for the interval specified by the
+ latency property before the delegate is informed of them. Every delegate
+ message is sent on the queue specified by the callbackQueue property.
+ 
+ To receive the changes to installed formulae rather than the paths where
+ events occurred, watch the `Cellar`, `LinkedKegs` and `PinnedKegs` locations
+ and assign an MRBrewSnapshot to the snapshot property. The delegate is then
+ sent brewChangesDidOccur: with the MRBrewChange objects computed from each
+ batch of events.
+ 
+ Operations performed by MRBrew, such as installing a formula, cause file system
+ events at the watched locations. If you are only interested in external events,
+ set the suppressesOperationEvents property to `YES`: events in the kegs and
+ links of an operation's formula (e.g. `Cellar/wget` and `LinkedKegs/wget` while
+ installing wget) are then attributed to that operation and reported once,
+ through brewOperation:didChangePaths:changes:, shortly after the operation
+ exits. Events in the `Cellar`, `LinkedKegs`, `PinnedKegs` and `opt` directories
+ themselves are only attributed to the operation when the snapshot finds a
+ change to its formula. All other events are reported as they occur.
+ 
+ @warning An operation without a formula, such as `update`, may change any
+ formula, so while one is running every event not attributed to an operation on
+ a formula is attributed to it. Links into the prefix, such as those in `bin`,
+ are not attributed to any operation.
  */
 @interface MRBrewWatcher : NSObject
 
 /** The delegate object for this watcher. */
 @property (weak) id<MRBrewWatcherDelegate> delegate;
 
+/** The interval, in seconds, for which file system events are coalesced before
+ * the delegate is informed of them. The default latency is 3.0 seconds. Changes
+ * take effect the next time the receiver starts watching.
+ */
+@property (assign) NSTimeInterval latency;
+
+/** The backend used to observe the file system. By default this is an
+ * `MRBrewFSEventsWatcherBackend` on OS X or an `MRBrewInotifyWatcherBackend` on
+ * Linux. Changes take effect the next time the receiver starts watching.
+ */
+@property (strong) id<MRBrewWatcherBackend> backend;
+
+/** The snapshot of installed formulae maintained by this watcher, or `nil` if
+ * the watcher only reports paths. The snapshot is reloaded each time the
+ * receiver starts watching and updated from the paths of each batch of events.
+ */
+@property (strong) MRBrewSnapshot *snapshot;
+
+/** The queue on which every delegate message is sent. The default queue is
+ * the main queue.
+ *
+ * If `nil`, messages are sent on the thread that observed the events: the
+ * backend's thread for brewChangeDidOccur: and brewChangesDidOccur:, and a
+ * global dispatch queue for brewOperation:didChangePaths:changes:. Use a
+ * serial queue other than the main queue if the main run loop does not run,
+ * e.g. in a command line tool.
+ */
+@property (strong) NSOperationQueue *callbackQueue;
+
+/** A boolean value indicating whether events caused by MRBrew operations are
+ * withheld from brewChangeDidOccur: and brewChangesDidOccur:, and instead
+ * reported once per operation through brewOperation:didChangePaths:changes:.
+ * Operations that only read from Homebrew (list, search, info, options and
+ * outdated) are not attributed any events. The default value is `NO`.
+ */
+@property (assign) BOOL suppressesOperationEvents;
+
 /**-----------------------------------------------------------------------------
  * @name Initialising a Watcher
  * -----------------------------------------------------------------------------
@@ -141,8 +206,12 @@ typedef NS_OPTIONS(NSInteger, MRBrewWatcherLocation) {
  * -----------------------------------------------------------------------------
  */
 
-/** Causes the receiver to start watching for file system events. */
-- (void)startWatching;
+/** Causes the receiver to start watching for file system events.
+ *
+ * @return `YES` if the receiver started watching, or `NO` if its backend could
+ * not start (e.g. because no inotify instance could be created).
+ */
+- (BOOL)startWatching;
 
 /** Causes the receiver to stop watching for file system events. */
 - (void)stopWatching;
@@ -24,23 +24,56 @@
 //
 
 #import "MRBrewWatcher.h"
+#import "MRBrewFSEventsWatcherBackend.h"
+#import "MRBrewInotifyWatcherBackend.h"
+#import "MRBrewSnapshot.h"
+#import "MRBrewOperation.h"
+#import "MRBrewConstants.h"
+#import "MRBrewLocations.h"
+#import "MRBrewFormula.h"
+#import "MRBrewChange.h"
 
-NSString * const MRBrewLibraryLocationPath = @"/usr/local/Library";
-NSString * const MRBrewFormulaLocationPath = @"/usr/local/Library/Formula";
-NSString * const MRBrewTapsLocationPath = @"/usr/local/Library/Taps";
-NSString * const MRBrewAliasesLocationPath = @"/usr/local/Library/Aliases";
-NSString * const MRBrewLinkedKegsLocationPath = @"/usr/local/Library/LinkedKegs";
-NSString * const MRBrewPinnedKegsLocationPath = @"/usr/local/Library/PinnedKegs";
+static const NSTimeInterval MRBrewWatcherDefaultLatency = 3.0;
+
+// time allowed beyond the latency for an operation's last events to arrive
+static const NSTimeInterval MRBrewWatcherAttributionGracePeriod = 0.5;
+
+/* Collects the paths and changes attributed to a running operation. */
+@interface MRBrewWatcherAttribution : NSObject
+
+@property (strong) MRBrewOperation *operation;
+@property (copy) NSString *formulaName;
+@property (copy) NSArray *kegPaths;
+@property (strong) NSMutableOrderedSet *paths;
+@property (strong) NSMutableArray *changes;
+
+@end
+
+@implementation MRBrewWatcherAttribution
+
+@end
 
 @interface MRBrewWatcher ()
 {
     @private
-    FSEventStreamRef _eventStream;
     NSMutableArray *_pathsToWatch;
+    NSMutableArray *_attributions;
+    NSArray *_kegDirectoryPaths;
 }
 
 @end
 
+/* Returns YES if path is equal to, or an ancestor of, otherPath. */
+static BOOL MRBrewWatcherPathContainsPath(NSString *path, NSString *otherPath)
+{
+    if ([otherPath isEqualToString:path]) {
+        return YES;
+    }
+    
+    NSString *prefix = [path hasSuffix:@"/"] ? path : [path stringByAppendingString:@"/"];
+    return [otherPath hasPrefix:prefix];
+}
+
 @implementation MRBrewWatcher
 
 #pragma mark - Lifecycle
@@ -54,37 +87,50 @@ NSString * const MRBrewPinnedKegsLocationPath = @"/usr/local/Library/PinnedKegs"
     self = [super init];
     
     if (self) {
+        MRBrewLocations *locations = [MRBrewLocations defaultLocations];
+        
         // test bitmask for paths to use
         _pathsToWatch = [NSMutableArray array];
         if (location & MRBrewWatcherLibraryLocation) {
-            [_pathsToWatch addObject:MRBrewLibraryLocationPath];
+            [_pathsToWatch addObject:[locations libraryPath]];
         }
         // since the library path contains all other paths we test
         // this exclusively and only test for other options in the
         // else clause if the library location bit has not been set
         else {
             if (location & MRBrewWatcherFormulaLocation) {
-                [_pathsToWatch addObject:MRBrewFormulaLocationPath];
+                [_pathsToWatch addObject:[locations formulaPath]];
             }
             
             if (location & MRBrewWatcherTapsLocation) {
-                [_pathsToWatch addObject:MRBrewTapsLocationPath];
+                [_pathsToWatch addObject:[locations tapsPath]];
             }
             
             if (location & MRBrewWatcherAliasesLocation) {
-                [_pathsToWatch addObject:MRBrewAliasesLocationPath];
+                [_pathsToWatch addObject:[locations aliasesPath]];
             }
             
             if (location & MRBrewWatcherLinkedKegsLocation) {
-                [_pathsToWatch addObject:MRBrewLinkedKegsLocationPath];
+                [_pathsToWatch addObject:[locations linkedKegsPath]];
             }
             
             if (location & MRBrewWatcherPinnedKegsLocation) {
-                [_pathsToWatch addObject:MRBrewPinnedKegsLocationPath];
+                [_pathsToWatch addObject:[locations pinnedKegsPath]];
             }
         }
         
+        // the cellar is a sibling of the library rather than a child
+        if (location & MRBrewWatcherCellarLocation) {
+            [_pathsToWatch addObject:[locations cellarPath]];
+        }
+        
         _delegate = delegate;
+        _latency = MRBrewWatcherDefaultLatency;
+        _callbackQueue = [NSOperationQueue mainQueue];
+        _backend = [[self class] defaultBackend];
+        _attributions = [NSMutableArray array];
+        _kegDirectoryPaths = [[self class] kegDirectoryPaths];
+        [self registerForOperationNotifications];
     }
     
     return self;
@@ -98,6 +144,12 @@ NSString * const MRBrewPinnedKegsLocationPath = @"/usr/local/Library/PinnedKegs"
         _pathsToWatch = [NSMutableArray array];
         [_pathsToWatch addObject:path];
         _delegate = delegate;
+        _latency = MRBrewWatcherDefaultLatency;
+        _callbackQueue = [NSOperationQueue mainQueue];
+        _backend = [[self class] defaultBackend];
+        _attributions = [NSMutableArray array];
+        _kegDirectoryPaths = [[self class] kegDirectoryPaths];
+        [self registerForOperationNotifications];
     }
     
     return self;
@@ -113,74 +165,285 @@ NSString * const MRBrewPinnedKegsLocationPath = @"/usr/local/Library/PinnedKegs"
     return [[self alloc] initWithPath:path delegate:delegate];
 }
 
-#pragma mark - FSEvents Callback
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+/* Returns a new instance of the backend appropriate for the current platform.
+ */
++ (id<MRBrewWatcherBackend>)defaultBackend
+{
+#if defined(__linux__)
+    return [[MRBrewInotifyWatcherBackend alloc] init];
+#else
+    return [[MRBrewFSEventsWatcherBackend alloc] init];
+#endif
+}
+
+/* Returns the directories containing an entry for each installed formula,
+ * whose own events cannot be attributed from their path alone.
+ */
++ (NSArray *)kegDirectoryPaths
+{
+    MRBrewLocations *locations = [MRBrewLocations defaultLocations];
+    
+    return @[[[locations cellarPath] stringByStandardizingPath],
+             [[locations linkedKegsPath] stringByStandardizingPath],
+             [[locations pinnedKegsPath] stringByStandardizingPath],
+             [[[locations prefixPath] stringByAppendingPathComponent:@"opt"] stringByStandardizingPath]];
+}
 
-static void fileSystemEventsCallback(ConstFSEventStreamRef streamRef, void *userData, size_t numEvents, void *eventPaths, const FSEventStreamEventFlags eventFlags[], const FSEventStreamEventId eventIds[])
+#pragma mark - Control
+
+- (BOOL)startWatching
 {
-    MRBrewWatcher *informer = (__bridge MRBrewWatcher *)userData;
+    // stop existing backend if one is running
+    if ([self isWatching]) {
+        [self stopWatching];
+    }
     
-    NSMutableArray *modifiedPaths = [NSMutableArray array];
+    // take a fresh snapshot since changes made while we were not
+    // watching will not be reported
+    [[self snapshot] reload];
     
-    size_t i;
-    for(i = 0; i < numEvents; i++){
-        if(![modifiedPaths containsObject:[(__bridge NSArray *)eventPaths objectAtIndex:i]]) {
-            [modifiedPaths addObject:[(__bridge NSArray *)eventPaths objectAtIndex:i]];
+    __weak MRBrewWatcher *weakSelf = self;
+    return [[self backend] startWatchingPaths:_pathsToWatch latency:[self latency] handler:^(NSArray *paths) {
+        [weakSelf handleChangesAtPaths:paths];
+    }];
+}
+
+- (void)stopWatching
+{
+    [[self backend] stopWatching];
+}
+
+- (BOOL)isWatching {
+    return [[self backend] isWatching];
+}
+
+#pragma mark - Event Handling
+
+- (void)handleChangesAtPaths:(NSArray *)paths
+{
+    // the snapshot is always updated, so that changes made by an operation
+    // are not reported again by a later event
+    MRBrewSnapshot *snapshot = [self snapshot];
+    NSArray *changes = snapshot ? [snapshot changesForPaths:paths] : @[];
+    
+    NSMutableArray *externalPaths = [NSMutableArray array];
+    NSMutableArray *externalChanges = [NSMutableArray array];
+    
+    @synchronized(self) {
+        // changes are attributed first, so that events in the directories shared
+        // by every formula can be attributed to the formula that changed
+        NSMutableSet *changedNames = [NSMutableSet set];
+        for (MRBrewChange *change in changes) {
+            MRBrewWatcherAttribution *attribution = [self attributionForFormulaName:[change formulaName]];
+            if (attribution) {
+                [[attribution changes] addObject:change];
+                [changedNames addObject:[change formulaName]];
+            }
+            else {
+                [externalChanges addObject:change];
+            }
+        }
+        
+        for (NSString *path in paths) {
+            MRBrewWatcherAttribution *attribution = [self attributionForPath:[path stringByStandardizingPath] changedNames:changedNames];
+            if (attribution) {
+                [[attribution paths] addObject:path];
+            }
+            else {
+                [externalPaths addObject:path];
+            }
         }
     }
     
-    if ([[informer delegate] respondsToSelector:@selector(brewChangeDidOccur:)]) {
-        [[informer delegate] brewChangeDidOccur:modifiedPaths];
+    if ([externalPaths count]) {
+        [self notifyDelegateChangeDidOccur:externalPaths];
+    }
+    
+    if ([externalChanges count]) {
+        [self notifyDelegateChangesDidOccur:externalChanges];
     }
 }
 
-#pragma mark - Control
+/* Returns the attribution for the operation on the named formula, or the first
+ * attribution for an operation without a formula, which may change any formula.
+ * Must be called while synchronized on the receiver.
+ */
+- (MRBrewWatcherAttribution *)attributionForFormulaName:(NSString *)name
+{
+    MRBrewWatcherAttribution *unrestrictedAttribution = nil;
+    
+    for (MRBrewWatcherAttribution *attribution in _attributions) {
+        if (![attribution formulaName]) {
+            if (!unrestrictedAttribution) {
+                unrestrictedAttribution = attribution;
+            }
+        }
+        else if ([[attribution formulaName] isEqualToString:name]) {
+            return attribution;
+        }
+    }
+    
+    return unrestrictedAttribution;
+}
 
-- (void)startWatching
-{
-    // stop existing event stream if one exists
-    if (_eventStream) {
-		[self stopWatching];
-	}
-    
-    // create an event stream context with a reference to this
-    // watcher object for use by our callback method
-    FSEventStreamContext eventStreamContext;
-    eventStreamContext.info = (__bridge void *)(self);
-    eventStreamContext.version = 0;
-    eventStreamContext.retain = NULL;
-    eventStreamContext.release = NULL;
-    eventStreamContext.copyDescription = NULL;
-    
-    // create an event stream and register a callback
-    NSTimeInterval latency = 3.0;
-    _eventStream = FSEventStreamCreate(NULL,
-                                       &fileSystemEventsCallback,
-                                       &eventStreamContext,
-                                       (__bridge CFArrayRef) _pathsToWatch,
-                                       kFSEventStreamEventIdSinceNow,
-                                       (CFAbsoluteTime) latency,
-                                       kFSEventStreamCreateFlagUseCFTypes);
-    
-    FSEventStreamScheduleWithRunLoop(_eventStream,
-                                     CFRunLoopGetCurrent(),
-                                     kCFRunLoopDefaultMode);
-    FSEventStreamStart(_eventStream);
+/* Returns the attribution for the operation whose formula's kegs or links
+ * contain the path, or the first attribution for an operation without a
+ * formula. An event in a directory shared by every formula, such as the Cellar,
+ * is only attributed to an operation on a formula with a change in changedNames.
+ * Must be called while synchronized on the receiver.
+ */
+- (MRBrewWatcherAttribution *)attributionForPath:(NSString *)path changedNames:(NSSet *)changedNames
+{
+    MRBrewWatcherAttribution *unrestrictedAttribution = nil;
+    BOOL isKegDirectory = [_kegDirectoryPaths containsObject:path];
+    
+    for (MRBrewWatcherAttribution *attribution in _attributions) {
+        if (![attribution formulaName]) {
+            if (!unrestrictedAttribution) {
+                unrestrictedAttribution = attribution;
+            }
+            continue;
+        }
+        
+        if (isKegDirectory && [changedNames containsObject:[attribution formulaName]]) {
+            return attribution;
+        }
+        
+        for (NSString *kegPath in [attribution kegPaths]) {
+            if (MRBrewWatcherPathContainsPath(kegPath, path)) {
+                return attribution;
+            }
+        }
+    }
+    
+    return unrestrictedAttribution;
 }
 
-- (void)stopWatching
+#pragma mark - Operation Attribution
+
+- (void)registerForOperationNotifications
 {
-	if (!(_eventStream)) {
-		return;
-	}
+    NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+    [notificationCenter addObserver:self selector:@selector(operationWillLaunch:) name:MRBrewOperationWillLaunchNotification object:nil];
+    [notificationCenter addObserver:self selector:@selector(operationDidExit:) name:MRBrewOperationDidExitNotification object:nil];
+}
+
+- (void)operationWillLaunch:(NSNotification *)notification
+{
+    MRBrewOperation *operation = [notification object];
+    
+    // read-only operations cannot cause events at the watched locations
+    if (![self suppressesOperationEvents] || [operation isReadOnly]) {
+        return;
+    }
+    
+    MRBrewWatcherAttribution *attribution = [[MRBrewWatcherAttribution alloc] init];
+    [attribution setOperation:operation];
+    
+    // an operation on a formula is attributed the events in its kegs and links
+    NSString *formulaName = [[operation formula] name];
+    if (formulaName) {
+        NSMutableArray *kegPaths = [NSMutableArray array];
+        for (NSString *directoryPath in _kegDirectoryPaths) {
+            [kegPaths addObject:[directoryPath stringByAppendingPathComponent:formulaName]];
+        }
+        [attribution setFormulaName:formulaName];
+        [attribution setKegPaths:kegPaths];
+    }
+    [attribution setPaths:[NSMutableOrderedSet orderedSet]];
+    [attribution setChanges:[NSMutableArray array]];
     
-	FSEventStreamStop(_eventStream);
-	FSEventStreamInvalidate(_eventStream);
-	FSEventStreamRelease(_eventStream);
-	_eventStream = NULL;
+    @synchronized(self) {
+        [_attributions addObject:attribution];
+    }
 }
 
-- (BOOL)isWatching {
-    return _eventStream != NULL;
+- (void)operationDidExit:(NSNotification *)notification
+{
+    MRBrewOperation *operation = [notification object];
+    MRBrewWatcherAttribution *exitedAttribution = nil;
+    
+    @synchronized(self) {
+        for (MRBrewWatcherAttribution *attribution in _attributions) {
+            if ([attribution operation] == operation) {
+                exitedAttribution = attribution;
+                break;
+            }
+        }
+    }
+    
+    if (!exitedAttribution) {
+        return;
+    }
+    
+    // events caused by the operation are delivered up to one latency interval
+    // after they occur, so keep attributing events until that has passed; the
+    // wait is on a global queue since the callback queue may be nil
+    NSTimeInterval delay = [self latency] + MRBrewWatcherAttributionGracePeriod;
+    __weak MRBrewWatcher *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [weakSelf finishAttribution:exitedAttribution];
+    });
+}
+
+- (void)finishAttribution:(MRBrewWatcherAttribution *)attribution
+{
+    @synchronized(self) {
+        [_attributions removeObjectIdenticalTo:attribution];
+    }
+    
+    if ([[attribution paths] count]) {
+        [self notifyDelegateOperation:[attribution operation] didChangePaths:[[attribution paths] array] changes:[attribution changes]];
+    }
+}
+
+#pragma mark - Delegate Notification
+
+/* Performs the callback on the callback queue, or inline if there is none. */
+- (void)performCallback:(void (^)(void))callback
+{
+    NSOperationQueue *callbackQueue = [self callbackQueue];
+    if (callbackQueue) {
+        [callbackQueue addOperationWithBlock:callback];
+    }
+    else {
+        callback();
+    }
+}
+
+- (void)notifyDelegateChangeDidOccur:(NSArray *)paths
+{
+    id<MRBrewWatcherDelegate> delegate = [self delegate];
+    if ([delegate respondsToSelector:@selector(brewChangeDidOccur:)]) {
+        [self performCallback:^{
+            [delegate brewChangeDidOccur:paths];
+        }];
+    }
+}
+
+- (void)notifyDelegateChangesDidOccur:(NSArray *)changes
+{
+    id<MRBrewWatcherDelegate> delegate = [self delegate];
+    if ([delegate respondsToSelector:@selector(brewChangesDidOccur:)]) {
+        [self performCallback:^{
+            [delegate brewChangesDidOccur:changes];
+        }];
+    }
+}
+
+- (void)notifyDelegateOperation:(MRBrewOperation *)operation didChangePaths:(NSArray *)paths changes:(NSArray *)changes
+{
+    id<MRBrewWatcherDelegate> delegate = [self delegate];
+    if ([delegate respondsToSelector:@selector(brewOperation:didChangePaths:changes:)]) {
+        [self performCallback:^{
+            [delegate brewOperation:operation didChangePaths:paths changes:changes];
+        }];
+    }
 }
 
 @end
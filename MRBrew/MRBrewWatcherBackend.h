@@ -0,0 +1,66 @@
+//
+//  MRBrewWatcherBackend.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+/** The block type used by a watcher backend to report file system events.
+ *
+ * @param paths An array of strings containing the directory paths where
+ * changes occurred. Each path appears at most once.
+ */
+typedef void (^MRBrewWatcherBackendHandler)(NSArray *paths);
+
+/** The `MRBrewWatcherBackend` protocol defines the methods implemented by the
+ * objects that an MRBrewWatcher uses to observe the file system.
+ *
+ * A backend watches each path recursively and coalesces the events it receives
+ * for the specified latency before invoking its handler with the set of
+ * directories where changes occurred. Handlers are invoked on the thread whose
+ * run loop was current when startWatchingPaths:latency:handler: was called, or
+ * on a queue of the backend's choosing for backends that do not use a run loop.
+ *
+ * `MRBrewFSEventsWatcherBackend` is used by default on OS X and
+ * `MRBrewInotifyWatcherBackend` on Linux. Assign an object conforming to this
+ * protocol to an MRBrewWatcher's `backend` property to provide your own.
+ */
+@protocol MRBrewWatcherBackend <NSObject>
+
+/** Starts watching the specified paths for file system events.
+ *
+ * @param paths An array of absolute directory paths to watch recursively.
+ * @param latency The interval, in seconds, for which events are coalesced
+ * before the handler is invoked.
+ * @param handler The block to invoke with the paths where changes occurred.
+ * @return `YES` if the backend started watching, otherwise `NO`.
+ */
+- (BOOL)startWatchingPaths:(NSArray *)paths latency:(NSTimeInterval)latency handler:(MRBrewWatcherBackendHandler)handler;
+
+/** Stops watching for file system events. */
+- (void)stopWatching;
+
+/** Indicates whether the backend is watching. */
+- (BOOL)isWatching;
+
+@end
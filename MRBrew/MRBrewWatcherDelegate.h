@@ -25,14 +25,21 @@
 
 #import <Foundation/Foundation.h>
 
-/** The `MRBrewWatcherDelegate` protocol defines the optional method
- * brewChangeDidOccur: that is implemented by delegates of the MRBrewWatcher
- * class.
+@class MRBrewOperation;
+
+/** The `MRBrewWatcherDelegate` protocol defines the optional methods
+ * brewChangeDidOccur:, brewChangesDidOccur: and
+ * brewOperation:didChangePaths:changes: that are implemented by delegates of
+ * the MRBrewWatcher class.
  *
  * MRBrewWatcher objects call the delegate method brewChangeDidOccur: when a
  * file system event occurs at a watched location (e.g. file modification,
  * deletion or creation). An array of strings representing the directory paths
  * where changes occurred is passed to this method.
+ *
+ * MRBrewWatcher objects with a snapshot also call the delegate method
+ * brewChangesDidOccur: with the changes to installed formulae computed from
+ * those paths.
  */
 @protocol MRBrewWatcherDelegate <NSObject>
 
@@ -45,4 +52,24 @@
  */
 - (void)brewChangeDidOccur:(NSArray *)paths;
 
+/** This method is called when file system events at a watched location have
+ * changed the installed state of one or more formulae. It is only called for
+ * watchers that have a snapshot, and is called after brewChangeDidOccur:.
+ *
+ * @param changes An array of MRBrewChange objects describing the changes, in
+ * the order they were detected.
+ */
+- (void)brewChangesDidOccur:(NSArray *)changes;
+
+/** This method is called once an operation performed by MRBrew has exited, for
+ * watchers that suppress operation events, if events were attributed to the
+ * operation while it was running.
+ *
+ * @param operation The operation the events were attributed to.
+ * @param paths An array of strings containing the paths where changes occurred.
+ * @param changes An array of MRBrewChange objects describing the changes, which
+ * is empty if the watcher does not have a snapshot.
+ */
+- (void)brewOperation:(MRBrewOperation *)operation didChangePaths:(NSArray *)paths changes:(NSArray *)changes;
+
 @end
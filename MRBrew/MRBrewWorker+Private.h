@@ -42,5 +42,9 @@ typedef NS_ENUM(NSInteger, MRBrewWorkerTaskTerminationMode) {
 - (void)changeFinishedState:(BOOL)finished;
 - (void)changeExecutingState:(BOOL)executing;
 - (void)taskExited:(NSNotification *)notification;
+- (void)notifyDelegateOutputGenerated:(NSData *)data;
+- (void)notifyDelegateErrorOutputGenerated:(NSData *)data;
+- (void)appendErrorOutput:(NSData *)data;
+- (MRBrewWorker *)workerForNextAttempt;
 
 @end
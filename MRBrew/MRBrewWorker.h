@@ -24,6 +24,7 @@
 //
 
 #import <Foundation/Foundation.h>
+#import "MRBrew.h"
 
 @class MRBrewOperation;
 @protocol MRBrewDelegate;
@@ -32,6 +33,60 @@
 
 @property (copy) MRBrewOperation *operation;
 @property (copy) NSArray *arguments;
+
+/* The Homebrew executable, environment and working directory the task is
+ * launched with, computed by the MRBrew instance that created the worker. A
+ * nil environment or directory inherits that of the current process.
+ */
+@property (copy) NSString *brewPath;
+@property (copy) NSDictionary *environment;
+@property (copy) NSString *currentDirectoryPath;
+
+/* A block that produces the operation's output in place of the brew task,
+ * such as an MRBrewOutdatedScanner answering an outdated operation. When set,
+ * the task is never launched; the block's output is delivered as the task's
+ * would be, and a nil result fails the operation.
+ */
+@property (copy) NSData *(^outputProvider)(void);
 @property (weak) id<MRBrewDelegate> delegate;
 
+/* The queue on which delegate messages and handler blocks are delivered. This
+ * is the main queue by default; a nil queue delivers them inline on the
+ * worker's own thread.
+ */
+@property (strong) NSOperationQueue *callbackQueue;
+@property (copy) MRBrewOutputHandler outputHandler;
+@property (copy) MRBrewDataHandler dataHandler;
+@property (copy) MRBrewDataHandler errorDataHandler;
+@property (copy) MRBrewProgressHandler progressHandler;
+
+/* The minimum interval between progress updates within a phase. Zero, the
+ * default, delivers every update.
+ */
+@property (assign) NSTimeInterval progressInterval;
+
+/* Output waiting for the callback queue is held in a buffer per stream of at
+ * most outputBufferLimit bytes, and outputBufferPolicy is applied when a
+ * buffer is full. Output delivered inline is not buffered.
+ */
+@property (assign) NSUInteger outputBufferLimit;
+@property (assign) MRBrewOutputBufferPolicy outputBufferPolicy;
+
+/* Retrying after lock contention. The worker for the first attempt at an
+ * operation has an attempt of zero. When an attempt fails because another
+ * Homebrew process holds a lock, and fewer than lockRetryLimit retries have
+ * been made, the retry handler is passed a worker for the next attempt and the
+ * delay after which to start it, and the failure callbacks are not called.
+ * The output and progress callbacks of an attempt that may be retried are
+ * held back until it is known to be final, so consumers never see the output
+ * of an abandoned attempt. Workers without a retry handler are never retried
+ * and hold nothing back.
+ */
+@property (assign) NSUInteger attempt;
+@property (assign) NSUInteger lockRetryLimit;
+@property (assign) NSTimeInterval lockRetryInterval;
+@property (copy) void (^retryHandler)(MRBrewWorker *retryWorker, NSTimeInterval delay);
+@property (copy) MRBrewCompletionHandler completionHandler;
+@property (copy) MRBrewFailureHandler failureHandler;
+
 @end
@@ -30,9 +30,56 @@
 #import "MRBrewConstants.h"
 #import "MRBrewDelegate.h"
 #import "MRBrewWorkerTaskConstants.h"
+#import "MRBrewFormula.h"
+#import "MRBrewProgress.h"
+#import "MRBrewProgressReader.h"
+#import "MRBrewOutputBuffer.h"
 
-static NSString * const MRBrewErrorDomain = @"uk.co.fidgetbox.MRBrew";
 static const NSTimeInterval MRBrewWorkerTaskTerminationTimeout = 5.0;
+static const NSTimeInterval MRBrewWorkerMaximumRetryDelay = 60.0;
+static const NSUInteger MRBrewWorkerDefaultOutputBufferLimit = 1024 * 1024;
+
+/* How long to wait for the end of a task's output once it has exited. A
+ * process the task started may still hold its pipes open.
+ */
+static const NSTimeInterval MRBrewWorkerOutputEndTimeout = 1.0;
+
+/* How long the callbacks of an attempt that may be retried are held back.
+ * Homebrew reports lock contention as soon as it starts, so an attempt that
+ * has run this long is treated as final and its callbacks are delivered.
+ */
+static const NSTimeInterval MRBrewWorkerRetryHoldInterval = 2.0;
+
+/* Only the start of a task's error output is kept, which is enough to
+ * recognise why it failed.
+ */
+static const NSUInteger MRBrewWorkerErrorOutputLimit = 64 * 1024;
+
+@interface MRBrewWorker ()
+{
+    @private
+    MRBrewProgressReader *_progressReader;
+    MRBrewProgress *_lastProgress;
+    MRBrewProgress *_pendingProgress;
+    CFAbsoluteTime _lastProgressTime;
+    BOOL _progressFlushScheduled;
+    NSPipe *_outputPipe;
+    NSPipe *_errorPipe;
+    NSMutableData *_errorOutput;
+    MRBrewOutputBuffer *_outputBuffer;
+    MRBrewOutputBuffer *_errorBuffer;
+    NSCondition *_streamCondition;
+    BOOL _outputEnded;
+    BOOL _errorOutputEnded;
+    NSMutableArray *_heldCallbacks;
+    NSUInteger _heldLength;
+    NSLock *_releaseLock;
+    BOOL _callbacksReleased;
+    BOOL _releasingCallbacks;
+    BOOL _attemptAbandoned;
+}
+
+@end
 
 @implementation MRBrewWorker
 
@@ -44,6 +91,13 @@ static const NSTimeInterval MRBrewWorkerTaskTerminationTimeout = 5.0;
     if (self = [super init]) {
         _task = [[NSTask alloc] init];
         _taskTerminationMode = MRBrewWorkerTaskTerminationModeInterrupt;
+        _callbackQueue = [NSOperationQueue mainQueue];
+        _errorOutput = [NSMutableData data];
+        _outputBufferLimit = MRBrewWorkerDefaultOutputBufferLimit;
+        _outputBufferPolicy = MRBrewOutputBufferPolicyBlock;
+        _streamCondition = [[NSCondition alloc] init];
+        _heldCallbacks = [NSMutableArray array];
+        _releaseLock = [[NSLock alloc] init];
     }
     
     return self;
@@ -58,27 +112,55 @@ static const NSTimeInterval MRBrewWorkerTaskTerminationTimeout = 5.0;
     
     [self changeExecutingState:YES];
     
+    // operations that can be answered without running Homebrew
+    if ([self outputProvider]) {
+        [self provideOutput];
+        return;
+    }
+    
     // configure the brew task instance
-    [[self task] setLaunchPath:[[MRBrew sharedBrew] brewPath]];
+    [[self task] setLaunchPath:[self brewPath]];
     [[self task] setArguments:_arguments];
-    [[self task] setStandardOutput:[NSPipe pipe]];
+    _outputPipe = [NSPipe pipe];
+    [[self task] setStandardOutput:_outputPipe];
+    
+    // error output is captured to recognise why an operation failed, and
+    // delivered separately from output
+    _errorPipe = [NSPipe pipe];
+    [[self task] setStandardError:_errorPipe];
     
-    NSDictionary *environment = [[MRBrew sharedBrew] environment];
+    NSDictionary *environment = [self environment];
     if (environment) {
         [[self task] setEnvironment:environment];
     }
+    
+    NSString *currentDirectoryPath = [self currentDirectoryPath];
+    if (currentDirectoryPath) {
+        [[self task] setCurrentDirectoryPath:currentDirectoryPath];
+    }
 
     // register for task termination notification
     [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(taskExited:) name:NSTaskDidTerminateNotification object:[self task]];
 
-    // configure read handler for asynchronous brew output
-    [[[[self task] standardOutput] fileHandleForReading] setReadabilityHandler:^(NSFileHandle *file) {
+    // configure read handlers for asynchronous brew output; an empty read
+    // marks the end of a stream
+    [[_outputPipe fileHandleForReading] setReadabilityHandler:^(NSFileHandle *file) {
         NSData *data = [file availableData];
-        NSString *output = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
-        if ([_delegate respondsToSelector:@selector(brewOperation:didGenerateOutput:)]) {
-            [[NSOperationQueue mainQueue] addOperationWithBlock:^{
-                [_delegate brewOperation:_operation didGenerateOutput:output];
-            }];
+        if ([data length] > 0) {
+            [self notifyDelegateOutputGenerated:data];
+        }
+        else {
+            [self streamEnded:file errorOutput:NO];
+        }
+    }];
+    
+    [[_errorPipe fileHandleForReading] setReadabilityHandler:^(NSFileHandle *file) {
+        NSData *data = [file availableData];
+        if ([data length] > 0) {
+            [self notifyDelegateErrorOutputGenerated:data];
+        }
+        else {
+            [self streamEnded:file errorOutput:YES];
         }
     }];
     
@@ -87,6 +169,8 @@ static const NSTimeInterval MRBrewWorkerTaskTerminationTimeout = 5.0;
 
 - (void)main
 {
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationWillLaunchNotification object:_operation];
+    
     @try {
         [[self task] launch];
 
@@ -128,14 +212,64 @@ static const NSTimeInterval MRBrewWorkerTaskTerminationTimeout = 5.0;
     }
     @catch (NSException *exception) {
         NSLog(@"MRBrewWorker: An internal exception was raised (%@: %@)",[exception name], exception);
+        [self failAfterException:exception];
     }
     @finally {
+        [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationDidExitNotification object:_operation];
+        
         // cleanup
         [self changeExecutingState:NO];
         [self changeFinishedState:YES];
     }
 }
 
+/* Fails the operation after an exception, typically raised by launching a task
+ * whose launch path does not exist or is not executable. The task's
+ * termination notification is no longer observed, so the failure is
+ * delivered once.
+ */
+- (void)failAfterException:(NSException *)exception
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:NSTaskDidTerminateNotification object:[self task]];
+    [[_outputPipe fileHandleForReading] setReadabilityHandler:nil];
+    [[_errorPipe fileHandleForReading] setReadabilityHandler:nil];
+    
+    // the attempt is final, so anything it generated is delivered first
+    [self releaseHeldCallbacks];
+    
+    NSMutableDictionary *userInfo = [NSMutableDictionary dictionaryWithObject:@"Homebrew could not be run." forKey:NSLocalizedDescriptionKey];
+    if ([exception reason]) {
+        [userInfo setObject:[exception reason] forKey:NSLocalizedFailureReasonErrorKey];
+    }
+    
+    [self notifyDelegateOperationFailedWithError:[NSError errorWithDomain:MRBrewErrorDomain code:MRBrewErrorUnknown userInfo:userInfo]];
+}
+
+/* Delivers the output of the output provider as if it had been written by a
+ * brew task, and finishes the operation without launching the task.
+ */
+- (void)provideOutput
+{
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationWillLaunchNotification object:_operation];
+    
+    // provided output is never retried, so nothing needs to be held back
+    [self releaseHeldCallbacks];
+    
+    NSData *output = [self outputProvider]();
+    if (output) {
+        [self notifyDelegateOutputGenerated:output];
+        [self notifyDelegateOperationCompleted];
+    }
+    else {
+        [self notifyDelegateOperationFailedWithCode:MRBrewErrorUnknown];
+    }
+    
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationDidExitNotification object:_operation];
+    
+    [self changeExecutingState:NO];
+    [self changeFinishedState:YES];
+}
+
 - (BOOL)isAsynchronous
 {
     return YES;
@@ -167,35 +301,547 @@ static const NSTimeInterval MRBrewWorkerTaskTerminationTimeout = 5.0;
 
 - (void)taskExited:(NSNotification *)notification
 {
-    if ([[self task] terminationStatus] == MRBrewWorkerTaskExitedNormally) {
+    [self finishReadingOutput];
+    
+    BOOL exitedNormally = ([[self task] terminationStatus] == MRBrewWorkerTaskExitedNormally);
+    if (!exitedNormally && [self abandonAttemptForRetry]) {
+        [self retryAfterLockContention];
+        return;
+    }
+    
+    // this attempt is final, so what it generated can now be delivered
+    [self releaseHeldCallbacks];
+    [self notifyDelegateOutputDropped];
+    
+    // the final update of a phase is delivered before the operation finishes
+    @synchronized(self) {
+        [self flushPendingProgress];
+    }
+    
+    if (exitedNormally) {
         [self notifyDelegateOperationCompleted];
     }
+    else if ([[self task] terminationStatus] == MRBrewWorkerTaskCancelled) {
+        [self notifyDelegateOperationFailedWithCode:MRBrewErrorOperationCancelled];
+    }
     else {
-        [self notifyDelegateOperationFailed];
+        [self notifyDelegateOperationFailedWithCode:([self failedDueToLockContention] ? MRBrewErrorLockContention : MRBrewErrorUnknown)];
     }
+}
 
-    // stop reading and cleanup file handle's structures
-    [[[[self task] standardOutput] fileHandleForReading] setReadabilityHandler:nil];
+#pragma mark - Reading Output
+
+- (void)streamEnded:(NSFileHandle *)fileHandle errorOutput:(BOOL)errorOutput
+{
+    [fileHandle setReadabilityHandler:nil];
+    
+    [_streamCondition lock];
+    if (errorOutput) {
+        _errorOutputEnded = YES;
+    }
+    else {
+        _outputEnded = YES;
+    }
+    [_streamCondition broadcast];
+    [_streamCondition unlock];
 }
 
-- (void)notifyDelegateOperationFailed {
-    NSInteger errorCode = [[self task] terminationStatus] == MRBrewWorkerTaskCancelled ? MRBrewErrorOperationCancelled : MRBrewErrorUnknown;
-    NSError *error = [NSError errorWithDomain:MRBrewErrorDomain code:errorCode userInfo:nil];
-    if ([_delegate respondsToSelector:@selector(brewOperation:didFailWithError:)]) {
-        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
-            [_delegate brewOperation:_operation didFailWithError:error];
+/* Waits for the output and error output that the task wrote before exiting to
+ * be read, so that it is delivered before the operation finishes. The buffers
+ * are closed first, since an exited task can no longer be held back, and the
+ * wait is bounded in case a process the task started still holds a pipe open.
+ */
+- (void)finishReadingOutput
+{
+    if (!_outputPipe) {
+        return;
+    }
+    
+    [[self outputBufferForErrorOutput:NO] close];
+    [[self outputBufferForErrorOutput:YES] close];
+    
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:MRBrewWorkerOutputEndTimeout];
+    [_streamCondition lock];
+    while (!(_outputEnded && _errorOutputEnded) && [_streamCondition waitUntilDate:deadline]) {
+        // woken when a stream ends
+    }
+    [_streamCondition unlock];
+    
+    // stop reading and cleanup file handles' structures
+    [[_outputPipe fileHandleForReading] setReadabilityHandler:nil];
+    [[_errorPipe fileHandleForReading] setReadabilityHandler:nil];
+}
+
+/* Returns the buffer holding output, or error output, waiting for the callback
+ * queue.
+ */
+- (MRBrewOutputBuffer *)outputBufferForErrorOutput:(BOOL)errorOutput
+{
+    @synchronized(_streamCondition) {
+        if (errorOutput) {
+            if (!_errorBuffer) {
+                _errorBuffer = [[MRBrewOutputBuffer alloc] initWithLimit:[self outputBufferLimit] policy:[self outputBufferPolicy]];
+            }
+            return _errorBuffer;
+        }
+        
+        if (!_outputBuffer) {
+            _outputBuffer = [[MRBrewOutputBuffer alloc] initWithLimit:[self outputBufferLimit] policy:[self outputBufferPolicy]];
+        }
+        return _outputBuffer;
+    }
+}
+
+#pragma mark - Error Output
+
+- (void)appendErrorOutput:(NSData *)data
+{
+    @synchronized(_errorOutput) {
+        NSUInteger remainingLength = MRBrewWorkerErrorOutputLimit - MIN([_errorOutput length], MRBrewWorkerErrorOutputLimit);
+        [_errorOutput appendBytes:[data bytes] length:MIN([data length], remainingLength)];
+    }
+}
+
+/* Returns YES if the task's error output shows that it failed because another
+ * Homebrew process held a lock, either on Homebrew itself during an update or
+ * on a formula being operated on.
+ */
+- (BOOL)failedDueToLockContention
+{
+    static NSArray *markers = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        markers = @[[@"Another active Homebrew" dataUsingEncoding:NSUTF8StringEncoding],
+                    [@"has already locked" dataUsingEncoding:NSUTF8StringEncoding],
+                    [@"Operation already in progress" dataUsingEncoding:NSUTF8StringEncoding]];
+    });
+    
+    @synchronized(_errorOutput) {
+        for (NSData *marker in markers) {
+            if ([_errorOutput rangeOfData:marker options:0 range:NSMakeRange(0, [_errorOutput length])].location != NSNotFound) {
+                return YES;
+            }
+        }
+    }
+    
+    return NO;
+}
+
+#pragma mark - Retrying
+
+- (BOOL)shouldRetryAfterFailure
+{
+    if ([self isCancelled] || ![self retryHandler] || [self attempt] >= [self lockRetryLimit]) {
+        return NO;
+    }
+    
+    // an attempt whose output has been delivered cannot be taken back
+    @synchronized(_heldCallbacks) {
+        if (_callbacksReleased) {
+            return NO;
+        }
+    }
+    
+    return [self failedDueToLockContention];
+}
+
+/* Discards the callbacks held for this attempt if it is to be retried, so that
+ * consumers only ever see the output of the final attempt. Returns YES if the
+ * attempt should be retried.
+ */
+- (BOOL)abandonAttemptForRetry
+{
+    @synchronized(_heldCallbacks) {
+        if (![self shouldRetryAfterFailure]) {
+            return NO;
+        }
+        
+        _attemptAbandoned = YES;
+        [_heldCallbacks removeAllObjects];
+        _heldLength = 0;
+        return YES;
+    }
+}
+
+/* Holds back a callback generated by an attempt that may yet be retried.
+ * Callbacks are released when the attempt turns out to be final, when more
+ * than outputBufferLimit bytes of output are held, or when the attempt has
+ * been held for MRBrewWorkerRetryHoldInterval, after which it is no longer
+ * retried. Returns NO if the callback should be performed now.
+ */
+- (BOOL)holdCallback:(void (^)(void))callback length:(NSUInteger)length
+{
+    @synchronized(_heldCallbacks) {
+        if (_attemptAbandoned) {
+            return YES;
+        }
+        
+        // callbacks generated while held ones are being performed queue
+        // behind them, so that they are not performed out of order
+        if (_releasingCallbacks) {
+            [_heldCallbacks addObject:[callback copy]];
+            return YES;
+        }
+        
+        if (_callbacksReleased || ![self retryHandler] || [self attempt] >= [self lockRetryLimit]) {
+            return NO;
+        }
+        
+        [_heldCallbacks addObject:[callback copy]];
+        _heldLength += length;
+        
+        if ([_heldCallbacks count] == 1) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(MRBrewWorkerRetryHoldInterval * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                [self releaseHeldCallbacks];
+            });
+        }
+        
+        if (_heldLength <= [self outputBufferLimit]) {
+            return YES;
+        }
+    }
+    
+    [self releaseHeldCallbacks];
+    return YES;
+}
+
+/* Performs the held callbacks in the order they were generated. Callbacks
+ * generated from now on are performed without being held, once those held
+ * before them have been performed.
+ *
+ * The callbacks are performed outside the lock on _heldCallbacks, as
+ * passing output to a full buffer blocks until it has been delivered. The
+ * release lock keeps a concurrent release (e.g. when the task exits as the
+ * hold interval elapses) from returning before the held callbacks have been
+ * performed.
+ */
+- (void)releaseHeldCallbacks
+{
+    [_releaseLock lock];
+    
+    @synchronized(_heldCallbacks) {
+        if (_attemptAbandoned) {
+            [_releaseLock unlock];
+            return;
+        }
+        
+        _callbacksReleased = YES;
+        _releasingCallbacks = YES;
+    }
+    
+    while (YES) {
+        NSArray *callbacks;
+        @synchronized(_heldCallbacks) {
+            if ([_heldCallbacks count] == 0) {
+                _releasingCallbacks = NO;
+                break;
+            }
+            
+            callbacks = [_heldCallbacks copy];
+            [_heldCallbacks removeAllObjects];
+            _heldLength = 0;
+        }
+        
+        for (void (^callback)(void) in callbacks) {
+            callback();
+        }
+    }
+    
+    [_releaseLock unlock];
+}
+
+/* Passes a worker for the next attempt to the retry handler. The delay doubles
+ * with each attempt and is jittered so that operations that contended for the
+ * same lock do not retry in lockstep.
+ */
+- (void)retryAfterLockContention
+{
+    NSTimeInterval delay = MIN([self lockRetryInterval] * (double)(1 << MIN([self attempt], 16)), MRBrewWorkerMaximumRetryDelay);
+    delay *= 0.5 + arc4random_uniform(1001) / 1000.0;
+    
+    [self retryHandler]([self workerForNextAttempt], delay);
+}
+
+- (MRBrewWorker *)workerForNextAttempt
+{
+    MRBrewWorker *worker = [[[self class] alloc] init];
+    [worker setOperation:[self operation]];
+    [worker setArguments:[self arguments]];
+    [worker setBrewPath:[self brewPath]];
+    [worker setEnvironment:[self environment]];
+    [worker setCurrentDirectoryPath:[self currentDirectoryPath]];
+    [worker setDelegate:[self delegate]];
+    [worker setCallbackQueue:[self callbackQueue]];
+    [worker setOutputHandler:[self outputHandler]];
+    [worker setDataHandler:[self dataHandler]];
+    [worker setErrorDataHandler:[self errorDataHandler]];
+    [worker setProgressHandler:[self progressHandler]];
+    [worker setProgressInterval:[self progressInterval]];
+    [worker setOutputBufferLimit:[self outputBufferLimit]];
+    [worker setOutputBufferPolicy:[self outputBufferPolicy]];
+    [worker setCompletionHandler:[self completionHandler]];
+    [worker setFailureHandler:[self failureHandler]];
+    [worker setAttempt:[self attempt] + 1];
+    [worker setLockRetryLimit:[self lockRetryLimit]];
+    [worker setLockRetryInterval:[self lockRetryInterval]];
+    [worker setRetryHandler:[self retryHandler]];
+    
+    return worker;
+}
+
+#pragma mark - Notifying
+
+- (void)notifyDelegateOutputGenerated:(NSData *)data {
+    [self readProgressFromData:data errorOutput:NO];
+    
+    if ([self dataHandler] || [self outputHandler] || [_delegate respondsToSelector:@selector(brewOperation:didGenerateData:)] || [_delegate respondsToSelector:@selector(brewOperation:didGenerateOutput:)]) {
+        [self deliverData:data errorOutput:NO];
+    }
+}
+
+- (void)notifyDelegateErrorOutputGenerated:(NSData *)data {
+    [self appendErrorOutput:data];
+    [self readProgressFromData:data errorOutput:YES];
+    
+    if ([self errorDataHandler] || [_delegate respondsToSelector:@selector(brewOperation:didGenerateErrorOutput:)]) {
+        [self deliverData:data errorOutput:YES];
+    }
+}
+
+/* Passes a chunk of output, or error output, on unless the attempt's
+ * callbacks are being held.
+ */
+- (void)deliverData:(NSData *)data errorOutput:(BOOL)errorOutput
+{
+    if ([data length] == 0) {
+        return;
+    }
+    
+    if (![self holdCallback:^{
+        [self passData:data errorOutput:errorOutput];
+    } length:[data length]]) {
+        [self passData:data errorOutput:errorOutput];
+    }
+}
+
+/* Passes a chunk of output, or error output, to the callback queue through
+ * the stream's buffer. The buffer's drain delivers all of the chunks that
+ * were appended before it executes, so only one callback is waiting at a time.
+ * Output delivered inline is passed on directly.
+ */
+- (void)passData:(NSData *)data errorOutput:(BOOL)errorOutput
+{
+    if (![self callbackQueue]) {
+        [self consumeData:data errorOutput:errorOutput];
+        return;
+    }
+    
+    MRBrewOutputBuffer *buffer = [self outputBufferForErrorOutput:errorOutput];
+    if ([buffer appendData:data]) {
+        [self performCallback:^{
+            for (NSData *chunk in [buffer drain]) {
+                [self consumeData:chunk errorOutput:errorOutput];
+            }
+        }];
+    }
+}
+
+/* Passes a chunk of output, or error output, to the handlers and delegate
+ * methods that want it. Raw output is passed on as read; it is only decoded if
+ * a string is wanted.
+ */
+- (void)consumeData:(NSData *)data errorOutput:(BOOL)errorOutput
+{
+    if (errorOutput) {
+        MRBrewDataHandler errorDataHandler = [self errorDataHandler];
+        if (errorDataHandler) {
+            errorDataHandler(_operation, data);
+        }
+        if ([_delegate respondsToSelector:@selector(brewOperation:didGenerateErrorOutput:)]) {
+            [_delegate brewOperation:_operation didGenerateErrorOutput:[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding]];
+        }
+        return;
+    }
+    
+    MRBrewOutputHandler outputHandler = [self outputHandler];
+    MRBrewDataHandler dataHandler = [self dataHandler];
+    BOOL delegateResponds = [_delegate respondsToSelector:@selector(brewOperation:didGenerateOutput:)];
+    
+    if (dataHandler) {
+        dataHandler(_operation, data);
+    }
+    if ([_delegate respondsToSelector:@selector(brewOperation:didGenerateData:)]) {
+        [_delegate brewOperation:_operation didGenerateData:data];
+    }
+    
+    if (outputHandler || delegateResponds) {
+        NSString *output = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+        if (outputHandler) {
+            outputHandler(_operation, output);
+        }
+        if (delegateResponds) {
+            [_delegate brewOperation:_operation didGenerateOutput:output];
+        }
+    }
+}
+
+/* Tells the delegate how much output was discarded by the buffers, if any. */
+- (void)notifyDelegateOutputDropped
+{
+    NSUInteger length = [[self outputBufferForErrorOutput:NO] droppedLength];
+    NSUInteger errorLength = [[self outputBufferForErrorOutput:YES] droppedLength];
+    
+    if ((length || errorLength) && [_delegate respondsToSelector:@selector(brewOperation:didDropOutputLength:errorOutputLength:)]) {
+        [self performCallback:^{
+            [_delegate brewOperation:_operation didDropOutputLength:length errorOutputLength:errorLength];
+        }];
+    }
+}
+
+/* Reads the progress described by a chunk of output, if anything is
+ * interested in it. Both streams are read by one reader, since curl draws its
+ * progress bar on error output while the formula it belongs to is named on
+ * output.
+ */
+- (void)readProgressFromData:(NSData *)data errorOutput:(BOOL)errorOutput
+{
+    if ([data length] == 0) {
+        return;
+    }
+    
+    if (![self progressHandler] && ![_delegate respondsToSelector:@selector(brewOperation:didUpdateProgress:)]) {
+        return;
+    }
+    
+    @synchronized(self) {
+        if (!_progressReader) {
+            _progressReader = [[MRBrewProgressReader alloc] initWithFormulaName:[[_operation formula] name]];
+        }
+        
+        for (MRBrewProgress *progress in [_progressReader progressFromData:data errorOutput:errorOutput]) {
+            [self throttleProgress:progress];
+        }
+    }
+}
+
+/* Delivers progress at most once per progress interval. Progress that starts
+ * a new phase or formula is delivered immediately, since it is never
+ * superseded. An update within a phase replaces any update still waiting, and
+ * the latest is delivered when the interval ends. Must be called with the
+ * receiver locked.
+ */
+- (void)throttleProgress:(MRBrewProgress *)progress
+{
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    NSTimeInterval progressInterval = [self progressInterval];
+    NSString *lastFormulaName = [_lastProgress formulaName];
+    BOOL startsPhase = !_lastProgress || [_lastProgress phase] != [progress phase] || (lastFormulaName != [progress formulaName] && ![lastFormulaName isEqualToString:[progress formulaName]]);
+    
+    if (startsPhase || now - _lastProgressTime >= progressInterval) {
+        _pendingProgress = nil;
+        [self deliverProgress:progress atTime:now];
+        return;
+    }
+    
+    _pendingProgress = progress;
+    
+    if (!_progressFlushScheduled) {
+        _progressFlushScheduled = YES;
+        int64_t delay = (int64_t)((_lastProgressTime + progressInterval - now) * NSEC_PER_SEC);
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, delay), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            @synchronized(self) {
+                _progressFlushScheduled = NO;
+                [self flushPendingProgress];
+            }
+        });
+    }
+}
+
+/* Delivers the update waiting for the end of the progress interval, if any.
+ * Must be called with the receiver locked.
+ */
+- (void)flushPendingProgress
+{
+    if (_pendingProgress) {
+        MRBrewProgress *progress = _pendingProgress;
+        _pendingProgress = nil;
+        [self deliverProgress:progress atTime:CFAbsoluteTimeGetCurrent()];
+    }
+}
+
+- (void)deliverProgress:(MRBrewProgress *)progress atTime:(CFAbsoluteTime)time
+{
+    _lastProgress = progress;
+    _lastProgressTime = time;
+    
+    MRBrewProgressHandler progressHandler = [self progressHandler];
+    BOOL delegateResponds = [_delegate respondsToSelector:@selector(brewOperation:didUpdateProgress:)];
+    
+    void (^callback)(void) = ^{
+        if (progressHandler) {
+            progressHandler(_operation, progress);
+        }
+        if (delegateResponds) {
+            [_delegate brewOperation:_operation didUpdateProgress:progress];
+        }
+    };
+    
+    if (![self holdCallback:^{
+        [self performCallback:callback];
+    } length:0]) {
+        [self performCallback:callback];
+    }
+}
+
+- (void)notifyDelegateOperationFailedWithCode:(NSInteger)errorCode {
+    [self notifyDelegateOperationFailedWithError:[NSError errorWithDomain:MRBrewErrorDomain code:errorCode userInfo:nil]];
+}
+
+- (void)notifyDelegateOperationFailedWithError:(NSError *)error {
+    MRBrewFailureHandler failureHandler = [self failureHandler];
+    BOOL delegateResponds = [_delegate respondsToSelector:@selector(brewOperation:didFailWithError:)];
+    
+    if (failureHandler || delegateResponds) {
+        [self performCallback:^{
+            if (failureHandler) {
+                failureHandler(_operation, error);
+            }
+            if (delegateResponds) {
+                [_delegate brewOperation:_operation didFailWithError:error];
+            }
         }];
     }
 }
 
 - (void)notifyDelegateOperationCompleted {
-    if ([_delegate respondsToSelector:@selector(brewOperationDidFinish:)]) {
-        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
-            [_delegate brewOperationDidFinish:_operation];
+    MRBrewCompletionHandler completionHandler = [self completionHandler];
+    BOOL delegateResponds = [_delegate respondsToSelector:@selector(brewOperationDidFinish:)];
+    
+    if (completionHandler || delegateResponds) {
+        [self performCallback:^{
+            if (completionHandler) {
+                completionHandler(_operation);
+            }
+            if (delegateResponds) {
+                [_delegate brewOperationDidFinish:_operation];
+            }
         }];
     }
 }
 
+/* Executes the callback block on the callback queue, or inline on the current
+ * thread if no callback queue has been set.
+ */
+- (void)performCallback:(void (^)(void))callback {
+    NSOperationQueue *callbackQueue = [self callbackQueue];
+    if (callbackQueue) {
+        [callbackQueue addOperationWithBlock:callback];
+    }
+    else {
+        callback();
+    }
+}
+
 - (void)dealloc
 {
     [[NSNotificationCenter defaultCenter] removeObserver:self name:NSTaskDidTerminateNotification object:[self task]];
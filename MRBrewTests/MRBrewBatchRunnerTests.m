@@ -0,0 +1,101 @@
+//
+//  MRBrewBatchRunnerTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "MRBrewBatchRunner.h"
+#import "MRBrewOperation.h"
+#import "MRBrewFormula.h"
+#import "MRBrewInstallOption.h"
+
+@interface MRBrewBatchRunnerTests : XCTestCase
+
+@end
+
+@implementation MRBrewBatchRunnerTests
+
+- (void)testOperationsAreReadFromLines
+{
+    // setup
+    NSData *batch = [@"# refresh first\nupdate\n\ninstall wget --build-from-source\ninfo --json=v1 wget curl\n" dataUsingEncoding:NSUTF8StringEncoding];
+    
+    // execute
+    NSArray *operations = [MRBrewBatchRunner operationsFromData:batch error:NULL];
+    
+    // verify
+    XCTAssertEqual([operations count], (NSUInteger)3, @"Each line other than comments and blank lines should be an operation.");
+    XCTAssertEqualObjects([[operations objectAtIndex:1] name], @"install", @"The first word of a line should be the operation name.");
+    XCTAssertEqualObjects([[[operations objectAtIndex:1] formula] name], @"wget", @"A single argument that is not an option should be the formula.");
+    XCTAssertEqualObjects([[operations objectAtIndex:1] parameters], @[@"--build-from-source"], @"Options should be parameters.");
+    XCTAssertEqualObjects([[operations objectAtIndex:2] parameters], (@[@"--json=v1", @"wget", @"curl"]), @"Several formulae should be passed through as parameters in order.");
+}
+
+- (void)testOperationsAreReadFromJSON
+{
+    // setup
+    NSData *batch = [@"[{\"name\": \"install\", \"formula\": \"wget\", \"parameters\": [\"--HEAD\"]}, {\"name\": \"list\"}]" dataUsingEncoding:NSUTF8StringEncoding];
+    
+    // execute
+    NSArray *operations = [MRBrewBatchRunner operationsFromData:batch error:NULL];
+    
+    // verify
+    XCTAssertEqual([operations count], (NSUInteger)2, @"Each object of a JSON array should be an operation.");
+    XCTAssertEqualObjects([[[operations firstObject] formula] name], @"wget", @"The formula should be read from the object.");
+    XCTAssertEqualObjects([[operations firstObject] parameters], @[@"--HEAD"], @"The parameters should be read from the object.");
+    XCTAssertEqualObjects([[operations lastObject] name], @"list", @"The name should be read from the object.");
+}
+
+- (void)testInvalidOperationReportsLine
+{
+    // setup
+    NSData *batch = [@"list\n{\"formula\": \"wget\"}\n" dataUsingEncoding:NSUTF8StringEncoding];
+    NSError *error = nil;
+    
+    // execute
+    NSArray *operations = [MRBrewBatchRunner operationsFromData:batch error:&error];
+    
+    // verify
+    XCTAssertNil(operations, @"A batch with an invalid operation should not be read.");
+    XCTAssertEqual([error code], (NSInteger)2, @"The error should identify the line of the invalid operation.");
+}
+
+- (void)testDictionaryForObjectDescribesFormulaAndOption
+{
+    // setup
+    MRBrewFormula *formula = [MRBrewFormula formulaWithName:@"wget" isNew:NO isUpdated:NO isInstalled:YES];
+    MRBrewInstallOption *option = [MRBrewInstallOption installOptionWithName:@"--with-iri" description:@"Enable iri support" selected:NO];
+    
+    // execute
+    NSDictionary *formulaDictionary = [MRBrewBatchRunner dictionaryForObject:formula];
+    NSDictionary *optionDictionary = [MRBrewBatchRunner dictionaryForObject:option];
+    
+    // verify
+    XCTAssertEqualObjects([formulaDictionary objectForKey:@"name"], @"wget", @"Formula should be described by name.");
+    XCTAssertEqualObjects([formulaDictionary objectForKey:@"installed"], @YES, @"Formula should be described with its installed state.");
+    XCTAssertNil([formulaDictionary objectForKey:@"available_version"], @"Values the output did not provide should be omitted.");
+    XCTAssertEqualObjects(optionDictionary, (@{@"option": @"--with-iri", @"description": @"Enable iri support"}), @"Option should be described by name and description.");
+    XCTAssertTrue([NSJSONSerialization isValidJSONObject:formulaDictionary], @"Descriptions should be writable as JSON.");
+}
+
+@end
@@ -0,0 +1,167 @@
+//
+//  MRBrewDiskUsageScannerTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "XCTestCase+MRBrewFixtures.h"
+#import "MRBrewDiskUsageScanner.h"
+#import "MRBrewDiskUsage.h"
+#import "MRBrewLocations.h"
+#import "MRBrewFormula.h"
+#include <sys/stat.h>
+
+@interface MRBrewDiskUsageScannerTests : XCTestCase {
+    NSString *_prefix;
+    MRBrewDiskUsageScanner *_scanner;
+}
+
+@end
+
+@implementation MRBrewDiskUsageScannerTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    // two versions of wget that share a hard-linked executable, and openssl
+    _prefix = [self createTemporaryDirectory];
+    
+    [self createDirectoryAtPath:@"Library/LinkedKegs" inDirectory:_prefix];
+    [self createDirectoryAtPath:@"Library/PinnedKegs" inDirectory:_prefix];
+    [self writeFileAtPath:@"Cellar/wget/1.14/bin/wget" length:10000];
+    [self createDirectoryAtPath:@"Cellar/wget/1.15/bin" inDirectory:_prefix];
+    [[NSFileManager defaultManager] linkItemAtPath:[_prefix stringByAppendingPathComponent:@"Cellar/wget/1.14/bin/wget"] toPath:[_prefix stringByAppendingPathComponent:@"Cellar/wget/1.15/bin/wget"] error:NULL];
+    [self writeFileAtPath:@"Cellar/wget/1.15/README" length:100];
+    [self writeFileAtPath:@"Cellar/openssl/1.0.1f/lib/libssl.a" length:5000];
+    
+    _scanner = [[MRBrewDiskUsageScanner alloc] initWithLocations:[MRBrewLocations locationsWithPrefixPath:_prefix]];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:_prefix error:NULL];
+    [super tearDown];
+}
+
+- (void)writeFileAtPath:(NSString *)path length:(NSUInteger)length
+{
+    [self writeData:[NSMutableData dataWithLength:length] toFileAtPath:path inDirectory:_prefix];
+}
+
+- (unsigned long long)allocatedSizeAtPath:(NSString *)path
+{
+    struct stat status;
+    lstat([[_prefix stringByAppendingPathComponent:path] fileSystemRepresentation], &status);
+    
+    return (unsigned long long)status.st_blocks * 512;
+}
+
+- (void)testUsagesAreReportedInOrderOfFormulae
+{
+    // setup
+    NSArray *formulae = @[[MRBrewFormula formulaWithName:@"wget"], [MRBrewFormula formulaWithName:@"git"], [MRBrewFormula formulaWithName:@"openssl"]];
+    
+    // execute
+    NSArray *usages = [_scanner diskUsageOfFormulae:formulae];
+    
+    // verify
+    XCTAssertTrue([usages count] == 3, @"A usage should be reported for each formula.");
+    XCTAssertEqual([[usages objectAtIndex:0] formula], [formulae objectAtIndex:0], @"Usages should describe the formulae passed to the scanner.");
+    XCTAssertTrue([[usages objectAtIndex:1] size] == 0, @"A formula that is not installed should use no space.");
+    XCTAssertTrue([[usages objectAtIndex:2] size] >= 5000, @"The size of a keg's files should be counted.");
+}
+
+- (void)testUsageOfEachVersionIsReported
+{
+    // execute
+    MRBrewDiskUsage *usage = [[_scanner diskUsageOfFormulae:@[[MRBrewFormula formulaWithName:@"wget"]]] firstObject];
+    
+    // verify
+    XCTAssertEqualObjects([[usage versionUsages] valueForKey:@"version"], (@[@"1.14", @"1.15"]), @"A usage should be reported for each installed version, ordered by version.");
+    XCTAssertTrue([[usage usageForVersion:@"1.14"] fileCount] == 1, @"The files of each version should be counted.");
+    XCTAssertTrue([[usage usageForVersion:@"1.15"] fileCount] == 2, @"A hard link in a version should be counted as one of its files.");
+}
+
+- (void)testHardLinkedFileIsCountedOnceForFormula
+{
+    // execute
+    MRBrewDiskUsage *usage = [[_scanner diskUsageOfFormulae:@[[MRBrewFormula formulaWithName:@"wget"]]] firstObject];
+    
+    // verify
+    unsigned long long versionsSize = [[usage usageForVersion:@"1.14"] size] + [[usage usageForVersion:@"1.15"] size];
+    XCTAssertTrue([usage fileCount] == 2, @"A file linked from two versions should be counted once.");
+    XCTAssertEqual([usage size], versionsSize - [self allocatedSizeAtPath:@"Cellar/wget/1.14/bin/wget"], @"The space used by a file linked from two versions should be counted once.");
+}
+
+- (void)testRescanWalksOnlyChangedKegs
+{
+    // setup
+    [_scanner diskUsageOfFormulae:nil];
+    NSUInteger initialWalkedKegCount = [_scanner walkedKegCount];
+    
+    // execute
+    NSArray *unchangedUsages = [_scanner diskUsageOfFormulae:nil];
+    NSUInteger unchangedWalkedKegCount = [_scanner walkedKegCount];
+    
+    [self writeFileAtPath:@"Cellar/wget/1.15/bin/wget-helper" length:100];
+    [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate: [NSDate dateWithTimeIntervalSinceNow:60]} ofItemAtPath:[_prefix stringByAppendingPathComponent:@"Cellar/wget/1.15/bin"] error:NULL];
+    NSArray *changedUsages = [_scanner diskUsageOfFormulae:nil];
+    
+    // verify
+    XCTAssertTrue(initialWalkedKegCount == 3, @"The first scan should walk every keg.");
+    XCTAssertTrue(unchangedWalkedKegCount == 0, @"A rescan of unchanged kegs should be answered from the cache.");
+    XCTAssertTrue([_scanner walkedKegCount] == 1, @"Only the changed keg should be walked again.");
+    XCTAssertTrue([[changedUsages lastObject] fileCount] == [[unchangedUsages lastObject] fileCount] + 1, @"The rescan should count the file added to the changed keg.");
+}
+
+- (void)testRescanWalksKegChangedBelowItsTopLevelDirectories
+{
+    // setup
+    [self createDirectoryAtPath:@"Cellar/openssl/1.0.1f/lib/pkgconfig" inDirectory:_prefix];
+    [_scanner diskUsageOfFormulae:nil];
+    
+    // execute
+    [self writeFileAtPath:@"Cellar/openssl/1.0.1f/lib/pkgconfig/openssl.pc" length:100];
+    [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate: [NSDate dateWithTimeIntervalSinceNow:60]} ofItemAtPath:[_prefix stringByAppendingPathComponent:@"Cellar/openssl/1.0.1f/lib/pkgconfig"] error:NULL];
+    NSArray *usages = [_scanner diskUsageOfFormulae:@[[MRBrewFormula formulaWithName:@"openssl"]]];
+    
+    // verify
+    XCTAssertTrue([_scanner walkedKegCount] == 1, @"A keg changed two levels below its directory should be walked again.");
+    XCTAssertTrue([[usages firstObject] fileCount] == 2, @"The rescan should count the file added deep within the keg.");
+}
+
+- (void)testDiscardingCachedMeasurementsWalksEveryKeg
+{
+    // setup
+    [_scanner diskUsageOfFormulae:nil];
+    
+    // execute
+    [_scanner discardCachedMeasurements];
+    [_scanner diskUsageOfFormulae:nil];
+    
+    // verify
+    XCTAssertTrue([_scanner walkedKegCount] == 3, @"Every keg should be walked once the cached measurements are discarded.");
+}
+
+@end
@@ -0,0 +1,226 @@
+//
+//  MRBrewFormulaLoaderTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import <OCMock/OCMock.h>
+#import "MRBrew.h"
+#import "MRBrewFormula.h"
+#import "MRBrewFormulaLoader.h"
+#import "MRBrewConstants.h"
+
+@interface MRBrewFormulaLoaderTests : XCTestCase
+
+@end
+
+@implementation MRBrewFormulaLoaderTests
+
+- (void)setUp
+{
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+}
+
+- (void)tearDown
+{
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+- (void)waitForCondition:(BOOL (^)(void))condition
+{
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:2.0];
+    while (!condition() && [timeout timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+}
+
+- (void)testRequestsWithinBatchIntervalArePerformedAsOneDeduplicatedOperation
+{
+    // setup
+    __block NSUInteger operationCount = 0;
+    __block MRBrewOperation *performedOperation = nil;
+    id brew = [OCMockObject niceMockForClass:[MRBrew class]];
+    [[[brew stub] andDo:^(NSInvocation *invocation) {
+        __unsafe_unretained MRBrewOperation *operation;
+        __unsafe_unretained MRBrewDataHandler dataHandler;
+        __unsafe_unretained MRBrewCompletionHandler completionHandler;
+        [invocation getArgument:&operation atIndex:2];
+        [invocation getArgument:&dataHandler atIndex:4];
+        [invocation getArgument:&completionHandler atIndex:6];
+        
+        operationCount++;
+        performedOperation = operation;
+        dataHandler(operation, [@"[{\"name\":\"one\",\"installed\":[]}," dataUsingEncoding:NSUTF8StringEncoding]);
+        dataHandler(operation, [@"{\"name\":\"two\",\"installed\":[{\"version\":\"2.0\"}]}]" dataUsingEncoding:NSUTF8StringEncoding]);
+        completionHandler(operation);
+    }] performOperation:[OCMArg any] queue:nil data:[OCMArg any] errorData:[OCMArg any] completion:[OCMArg any] failure:[OCMArg any]];
+    
+    MRBrewFormulaLoader *loader = [[MRBrewFormulaLoader alloc] initWithBrew:brew];
+    NSMutableDictionary *results = [NSMutableDictionary dictionary];
+    __block NSUInteger handlerCount = 0;
+    MRBrewFormulaLoaderHandler (^handlerForKey)(NSString *) = ^MRBrewFormulaLoaderHandler(NSString *key) {
+        return ^(MRBrewFormula *formula, NSError *error) {
+            @synchronized(results) {
+                handlerCount++;
+                [results setObject:formula forKey:key];
+            }
+        };
+    };
+    
+    // execute
+    [loader loadFormula:[MRBrewFormula formulaWithName:@"one"] queue:nil handler:handlerForKey(@"first")];
+    [loader loadFormula:[MRBrewFormula formulaWithName:@"two"] queue:nil handler:handlerForKey(@"second")];
+    [loader loadFormula:[MRBrewFormula formulaWithName:@"one"] queue:nil handler:handlerForKey(@"third")];
+    [self waitForCondition:^BOOL{
+        @synchronized(results) {
+            return handlerCount == 3;
+        }
+    }];
+    
+    // verify
+    XCTAssertTrue(operationCount == 1, @"Requests made within the batch interval should be performed by a single operation.");
+    XCTAssertEqualObjects([performedOperation parameters], (@[MRBrewOperationJSONInfoParameter, @"one", @"two"]), @"Each formula name should be passed to the operation once.");
+    XCTAssertEqualObjects([[results objectForKey:@"first"] name], @"one", @"Each requester should receive the formula it requested.");
+    XCTAssertEqualObjects([[results objectForKey:@"second"] installedVersions], @[@"2.0"], @"Each requester should receive the formula it requested.");
+    XCTAssertEqual([results objectForKey:@"first"], [results objectForKey:@"third"], @"Requesters of the same formula should receive the same result.");
+}
+
+- (void)testFailedBatchIsSplitToIsolateFailingFormula
+{
+    // setup
+    NSMutableArray *performedNames = [NSMutableArray array];
+    id brew = [OCMockObject niceMockForClass:[MRBrew class]];
+    [[[brew stub] andDo:^(NSInvocation *invocation) {
+        __unsafe_unretained MRBrewOperation *operation;
+        __unsafe_unretained MRBrewDataHandler dataHandler;
+        __unsafe_unretained MRBrewDataHandler errorDataHandler;
+        __unsafe_unretained MRBrewCompletionHandler completionHandler;
+        __unsafe_unretained MRBrewFailureHandler failureHandler;
+        [invocation getArgument:&operation atIndex:2];
+        [invocation getArgument:&dataHandler atIndex:4];
+        [invocation getArgument:&errorDataHandler atIndex:5];
+        [invocation getArgument:&completionHandler atIndex:6];
+        [invocation getArgument:&failureHandler atIndex:7];
+        
+        NSArray *names = [[operation parameters] subarrayWithRange:NSMakeRange(1, [[operation parameters] count] - 1)];
+        @synchronized(performedNames) {
+            [performedNames addObject:names];
+        }
+        
+        if ([names containsObject:@"missing"]) {
+            errorDataHandler(operation, [@"Error: No available formula with the name \"missing\"\n" dataUsingEncoding:NSUTF8StringEncoding]);
+            failureHandler(operation, [NSError errorWithDomain:@"test" code:MRBrewErrorUnknown userInfo:nil]);
+        }
+        else {
+            dataHandler(operation, [[NSString stringWithFormat:@"[{\"name\":\"%@\"}]", [names objectAtIndex:0]] dataUsingEncoding:NSUTF8StringEncoding]);
+            completionHandler(operation);
+        }
+    }] performOperation:[OCMArg any] queue:nil data:[OCMArg any] errorData:[OCMArg any] completion:[OCMArg any] failure:[OCMArg any]];
+    
+    MRBrewFormulaLoader *loader = [[MRBrewFormulaLoader alloc] initWithBrew:brew];
+    __block MRBrewFormula *loadedFormula = nil;
+    __block NSError *missingError = nil;
+    
+    // execute
+    [loader loadFormula:[MRBrewFormula formulaWithName:@"present"] queue:nil handler:^(MRBrewFormula *formula, NSError *error) {
+        loadedFormula = formula;
+    }];
+    [loader loadFormula:[MRBrewFormula formulaWithName:@"missing"] queue:nil handler:^(MRBrewFormula *formula, NSError *error) {
+        missingError = error;
+    }];
+    [self waitForCondition:^BOOL{
+        return loadedFormula && missingError;
+    }];
+    
+    // verify
+    XCTAssertEqualObjects([loadedFormula name], @"present", @"A formula should load despite another formula in its batch failing.");
+    XCTAssertNotNil(missingError, @"The failing formula's requester should receive an error.");
+    XCTAssertTrue([performedNames count] == 3, @"The failed batch should be retried as two halves.");
+}
+
+- (void)testBatchFailingForAnotherReasonFailsEveryRequestWithoutSplitting
+{
+    // setup
+    __block NSUInteger operationCount = 0;
+    id brew = [OCMockObject niceMockForClass:[MRBrew class]];
+    [[[brew stub] andDo:^(NSInvocation *invocation) {
+        __unsafe_unretained MRBrewOperation *operation;
+        __unsafe_unretained MRBrewDataHandler errorDataHandler;
+        __unsafe_unretained MRBrewFailureHandler failureHandler;
+        [invocation getArgument:&operation atIndex:2];
+        [invocation getArgument:&errorDataHandler atIndex:5];
+        [invocation getArgument:&failureHandler atIndex:7];
+        
+        operationCount++;
+        errorDataHandler(operation, [@"Error: Another active Homebrew process is already in progress.\n" dataUsingEncoding:NSUTF8StringEncoding]);
+        failureHandler(operation, [NSError errorWithDomain:MRBrewErrorDomain code:MRBrewErrorLockContention userInfo:nil]);
+    }] performOperation:[OCMArg any] queue:nil data:[OCMArg any] errorData:[OCMArg any] completion:[OCMArg any] failure:[OCMArg any]];
+    
+    MRBrewFormulaLoader *loader = [[MRBrewFormulaLoader alloc] initWithBrew:brew];
+    NSMutableArray *errors = [NSMutableArray array];
+    MRBrewFormulaLoaderHandler handler = ^(MRBrewFormula *formula, NSError *error) {
+        @synchronized(errors) {
+            [errors addObject:error];
+        }
+    };
+    
+    // execute
+    [loader loadFormula:[MRBrewFormula formulaWithName:@"one"] queue:nil handler:handler];
+    [loader loadFormula:[MRBrewFormula formulaWithName:@"two"] queue:nil handler:handler];
+    [loader loadFormula:[MRBrewFormula formulaWithName:@"three"] queue:nil handler:handler];
+    [self waitForCondition:^BOOL{
+        @synchronized(errors) {
+            return [errors count] == 3;
+        }
+    }];
+    
+    // verify
+    XCTAssertTrue(operationCount == 1, @"A batch that failed for a reason other than an unknown formula should not be split.");
+    XCTAssertTrue([errors count] == 3, @"Every request in the batch should receive the error.");
+    XCTAssertTrue([[errors firstObject] code] == MRBrewErrorLockContention, @"Requests should receive the batch's error.");
+}
+
+- (void)testRequestsFailWhenTheBrewObjectNoLongerExists
+{
+    // setup
+    MRBrew *brew = [[MRBrew alloc] initWithBrewPath:@"/test/brew"];
+    MRBrewFormulaLoader *loader = [[MRBrewFormulaLoader alloc] initWithBrew:brew];
+    __block NSError *receivedError = nil;
+    
+    // execute
+    [loader loadFormula:[MRBrewFormula formulaWithName:@"wget"] queue:nil handler:^(MRBrewFormula *formula, NSError *error) {
+        receivedError = error;
+    }];
+    brew = nil;
+    [self waitForCondition:^BOOL{
+        return receivedError != nil;
+    }];
+    
+    // verify
+    XCTAssertNotNil(receivedError, @"Requests should fail, rather than never complete, once the brew object is gone.");
+    XCTAssertTrue([receivedError code] == MRBrewErrorOperationCancelled, @"Requests should fail with the cancelled error code.");
+}
+
+@end
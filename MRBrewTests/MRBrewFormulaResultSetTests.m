@@ -0,0 +1,132 @@
+//
+//  MRBrewFormulaResultSetTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "MRBrewFormulaResultSet.h"
+#import "MRBrewFormula.h"
+
+@interface MRBrewFormulaResultSetTests : XCTestCase
+
+@end
+
+@implementation MRBrewFormulaResultSetTests
+
+- (void)setUp
+{
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+}
+
+- (void)tearDown
+{
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+#pragma mark - Creation
+
+- (void)testResultSetContainsFormulaForEachNonEmptyLine
+{
+    // execute
+    MRBrewFormulaResultSet *resultSet = [MRBrewFormulaResultSet resultSetWithLines:@"one\n\ntwo\nthree" status:MRBrewFormulaStatusInstalled];
+    
+    // verify
+    XCTAssertTrue([resultSet count] == 3, @"Result set should contain a formula for each non-empty line.");
+    XCTAssertEqualObjects([resultSet nameAtIndex:2], @"three", @"Result set should store the name on each line.");
+    XCTAssertEqual([resultSet statusAtIndex:1], MRBrewFormulaStatusInstalled, @"Result set should store the status of each formula.");
+}
+
+- (void)testResultSetMaterializesInternedFormulae
+{
+    // setup
+    MRBrewFormulaResultSet *resultSet = [MRBrewFormulaResultSet resultSetWithLines:@"one\ntwo\n" status:MRBrewFormulaStatusInstalled];
+    
+    // execute
+    MRBrewFormula *formula = [resultSet objectAtIndex:1];
+    
+    // verify
+    XCTAssertEqual(formula, [MRBrewFormula formulaWithName:@"two" isNew:NO isUpdated:NO isInstalled:YES], @"Result set should return the interned formula with the stored name and status.");
+    XCTAssertEqualObjects(resultSet, (@[[MRBrewFormula formulaWithName:@"one" isNew:NO isUpdated:NO isInstalled:YES], formula]), @"Result set should be equal to an array of the same formulae.");
+}
+
+- (void)testRepeatedAccessReturnsSameFormula
+{
+    // setup
+    MRBrewFormulaResultSet *resultSet = [MRBrewFormulaResultSet resultSetWithLines:@"one\ntwo\n" status:MRBrewFormulaStatusNew];
+    MRBrewFormula *formula = [resultSet objectAtIndex:0];
+    
+    // execute
+    MRBrewFormula *repeatedFormula = [resultSet objectAtIndex:0];
+    
+    // verify
+    XCTAssertEqual(repeatedFormula, formula, @"Result set should return the same formula each time an index is accessed.");
+    XCTAssertEqualObjects([[resultSet objectAtIndex:1] name], @"two", @"Result set should keep the formula at each index apart.");
+}
+
+#pragma mark - Filtering and Comparing
+
+- (void)testResultSetFilteredByStatusContainsMatchingFormulae
+{
+    // setup
+    MRBrewFormulaResultSet *resultSet = [MRBrewFormulaResultSet resultSetWithFormulae:@[[MRBrewFormula formulaWithName:@"one" isNew:YES isUpdated:NO isInstalled:NO],
+                                                                                      [MRBrewFormula formulaWithName:@"two" isNew:YES isUpdated:NO isInstalled:YES],
+                                                                                      [MRBrewFormula formulaWithName:@"three" isNew:NO isUpdated:NO isInstalled:YES]]];
+    
+    // execute
+    MRBrewFormulaResultSet *filtered = [resultSet resultSetWithStatus:MRBrewFormulaStatusNew | MRBrewFormulaStatusInstalled];
+    
+    // verify
+    XCTAssertTrue([filtered count] == 1, @"Filtered result set should only contain formulae with every specified status flag.");
+    XCTAssertEqualObjects([filtered nameAtIndex:0], @"two", @"Filtered result set should contain the matching formula.");
+}
+
+- (void)testResultSetMatchingStringContainsMatchingNames
+{
+    // setup
+    MRBrewFormulaResultSet *resultSet = [MRBrewFormulaResultSet resultSetWithLines:@"wget\nlibpng\ngit\npng2ico" status:0];
+    
+    // execute
+    MRBrewFormulaResultSet *filtered = [resultSet resultSetMatchingString:@"png"];
+    
+    // verify
+    XCTAssertEqualObjects(filtered, (@[[MRBrewFormula formulaWithName:@"libpng"], [MRBrewFormula formulaWithName:@"png2ico"]]), @"Filtered result set should contain the formulae whose names contain the string.");
+}
+
+- (void)testResultSetDifferenceContainsFormulaeMissingFromOtherResultSet
+{
+    // setup
+    MRBrewFormulaResultSet *before = [MRBrewFormulaResultSet resultSetWithLines:@"git\nwget\nlibpng" status:0];
+    MRBrewFormulaResultSet *after = [MRBrewFormulaResultSet resultSetWithLines:@"git\nlibpng\nnode" status:0];
+    
+    // execute
+    MRBrewFormulaResultSet *removed = [before resultSetByRemovingFormulaeInResultSet:after];
+    MRBrewFormulaResultSet *added = [after resultSetByRemovingFormulaeInResultSet:before];
+    
+    // verify
+    XCTAssertEqualObjects(removed, @[[MRBrewFormula formulaWithName:@"wget"]], @"Difference should contain formulae missing from the other result set.");
+    XCTAssertEqualObjects(added, @[[MRBrewFormula formulaWithName:@"node"]], @"Difference should contain formulae missing from the other result set.");
+}
+
+@end
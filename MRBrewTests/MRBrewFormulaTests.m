@@ -163,8 +163,7 @@
 {
     // setup
     MRBrewFormula *formula1 = [MRBrewFormula formulaWithName:@"formula-name"];
-    MRBrewFormula *formula2 = [MRBrewFormula formulaWithName:@"formula-name"];
-    [formula2 setIsUpdated:YES];
+    MRBrewFormula *formula2 = [MRBrewFormula formulaWithName:@"formula-name" isNew:NO isUpdated:YES isInstalled:NO];
     
     // execute & verify
     XCTAssertFalse([formula1 isEqualToFormula:formula2], @"Formulae that have a different 'updated' property should not be equal.");
@@ -173,8 +172,7 @@
 - (void)testEqualityOfFormulaeWithDifferentNewProperty
 {
     MRBrewFormula *formula1 = [MRBrewFormula formulaWithName:@"formula-name"];
-    MRBrewFormula *formula2 = [MRBrewFormula formulaWithName:@"formula-name"];
-    [formula2 setIsNew:YES];
+    MRBrewFormula *formula2 = [MRBrewFormula formulaWithName:@"formula-name" isNew:YES isUpdated:NO isInstalled:NO];
     
     // execute & verify
     XCTAssertFalse([formula1 isEqualToFormula:formula2], @"Formulae that have a different 'new' property should not be equal.");
@@ -183,8 +181,7 @@
 - (void)testEqualityOfFormulaeWithDifferentInstalledProperty
 {
     MRBrewFormula *formula1 = [MRBrewFormula formulaWithName:@"formula-name"];
-    MRBrewFormula *formula2 = [MRBrewFormula formulaWithName:@"formula-name"];
-    [formula2 setIsInstalled:YES];
+    MRBrewFormula *formula2 = [MRBrewFormula formulaWithName:@"formula-name" isNew:NO isUpdated:NO isInstalled:YES];
     
     // execute & verify
     XCTAssertFalse([formula1 isEqualToFormula:formula2], @"Formulae that have a different 'installed' property should not be equal.");
@@ -221,4 +218,51 @@
     XCTAssertTrue([copy isEqualToFormula:formula], @"Formula copy should be identical to original formula.");
 }
 
+- (void)testCopiedFormulaIsOriginalFormula
+{
+    // setup
+    MRBrewFormula *formula = [MRBrewFormula formulaWithName:@"formula-name"];
+    
+    // execute & verify
+    XCTAssertEqual([formula copy], formula, @"Copying an immutable formula should return the original formula.");
+}
+
+#pragma mark - Interning
+
+- (void)testFormulaeWithIdenticalNameAndStatusAreInterned
+{
+    // setup
+    MRBrewFormula *formula1 = [MRBrewFormula formulaWithName:@"formula-name" isNew:NO isUpdated:NO isInstalled:YES];
+    MRBrewFormula *formula2 = [[MRBrewFormula alloc] initWithName:[NSMutableString stringWithString:@"formula-name"] isNew:NO isUpdated:NO isInstalled:YES];
+    
+    // execute & verify
+    XCTAssertEqual(formula1, formula2, @"Formulae with an identical name and status should be the same object.");
+}
+
+- (void)testFormulaeWithIdenticalNameShareNameAndHash
+{
+    // setup
+    MRBrewFormula *formula1 = [MRBrewFormula formulaWithName:@"formula-name"];
+    MRBrewFormula *formula2 = [MRBrewFormula formulaWithName:[NSMutableString stringWithString:@"formula-name"] isNew:YES isUpdated:NO isInstalled:NO];
+    
+    // execute & verify
+    XCTAssertEqual([formula1 name], [formula2 name], @"Formulae with an identical name should share the same name object.");
+    XCTAssertEqual([formula1 hash], [formula2 hash], @"Formulae with an identical name should have the same hash.");
+}
+
+- (void)testFormulaeCanBeDeduplicatedInSet
+{
+    // setup
+    NSArray *formulae = @[[MRBrewFormula formulaWithName:@"one"],
+                          [MRBrewFormula formulaWithName:[NSMutableString stringWithString:@"one"]],
+                          [MRBrewFormula formulaWithName:@"two"]];
+    
+    // execute
+    NSSet *set = [NSSet setWithArray:formulae];
+    
+    // verify
+    XCTAssertTrue([set count] == 2, @"Equal formulae should be deduplicated when added to a set.");
+    XCTAssertTrue([set containsObject:[MRBrewFormula formulaWithName:@"two"]], @"A set should contain a formula equal to one that was added.");
+}
+
 @end
@@ -0,0 +1,166 @@
+//
+//  MRBrewFutureTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "MRBrewFuture.h"
+#import "MRBrewFuture+Private.h"
+#import "MRBrewOperation.h"
+
+@interface MRBrewFutureTests : XCTestCase
+
+@end
+
+@implementation MRBrewFutureTests
+
+#pragma mark - Resolution
+
+- (void)testNewFutureIsPending
+{
+    // execute
+    MRBrewFuture *future = [[MRBrewFuture alloc] initWithOperation:nil];
+
+    // verify
+    XCTAssertTrue([future state] == MRBrewFutureStatePending, @"A new future should be pending.");
+    XCTAssertFalse([future isResolved], @"A new future should not be resolved.");
+}
+
+- (void)testFulfilledFutureRetainsOutputAndObjects
+{
+    // setup
+    MRBrewFuture *future = [[MRBrewFuture alloc] initWithOperation:[MRBrewOperation listOperation]];
+    NSArray *objects = @[@"object"];
+
+    // execute
+    [future fulfillWithOutput:@"output" objects:objects];
+
+    // verify
+    XCTAssertTrue([future state] == MRBrewFutureStateFulfilled, @"Future should be fulfilled.");
+    XCTAssertEqualObjects([future output], @"output", @"Future should retain the output it was fulfilled with.");
+    XCTAssertEqualObjects([future objects], objects, @"Future should retain the objects it was fulfilled with.");
+}
+
+- (void)testFutureIsResolvedOnlyOnce
+{
+    // setup
+    MRBrewFuture *future = [[MRBrewFuture alloc] initWithOperation:nil];
+
+    // execute
+    [future fulfillWithOutput:@"output" objects:nil];
+    [future rejectWithError:[NSError errorWithDomain:@"test" code:1 userInfo:nil]];
+
+    // verify
+    XCTAssertTrue([future state] == MRBrewFutureStateFulfilled, @"Resolving a future a second time should have no effect.");
+    XCTAssertNil([future error], @"Resolving a future a second time should have no effect.");
+}
+
+- (void)testHandlerRegisteredAfterResolutionIsExecuted
+{
+    // setup
+    MRBrewFuture *future = [[MRBrewFuture alloc] initWithOperation:nil];
+    [future fulfillWithOutput:nil objects:nil];
+    __block BOOL handlerExecuted = NO;
+
+    // execute
+    [future whenResolved:^(MRBrewFuture *resolved) {
+        handlerExecuted = YES;
+    } queue:nil];
+
+    // verify
+    XCTAssertTrue(handlerExecuted, @"Handler should be executed immediately when the future is already resolved.");
+}
+
+#pragma mark - Composition
+
+- (void)testThenExecutesContinuationWhenReceiverIsFulfilled
+{
+    // setup
+    MRBrewFuture *first = [[MRBrewFuture alloc] initWithOperation:nil];
+    MRBrewFuture *second = [[MRBrewFuture alloc] initWithOperation:nil];
+
+    MRBrewFuture *chained = [first then:^MRBrewFuture *(MRBrewFuture *future) {
+        return second;
+    }];
+
+    // execute
+    [first fulfillWithOutput:@"first" objects:nil];
+    [second fulfillWithOutput:@"second" objects:nil];
+
+    // verify
+    XCTAssertEqualObjects([chained output], @"second", @"Chained future should be resolved with the result of the continuation's future.");
+}
+
+- (void)testThenSkipsContinuationWhenReceiverIsRejected
+{
+    // setup
+    MRBrewFuture *first = [[MRBrewFuture alloc] initWithOperation:nil];
+    NSError *error = [NSError errorWithDomain:@"test" code:1 userInfo:nil];
+    __block BOOL continuationExecuted = NO;
+
+    MRBrewFuture *chained = [first then:^MRBrewFuture *(MRBrewFuture *future) {
+        continuationExecuted = YES;
+        return nil;
+    }];
+
+    // execute
+    [first rejectWithError:error];
+
+    // verify
+    XCTAssertFalse(continuationExecuted, @"Continuation should not be executed when the receiver is rejected.");
+    XCTAssertEqual([chained error], error, @"Chained future should be rejected with the receiver's error.");
+}
+
+- (void)testAllIsFulfilledOnlyWhenEveryFutureIsFulfilled
+{
+    // setup
+    MRBrewFuture *first = [[MRBrewFuture alloc] initWithOperation:nil];
+    MRBrewFuture *second = [[MRBrewFuture alloc] initWithOperation:nil];
+    MRBrewFuture *combined = [MRBrewFuture all:@[first, second]];
+
+    // execute & verify
+    [first fulfillWithOutput:nil objects:nil];
+    XCTAssertFalse([combined isResolved], @"Combined future should remain pending until every input is fulfilled.");
+
+    [second fulfillWithOutput:nil objects:nil];
+    XCTAssertTrue([combined state] == MRBrewFutureStateFulfilled, @"Combined future should be fulfilled once every input is fulfilled.");
+    XCTAssertEqualObjects([combined objects], (@[first, second]), @"Combined future should contain the input futures in order.");
+}
+
+- (void)testAnyIsResolvedWithFirstFulfilledFuture
+{
+    // setup
+    MRBrewFuture *first = [[MRBrewFuture alloc] initWithOperation:nil];
+    MRBrewFuture *second = [[MRBrewFuture alloc] initWithOperation:nil];
+    MRBrewFuture *combined = [MRBrewFuture any:@[first, second]];
+
+    // execute
+    [first rejectWithError:[NSError errorWithDomain:@"test" code:1 userInfo:nil]];
+    [second fulfillWithOutput:@"second" objects:nil];
+
+    // verify
+    XCTAssertTrue([combined state] == MRBrewFutureStateFulfilled, @"Combined future should be fulfilled when any input is fulfilled.");
+    XCTAssertEqualObjects([combined output], @"second", @"Combined future should be resolved with the first fulfilled input.");
+}
+
+@end
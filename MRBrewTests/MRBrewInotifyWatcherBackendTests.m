@@ -0,0 +1,223 @@
+//
+//  MRBrewInotifyWatcherBackendTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "XCTestCase+MRBrewFixtures.h"
+#import "MRBrewInotifyWatcherBackend.h"
+
+#if defined(__linux__)
+
+static const NSTimeInterval MRBrewInotifyTestLatency = 0.1;
+static const NSTimeInterval MRBrewInotifyTestTimeout = 2.0;
+
+@interface MRBrewInotifyWatcherBackendTests : XCTestCase {
+    NSString *_rootPath;
+    MRBrewInotifyWatcherBackend *_backend;
+    NSMutableSet *_reportedPaths;
+}
+
+@end
+
+@implementation MRBrewInotifyWatcherBackendTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    _rootPath = [self createTemporaryDirectory];
+    [self createDirectoryAtPath:@"Cellar/wget/1.14" inDirectory:_rootPath];
+    
+    _reportedPaths = [NSMutableSet set];
+    _backend = [[MRBrewInotifyWatcherBackend alloc] init];
+}
+
+- (void)tearDown
+{
+    [_backend stopWatching];
+    [[NSFileManager defaultManager] removeItemAtPath:_rootPath error:NULL];
+    [super tearDown];
+}
+
+- (NSString *)pathForRelativePath:(NSString *)path
+{
+    return [_rootPath stringByAppendingPathComponent:path];
+}
+
+- (void)startWatching
+{
+    NSMutableSet *reportedPaths = _reportedPaths;
+    [_backend startWatchingPaths:@[_rootPath] latency:MRBrewInotifyTestLatency handler:^(NSArray *paths) {
+        @synchronized(reportedPaths) {
+            [reportedPaths addObjectsFromArray:paths];
+        }
+    }];
+}
+
+/* Waits for the backend to report the specified path, returning NO if it has
+ * not been reported before the timeout.
+ */
+- (BOOL)waitForReportedPath:(NSString *)path
+{
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:MRBrewInotifyTestTimeout];
+    
+    while ([timeout timeIntervalSinceNow] > 0) {
+        @synchronized(_reportedPaths) {
+            if ([_reportedPaths containsObject:path]) {
+                return YES;
+            }
+        }
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    
+    return NO;
+}
+
+- (void)testCreatedDirectoryIsReportedAndWatched
+{
+    // setup
+    [self startWatching];
+    
+    // execute
+    [self createDirectoryAtPath:@"Cellar/wget/1.15" inDirectory:_rootPath];
+    XCTAssertTrue([self waitForReportedPath:[self pathForRelativePath:@"Cellar/wget"]], @"Backend should report the directory a directory was created in.");
+    [self createDirectoryAtPath:@"Cellar/wget/1.15/bin" inDirectory:_rootPath];
+    
+    // verify
+    XCTAssertTrue([self waitForReportedPath:[self pathForRelativePath:@"Cellar/wget/1.15"]], @"Backend should watch a directory created after watching started.");
+}
+
+- (void)testRenamedDirectoryIsReportedAtItsNewPath
+{
+    // setup
+    [self startWatching];
+    
+    // execute
+    [[NSFileManager defaultManager] moveItemAtPath:[self pathForRelativePath:@"Cellar/wget"] toPath:[self pathForRelativePath:@"Cellar/curl"] error:NULL];
+    XCTAssertTrue([self waitForReportedPath:[self pathForRelativePath:@"Cellar"]], @"Backend should report the directory a directory was renamed in.");
+    @synchronized(_reportedPaths) {
+        [_reportedPaths removeAllObjects];
+    }
+    [self createDirectoryAtPath:@"Cellar/curl/1.14/bin" inDirectory:_rootPath];
+    
+    // verify
+    XCTAssertTrue([self waitForReportedPath:[self pathForRelativePath:@"Cellar/curl/1.14"]], @"Backend should report events in a renamed directory at its new path.");
+    @synchronized(_reportedPaths) {
+        XCTAssertFalse([_reportedPaths containsObject:[self pathForRelativePath:@"Cellar/wget/1.14"]], @"Backend should not report events in a renamed directory at its old path.");
+    }
+}
+
+- (void)testDeletedDirectoryIsReported
+{
+    // setup
+    [self startWatching];
+    
+    // execute
+    [[NSFileManager defaultManager] removeItemAtPath:[self pathForRelativePath:@"Cellar/wget"] error:NULL];
+    
+    // verify
+    XCTAssertTrue([self waitForReportedPath:[self pathForRelativePath:@"Cellar"]], @"Backend should report the directory a directory was deleted from.");
+    XCTAssertTrue([self waitForReportedPath:[self pathForRelativePath:@"Cellar/wget"]], @"Backend should report a deleted directory.");
+}
+
+- (void)testWatchedPathCreatedAfterWatchingStartsIsWatched
+{
+    // setup
+    NSString *pinnedKegsPath = [self pathForRelativePath:@"Library/PinnedKegs"];
+    NSMutableSet *reportedPaths = _reportedPaths;
+    [_backend startWatchingPaths:@[pinnedKegsPath] latency:MRBrewInotifyTestLatency handler:^(NSArray *paths) {
+        @synchronized(reportedPaths) {
+            [reportedPaths addObjectsFromArray:paths];
+        }
+    }];
+    
+    // execute
+    [self createDirectoryAtPath:@"Library/PinnedKegs" inDirectory:_rootPath];
+    XCTAssertTrue([self waitForReportedPath:pinnedKegsPath], @"Backend should report a watched path when it is created.");
+    @synchronized(_reportedPaths) {
+        [_reportedPaths removeAllObjects];
+    }
+    [self createDirectoryAtPath:@"Library/PinnedKegs/wget" inDirectory:_rootPath];
+    
+    // verify
+    XCTAssertTrue([self waitForReportedPath:pinnedKegsPath], @"Backend should watch a path created after watching started.");
+    @synchronized(_reportedPaths) {
+        XCTAssertFalse([_reportedPaths containsObject:[self pathForRelativePath:@"Library"]], @"Backend should not report events in the ancestor of a missing path.");
+    }
+}
+
+- (void)testWatchedPathIsWatchedAgainWhenRecreated
+{
+    // setup
+    NSString *cellarPath = [self pathForRelativePath:@"Cellar"];
+    NSMutableSet *reportedPaths = _reportedPaths;
+    [_backend startWatchingPaths:@[cellarPath] latency:MRBrewInotifyTestLatency handler:^(NSArray *paths) {
+        @synchronized(reportedPaths) {
+            [reportedPaths addObjectsFromArray:paths];
+        }
+    }];
+    
+    // execute
+    [[NSFileManager defaultManager] removeItemAtPath:cellarPath error:NULL];
+    XCTAssertTrue([self waitForReportedPath:cellarPath], @"Backend should report a deleted watched path.");
+    @synchronized(_reportedPaths) {
+        [_reportedPaths removeAllObjects];
+    }
+    [self createDirectoryAtPath:@"Cellar" inDirectory:_rootPath];
+    XCTAssertTrue([self waitForReportedPath:cellarPath], @"Backend should report a watched path when it is recreated.");
+    @synchronized(_reportedPaths) {
+        [_reportedPaths removeAllObjects];
+    }
+    [self createDirectoryAtPath:@"Cellar/curl" inDirectory:_rootPath];
+    
+    // verify
+    XCTAssertTrue([self waitForReportedPath:cellarPath], @"Backend should watch a watched path again once it is recreated.");
+}
+
+- (void)testWatchFailureIsReported
+{
+    // setup
+    NSString *filePath = [self writeData:[NSData data] toFileAtPath:@"file" inDirectory:_rootPath];
+    __block NSError *reportedError = nil;
+    [_backend setWatchErrorHandler:^(NSString *path, NSError *error) {
+        reportedError = error;
+    }];
+    
+    // execute
+    [_backend startWatchingPaths:@[filePath] latency:MRBrewInotifyTestLatency handler:nil];
+    
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:MRBrewInotifyTestTimeout];
+    while (!reportedError && [timeout timeIntervalSinceNow] > 0) {
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    
+    // verify
+    XCTAssertEqualObjects([reportedError domain], NSPOSIXErrorDomain, @"Backend should report a path that could not be watched.");
+    XCTAssertEqual([reportedError code], (NSInteger)ENOTDIR, @"Backend should report the reason a path could not be watched.");
+    XCTAssertEqualObjects([[reportedError userInfo] objectForKey:NSFilePathErrorKey], filePath, @"Backend should report the path that could not be watched.");
+}
+
+@end
+
+#endif
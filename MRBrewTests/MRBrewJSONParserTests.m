@@ -0,0 +1,191 @@
+//
+//  MRBrewJSONParserTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "MRBrewJSONParser.h"
+
+@interface MRBrewJSONParserTests : XCTestCase <MRBrewJSONParserDelegate>
+{
+    NSMutableArray *_events;
+    NSString *_keyToSkip;
+}
+
+@end
+
+@implementation MRBrewJSONParserTests
+
+- (void)setUp
+{
+    [super setUp];
+    _events = [NSMutableArray array];
+    _keyToSkip = nil;
+}
+
+- (void)tearDown
+{
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+- (BOOL)parseChunks:(NSArray *)chunks
+{
+    MRBrewJSONParser *parser = [[MRBrewJSONParser alloc] initWithDelegate:self];
+    
+    for (NSString *chunk in chunks) {
+        if (![parser parseData:[chunk dataUsingEncoding:NSUTF8StringEncoding]]) {
+            return NO;
+        }
+    }
+    
+    return [parser finish];
+}
+
+- (void)testParserReportsElementsInOrder
+{
+    // execute
+    BOOL parsed = [self parseChunks:@[@"{\"a\": [1, 2.5, true, null], \"b\": \"c\"}"]];
+    
+    // verify
+    NSArray *expectedEvents = @[@"{", @"key:a", @"[", @1, @2.5, @YES, [NSNull null], @"]", @"key:b", @"string:c", @"}"];
+    XCTAssertTrue(parsed, @"Parser should accept a valid document.");
+    XCTAssertEqualObjects(_events, expectedEvents, @"Parser should report each element in document order.");
+}
+
+- (void)testParserResumesTokensSplitAcrossChunks
+{
+    // execute
+    BOOL parsed = [self parseChunks:@[@"[\"spl", @"it\", tr", @"ue, 12", @"3]"]];
+    
+    // verify
+    NSArray *expectedEvents = @[@"[", @"string:split", @YES, @123, @"]"];
+    XCTAssertTrue(parsed, @"Parser should accept a valid document split into chunks.");
+    XCTAssertEqualObjects(_events, expectedEvents, @"Parser should report tokens that span chunks once they are complete.");
+}
+
+- (void)testParserResolvesEscapeSequences
+{
+    // execute
+    BOOL parsed = [self parseChunks:@[@"[\"a\\\"b\\\\c\\n\\u00e9\\ud83c\\udf7a\"]"]];
+    
+    // verify
+    NSArray *expectedEvents = @[@"[", @"string:a\"b\\c\né\U0001F37A", @"]"];
+    XCTAssertTrue(parsed, @"Parser should accept a string containing escape sequences.");
+    XCTAssertEqualObjects(_events, expectedEvents, @"Parser should resolve escape sequences, including surrogate pairs.");
+}
+
+- (void)testParserResumesStringSplitAcrossManyChunks
+{
+    // setup
+    NSString *document = @"[\"one\\\"two\\u00e9three\"]";
+    NSMutableArray *chunks = [NSMutableArray array];
+    for (NSUInteger i = 0; i < [document length]; i++) {
+        [chunks addObject:[document substringWithRange:NSMakeRange(i, 1)]];
+    }
+    
+    // execute
+    BOOL parsed = [self parseChunks:chunks];
+    
+    // verify
+    NSArray *expectedEvents = @[@"[", @"string:one\"twoéthree", @"]"];
+    XCTAssertTrue(parsed, @"Parser should accept a string split into single bytes, including its escape sequences.");
+    XCTAssertEqualObjects(_events, expectedEvents, @"Parser should report a string split across many chunks once it is complete.");
+}
+
+- (void)testParserSkipsValueWhenRequested
+{
+    // setup
+    _keyToSkip = @"skip";
+    
+    // execute
+    BOOL parsed = [self parseChunks:@[@"{\"skip\": {\"x\": [1, {\"y\": \"z\"}]}, \"keep\": 1}"]];
+    
+    // verify
+    NSArray *expectedEvents = @[@"{", @"key:skip", @"key:keep", @1, @"}"];
+    XCTAssertTrue(parsed, @"Parser should accept a document with a skipped value.");
+    XCTAssertEqualObjects(_events, expectedEvents, @"Parser should not report the contents of a skipped value.");
+}
+
+- (void)testParserRejectsMalformedDocuments
+{
+    // execute & verify
+    XCTAssertFalse([self parseChunks:@[@"[1 2]"]], @"Parser should reject a missing comma.");
+    XCTAssertFalse([self parseChunks:@[@"{\"a\" 1}"]], @"Parser should reject a missing colon.");
+    XCTAssertFalse([self parseChunks:@[@"[1}"]], @"Parser should reject mismatched brackets.");
+    XCTAssertFalse([self parseChunks:@[@"[\"unterminated"]], @"Parser should reject an unterminated string.");
+    XCTAssertFalse([self parseChunks:@[@"[1]", @"[2]"]], @"Parser should reject data after the document.");
+}
+
+#pragma mark - MRBrewJSONParserDelegate protocol
+
+- (void)parserDidStartObject:(MRBrewJSONParser *)parser
+{
+    [_events addObject:@"{"];
+}
+
+- (void)parserDidEndObject:(MRBrewJSONParser *)parser
+{
+    [_events addObject:@"}"];
+}
+
+- (void)parserDidStartArray:(MRBrewJSONParser *)parser
+{
+    [_events addObject:@"["];
+}
+
+- (void)parserDidEndArray:(MRBrewJSONParser *)parser
+{
+    [_events addObject:@"]"];
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundKey:(NSString *)key
+{
+    [_events addObject:[@"key:" stringByAppendingString:key]];
+    
+    if ([key isEqualToString:_keyToSkip]) {
+        [parser skipNextValue];
+    }
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundString:(NSString *)string
+{
+    [_events addObject:[@"string:" stringByAppendingString:string]];
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundNumber:(NSNumber *)number
+{
+    [_events addObject:number];
+}
+
+- (void)parser:(MRBrewJSONParser *)parser foundBool:(BOOL)value
+{
+    [_events addObject:@(value)];
+}
+
+- (void)parserFoundNull:(MRBrewJSONParser *)parser
+{
+    [_events addObject:[NSNull null]];
+}
+
+@end
@@ -0,0 +1,152 @@
+//
+//  MRBrewLocationsTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "XCTestCase+MRBrewFixtures.h"
+#import "MRBrewLocations.h"
+
+@interface MRBrewLocationsTests : XCTestCase {
+    NSString *_prefix;
+    NSString *_brewPath;
+    NSString *_storePath;
+}
+
+@end
+
+@implementation MRBrewLocationsTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    _prefix = [self createTemporaryDirectory];
+    _brewPath = [_prefix stringByAppendingPathComponent:@"bin/brew"];
+    _storePath = [_prefix stringByAppendingPathComponent:@"Store/BrewLocations.plist"];
+    
+    [self createDirectoryAtPath:@"bin" inDirectory:_prefix];
+    [self createDirectoryAtPath:@"Cellar" inDirectory:_prefix];
+    [self createDirectoryAtPath:@"Library/Homebrew" inDirectory:_prefix];
+    [self writeBrewScript:@"exit 1\n"];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:_prefix error:NULL];
+    [super tearDown];
+}
+
+- (void)writeBrewScript:(NSString *)script
+{
+    [[@"#!/bin/sh\n" stringByAppendingString:script] writeToFile:_brewPath atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+    [[NSFileManager defaultManager] setAttributes:@{NSFilePosixPermissions: @0755} ofItemAtPath:_brewPath error:NULL];
+}
+
+- (void)testLocationsAreResolvedFromInstallationLayout
+{
+    // execute
+    MRBrewLocations *locations = [MRBrewLocations locationsForBrewPath:_brewPath storePath:nil];
+    
+    // verify
+    XCTAssertEqualObjects([locations brewPath], [_brewPath stringByStandardizingPath], @"Locations should have the executable they were resolved for.");
+    XCTAssertEqualObjects([locations prefixPath], [_prefix stringByStandardizingPath], @"Prefix should contain the executable.");
+    XCTAssertEqualObjects([locations repositoryPath], [[_prefix stringByResolvingSymlinksInPath] stringByStandardizingPath], @"Repository should contain the file the executable resolves to.");
+    XCTAssertEqualObjects([locations cellarPath], [[_prefix stringByStandardizingPath] stringByAppendingPathComponent:@"Cellar"], @"Cellar should be inside the prefix.");
+    XCTAssertEqualObjects([locations pinnedKegsPath], [[locations repositoryPath] stringByAppendingPathComponent:@"Library/PinnedKegs"], @"Library locations should be inside the repository.");
+}
+
+- (void)testConfigurationIsReadWhenLayoutIsNotRecognised
+{
+    // setup
+    [[NSFileManager defaultManager] removeItemAtPath:[_prefix stringByAppendingPathComponent:@"Library/Homebrew"] error:NULL];
+    [self writeBrewScript:@"echo 'HOMEBREW_VERSION: 0.9.5'\necho 'HOMEBREW_PREFIX: /opt/brew'\necho 'HOMEBREW_CELLAR: /opt/cellar'\n"];
+    
+    // execute
+    MRBrewLocations *locations = [MRBrewLocations locationsForBrewPath:_brewPath storePath:nil];
+    
+    // verify
+    XCTAssertEqualObjects([locations prefixPath], @"/opt/brew", @"Prefix should be read from Homebrew's configuration.");
+    XCTAssertEqualObjects([locations cellarPath], @"/opt/cellar", @"Cellar should be read from Homebrew's configuration.");
+    XCTAssertEqualObjects([locations repositoryPath], @"/opt/brew", @"Repository should default to the prefix when Homebrew does not print it.");
+}
+
+- (void)testStoredLocationsAreUsedWhileExecutableIsUnchanged
+{
+    // setup
+    MRBrewLocations *storedLocations = [MRBrewLocations locationsForBrewPath:_brewPath storePath:_storePath];
+    
+    // without its layout or a working executable the installation can only be
+    // resolved from the store
+    [[NSFileManager defaultManager] removeItemAtPath:[_prefix stringByAppendingPathComponent:@"Library/Homebrew"] error:NULL];
+    
+    // execute
+    MRBrewLocations *locations = [MRBrewLocations locationsForBrewPath:_brewPath storePath:_storePath];
+    
+    // verify
+    XCTAssertNotNil(storedLocations, @"Locations should be resolved from the installation layout.");
+    XCTAssertEqualObjects(locations, storedLocations, @"Stored locations should be used while the executable is unchanged.");
+}
+
+- (void)testStoredLocationsAreDiscardedWhenExecutableChanges
+{
+    // setup
+    [MRBrewLocations locationsForBrewPath:_brewPath storePath:_storePath];
+    [[NSFileManager defaultManager] removeItemAtPath:[_prefix stringByAppendingPathComponent:@"Library/Homebrew"] error:NULL];
+    [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate: [NSDate dateWithTimeIntervalSinceNow:-3600]} ofItemAtPath:_brewPath error:NULL];
+    
+    // execute
+    MRBrewLocations *locations = [MRBrewLocations locationsForBrewPath:_brewPath storePath:_storePath];
+    
+    // verify
+    XCTAssertNil(locations, @"Stored locations should not be used once the executable has changed.");
+}
+
+- (void)testStoredLocationsAreDiscardedWhenPrefixCellarIsRemoved
+{
+    // setup
+    [MRBrewLocations locationsForBrewPath:_brewPath storePath:_storePath];
+    [[NSFileManager defaultManager] removeItemAtPath:[_prefix stringByAppendingPathComponent:@"Cellar"] error:NULL];
+    
+    // execute
+    MRBrewLocations *locations = [MRBrewLocations locationsForBrewPath:_brewPath storePath:_storePath];
+    
+    // verify
+    XCTAssertEqualObjects([locations cellarPath], [[[_prefix stringByResolvingSymlinksInPath] stringByStandardizingPath] stringByAppendingPathComponent:@"Cellar"], @"Cellar should be inside the repository once it has been removed from the prefix.");
+}
+
+- (void)testStoredLocationsAreDiscardedWhenCacheEnvironmentChanges
+{
+    // setup
+    [MRBrewLocations locationsForBrewPath:_brewPath storePath:_storePath];
+    setenv("HOMEBREW_CACHE", "/tmp/homebrew-cache", 1);
+    
+    // execute
+    MRBrewLocations *locations = [MRBrewLocations locationsForBrewPath:_brewPath storePath:_storePath];
+    unsetenv("HOMEBREW_CACHE");
+    
+    // verify
+    XCTAssertEqualObjects([locations cachePath], @"/tmp/homebrew-cache", @"Cache should be read from the environment once it has changed.");
+}
+
+@end
@@ -266,6 +266,17 @@
     XCTAssertNil([operation parameters], @"Operation 'parameters' property should be nil.");
 }
 
+- (void)testInfoOperationForFormulaeHasJSONParameterAndFormulaNames
+{
+    // setup
+    MRBrewOperation *operation = [MRBrewOperation infoOperationForFormulae:@[[MRBrewFormula formulaWithName:@"one"], [MRBrewFormula formulaWithName:@"two"]]];
+    
+    // execute & verify
+    XCTAssertEqual([operation name], MRBrewOperationInfoIdentifier, @"Operation 'name' property should match value of MRBrewOperationInfoIdentifier constant.");
+    XCTAssertNil([operation formula], @"Operation 'formula' property should be nil.");
+    XCTAssertEqualObjects([operation parameters], (@[MRBrewOperationJSONInfoParameter, @"one", @"two"]), @"Operation 'parameters' property should contain the JSON parameter followed by each formula name.");
+}
+
 #pragma mark Remove Operation Initialisation
 
 - (void)testRemoveOperationWithFormulaHasCorrectNameProperty
@@ -353,6 +364,18 @@
     XCTAssertNil([operation parameters], @"Operation 'parameters' property should be nil.");
 }
 
+- (void)testVerboseAndJSONOutdatedOperationsHaveFormatParameters
+{
+    // setup
+    MRBrewOperation *verboseOperation = [MRBrewOperation verboseOutdatedOperation];
+    MRBrewOperation *JSONOperation = [MRBrewOperation outdatedJSONOperation];
+    
+    // execute & verify
+    XCTAssertEqual([verboseOperation name], MRBrewOperationOutdatedIdentifier, @"Operation 'name' property should match value of MRBrewOperationOutdatedIdentifier constant.");
+    XCTAssertEqualObjects([verboseOperation parameters], @[@"--verbose"], @"Operation 'parameters' property should contain the verbose parameter.");
+    XCTAssertEqualObjects([JSONOperation parameters], @[MRBrewOperationJSONInfoParameter], @"Operation 'parameters' property should contain the JSON parameter.");
+}
+
 #pragma mark - Equality Tests
 
 - (void)testEqualityOfSingleOperation
@@ -500,4 +523,36 @@
     XCTAssertTrue([copy isEqualToOperation:operation], @"Operation copy should be identical to original operation.");
 }
 
+- (void)testCopiedOperationHasEnvironmentAndWorkingDirectory
+{
+    // setup
+    MRBrewOperation *operation = [MRBrewOperation updateOperation];
+    [operation setEnvironment:@{@"HOMEBREW_NO_AUTO_UPDATE": @"1"}];
+    [operation setWorkingDirectory:@"/tmp"];
+    
+    // execute
+    MRBrewOperation *copy = [operation copy];
+    
+    // verify
+    XCTAssertEqualObjects([copy environment], [operation environment], @"Operation copy should have the original operation's environment.");
+    XCTAssertEqualObjects([copy workingDirectory], [operation workingDirectory], @"Operation copy should have the original operation's working directory.");
+    XCTAssertFalse([copy isEqualToOperation:[MRBrewOperation updateOperation]], @"Operations with different environments should not be equal.");
+}
+
+#pragma mark - Describing
+
+- (void)testReadOnlyOperationsAreDistinguishedFromOperationsThatModifyHomebrew
+{
+    // setup
+    MRBrewFormula *formula = [MRBrewFormula formulaWithName:@"wget"];
+    
+    // execute & verify
+    XCTAssertTrue([[MRBrewOperation listOperation] isReadOnly], @"List operation should be read-only.");
+    XCTAssertTrue([[MRBrewOperation infoOperation:formula] isReadOnly], @"Info operation should be read-only.");
+    XCTAssertTrue([[MRBrewOperation outdatedOperation] isReadOnly], @"Outdated operation should be read-only.");
+    XCTAssertFalse([[MRBrewOperation installOperation:formula] isReadOnly], @"Install operation should not be read-only.");
+    XCTAssertFalse([[MRBrewOperation updateOperation] isReadOnly], @"Update operation should not be read-only.");
+    XCTAssertFalse([[MRBrewOperation operationWithName:@"upgrade" formula:nil parameters:nil] isReadOnly], @"Unknown operations should not be read-only.");
+}
+
 @end
@@ -0,0 +1,130 @@
+//
+//  MRBrewOutdatedReaderTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "MRBrewOutdatedReader.h"
+#import "MRBrewFormula.h"
+
+@interface MRBrewOutdatedReaderTests : XCTestCase
+
+@end
+
+@implementation MRBrewOutdatedReaderTests
+
+- (void)setUp
+{
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+}
+
+- (void)tearDown
+{
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+- (NSData *)dataWithString:(NSString *)string
+{
+    return [string dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+#pragma mark - Text Output
+
+- (void)testNamesAreReadFromTextOutput
+{
+    // execute
+    NSArray *formulae = [MRBrewOutdatedReader formulaeFromData:[self dataWithString:@"wget\ngit\n"] format:MRBrewOutdatedFormatText];
+    
+    // verify
+    XCTAssertTrue([formulae count] == 2, @"A formula should be read from each line of output.");
+    XCTAssertEqualObjects([[formulae objectAtIndex:1] name], @"git", @"Formula name should be read.");
+    XCTAssertTrue([[formulae objectAtIndex:0] isOutdated] && [[formulae objectAtIndex:0] isInstalled], @"Formula should be installed and outdated.");
+}
+
+- (void)testVersionsAndPinnedStateAreReadFromVerboseTextOutput
+{
+    // execute
+    NSArray *formulae = [MRBrewOutdatedReader formulaeFromData:[self dataWithString:@"wget (1.14, 1.15) < 1.16\nlibpng (1.6.10) != 1.6.12 [pinned at 1.6.10]\n"] format:MRBrewOutdatedFormatText];
+    MRBrewFormula *wget = [formulae objectAtIndex:0];
+    MRBrewFormula *libpng = [formulae objectAtIndex:1];
+    
+    // verify
+    XCTAssertEqualObjects([wget installedVersions], (@[@"1.14", @"1.15"]), @"Installed versions should be read.");
+    XCTAssertEqualObjects([wget availableVersion], @"1.16", @"Available version should be read.");
+    XCTAssertFalse([wget isPinned], @"Formula without a pinned suffix should not be pinned.");
+    XCTAssertEqualObjects([libpng availableVersion], @"1.6.12", @"Available version should be read from output using the older comparison operator.");
+    XCTAssertTrue([libpng isPinned], @"Formula with a pinned suffix should be pinned.");
+}
+
+- (void)testFormulaeAreDeliveredAsSoonAsTheirLineIsRead
+{
+    // setup
+    NSMutableArray *delivered = [NSMutableArray array];
+    MRBrewOutdatedReader *reader = [[MRBrewOutdatedReader alloc] initWithFormat:MRBrewOutdatedFormatText];
+    [reader setHandler:^(MRBrewFormula *formula) {
+        [delivered addObject:[formula name]];
+    }];
+    
+    // execute
+    [reader readData:[self dataWithString:@"wget (1.15) < 1.16\ngi"]];
+    NSArray *deliveredBeforeFinishing = [delivered copy];
+    [reader readData:[self dataWithString:@"t (2.0) < 2.1"]];
+    NSArray *formulae = [reader finishReading];
+    
+    // verify
+    XCTAssertEqualObjects(deliveredBeforeFinishing, @[@"wget"], @"Formulae should be delivered as soon as their line is complete.");
+    XCTAssertEqualObjects(delivered, (@[@"wget", @"git"]), @"A final line without a newline should be delivered when reading finishes.");
+    XCTAssertTrue([formulae count] == 2, @"Every formula should be returned when reading finishes.");
+}
+
+- (void)testMalformedVerboseTextOutputFails
+{
+    // execute
+    NSArray *formulae = [MRBrewOutdatedReader formulaeFromData:[self dataWithString:@"wget (1.15 < 1.16\n"] format:MRBrewOutdatedFormatText];
+    
+    // verify
+    XCTAssertNil(formulae, @"Output with an unterminated version list should not be read.");
+}
+
+#pragma mark - JSON Output
+
+- (void)testFormulaeAreReadFromJSONOutput
+{
+    // setup
+    NSString *output = @"[{\"name\":\"wget\",\"installed_versions\":[\"1.14\",\"1.15\"],\"current_version\":\"1.16\",\"pinned\":true,\"pinned_version\":\"1.15\"}]";
+    
+    // execute
+    NSArray *formulae = [MRBrewOutdatedReader formulaeFromData:[self dataWithString:output] format:MRBrewOutdatedFormatJSON];
+    MRBrewFormula *wget = [formulae firstObject];
+    
+    // verify
+    XCTAssertTrue([formulae count] == 1, @"A formula should be read for each JSON object.");
+    XCTAssertEqualObjects([wget name], @"wget", @"Formula name should be read.");
+    XCTAssertEqualObjects([wget installedVersions], (@[@"1.14", @"1.15"]), @"Installed versions should be read.");
+    XCTAssertEqualObjects([wget availableVersion], @"1.16", @"Available version should be read.");
+    XCTAssertTrue([wget isPinned], @"Pinned state should be read.");
+}
+
+@end
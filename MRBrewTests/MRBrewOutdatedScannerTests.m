@@ -0,0 +1,167 @@
+//
+//  MRBrewOutdatedScannerTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "XCTestCase+MRBrewFixtures.h"
+#import "MRBrewOutdatedScanner.h"
+#import "MRBrewOutdatedReader.h"
+#import "MRBrewOperation.h"
+#import "MRBrewFormula.h"
+#import "MRBrewConstants.h"
+
+@interface MRBrewOutdatedScannerTests : XCTestCase {
+    NSString *_prefix;
+    MRBrewOutdatedScanner *_scanner;
+}
+
+@end
+
+@implementation MRBrewOutdatedScannerTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    // a Homebrew prefix laid out as Homebrew lays it out, with the output
+    // `brew outdated --verbose` prints for it recorded in the tests below
+    _prefix = [self createTemporaryDirectory];
+    
+    [self createDirectoryAtPath:@"Cellar/wget/1.14" inDirectory:_prefix];
+    [self createDirectoryAtPath:@"Cellar/openssl/1.0.1f" inDirectory:_prefix];
+    [self createDirectoryAtPath:@"Cellar/bar/2.0" inDirectory:_prefix];
+    [self createDirectoryAtPath:@"Cellar/foo/0.9" inDirectory:_prefix];
+    [self createDirectoryAtPath:@"Cellar/git/HEAD" inDirectory:_prefix];
+    [self createDirectoryAtPath:@"Library/LinkedKegs" inDirectory:_prefix];
+    [self createDirectoryAtPath:@"Library/PinnedKegs" inDirectory:_prefix];
+    [[NSFileManager defaultManager] createSymbolicLinkAtPath:[_prefix stringByAppendingPathComponent:@"Library/PinnedKegs/wget"] withDestinationPath:@"../../Cellar/wget/1.14" error:NULL];
+    
+    [self writeFormula:@"Library/Formula/wget.rb" source:
+     @"require 'formula'\n"
+     @"\n"
+     @"class Wget < Formula\n"
+     @"  homepage 'http://www.gnu.org/software/wget/'\n"
+     @"  url 'http://ftpmirror.gnu.org/wget/wget-1.15.tar.xz'\n"
+     @"  sha1 'e9fb1d25fa04f9c69e74e656a3174dca02700ba1'\n"
+     @"\n"
+     @"  head do\n"
+     @"    url 'git://git.savannah.gnu.org/wget.git'\n"
+     @"  end\n"
+     @"\n"
+     @"  devel do\n"
+     @"    url 'http://alpha.gnu.org/gnu/wget/wget-1.16-rc1.tar.xz'\n"
+     @"  end\n"
+     @"\n"
+     @"  def caveats; <<-EOS.undent\n"
+     @"    url 'http://example.com/wget-9.9.tar.gz'\n"
+     @"    EOS\n"
+     @"  end\n"
+     @"end\n"];
+    [self writeFormula:@"Library/Formula/openssl.rb" source:
+     @"class Openssl < Formula\n"
+     @"  url 'https://www.openssl.org/source/openssl-1.0.1f.tar.gz'\n"
+     @"end\n"];
+    [self writeFormula:@"Library/Formula/bar.rb" source:
+     @"class Bar < Formula\n"
+     @"  url \"http://example.com/bar-2.0.tar.gz\"\n"
+     @"  revision 1\n"
+     @"end\n"];
+    [self writeFormula:@"Library/Formula/git.rb" source:
+     @"class Git < Formula\n"
+     @"  url 'https://git-core.googlecode.com/files/git-1.9.0.tar.gz'\n"
+     @"end\n"];
+    [self writeFormula:@"Library/Taps/user/homebrew-tap/foo.rb" source:
+     @"class Foo < Formula\n"
+     @"  url 'http://example.com/foo.tar.gz'\n"
+     @"  version \"1.0\"\n"
+     @"end\n"];
+    
+    _scanner = [[MRBrewOutdatedScanner alloc] initWithPrefix:_prefix];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:_prefix error:NULL];
+    [super tearDown];
+}
+
+- (void)writeFormula:(NSString *)path source:(NSString *)source
+{
+    [self writeData:[source dataUsingEncoding:NSUTF8StringEncoding] toFileAtPath:path inDirectory:_prefix];
+}
+
+- (void)testVerboseOutputMatchesBrewOutdated
+{
+    // setup
+    NSString *brewOutput = @"bar (2.0) < 2.0_1\n"
+                           @"foo (0.9) < 1.0\n"
+                           @"wget (1.14) < 1.15 [pinned at 1.14]\n";
+    
+    // execute
+    NSData *output = [_scanner outputForOperation:[MRBrewOperation verboseOutdatedOperation]];
+    
+    // verify
+    XCTAssertEqualObjects([[NSString alloc] initWithData:output encoding:NSUTF8StringEncoding], brewOutput, @"Verbose output should match that of brew outdated.");
+    
+    NSArray *formulae = [MRBrewOutdatedReader formulaeFromData:output format:MRBrewOutdatedFormatText];
+    XCTAssertEqual([formulae count], (NSUInteger)3, @"Output should be readable by MRBrewOutdatedReader.");
+    XCTAssertEqualObjects([[formulae lastObject] availableVersion], @"1.15", @"Output should be readable by MRBrewOutdatedReader.");
+}
+
+- (void)testOutdatedFormulaeHaveInstalledAndAvailableVersions
+{
+    // execute
+    NSArray *formulae = [_scanner outdatedFormulaeWithNames:nil];
+    
+    // verify
+    XCTAssertEqualObjects([formulae valueForKey:@"name"], (@[@"bar", @"foo", @"wget"]), @"Scanner should report outdated formulae in name order, excluding up to date and HEAD installs.");
+    
+    MRBrewFormula *wget = [formulae lastObject];
+    XCTAssertEqualObjects([wget installedVersions], @[@"1.14"], @"Formula should have its installed versions.");
+    XCTAssertEqualObjects([wget availableVersion], @"1.15", @"Formula should have the version of its stable specification.");
+    XCTAssertTrue([wget isOutdated], @"Formula should be outdated.");
+    XCTAssertTrue([wget isPinned], @"Formula should be pinned if it has a pinned keg.");
+}
+
+- (void)testOutputIsLimitedToOperationFormula
+{
+    // setup
+    MRBrewOperation *operation = [MRBrewOperation operationWithName:MRBrewOperationOutdatedIdentifier formula:[MRBrewFormula formulaWithName:@"foo"] parameters:nil];
+    
+    // execute
+    NSData *output = [_scanner outputForOperation:operation];
+    
+    // verify
+    XCTAssertEqualObjects([[NSString alloc] initWithData:output encoding:NSUTF8StringEncoding], @"foo\n", @"Output should list only the operation's formula.");
+}
+
+- (void)testScannerDoesNotProduceJSONOutput
+{
+    // verify
+    XCTAssertTrue([_scanner canProduceOutputForOperation:[MRBrewOperation outdatedOperation]], @"Scanner should answer plain outdated operations.");
+    XCTAssertFalse([_scanner canProduceOutputForOperation:[MRBrewOperation outdatedJSONOperation]], @"Scanner should leave JSON outdated operations to Homebrew.");
+    XCTAssertFalse([_scanner canProduceOutputForOperation:[MRBrewOperation listOperation]], @"Scanner should only answer outdated operations.");
+}
+
+@end
@@ -0,0 +1,133 @@
+//
+//  MRBrewOutputBufferTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "MRBrewOutputBuffer.h"
+
+@interface MRBrewOutputBufferTests : XCTestCase
+
+@end
+
+@implementation MRBrewOutputBufferTests
+
+- (NSData *)dataWithString:(NSString *)string
+{
+    return [string dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)testDrainIsRequestedOnlyWhenBufferBecomesNonEmpty
+{
+    // setup
+    MRBrewOutputBuffer *buffer = [[MRBrewOutputBuffer alloc] initWithLimit:1024 policy:MRBrewOutputBufferPolicyBlock];
+    
+    // execute
+    BOOL firstRequestsDrain = [buffer appendData:[self dataWithString:@"ack\n"]];
+    BOOL secondRequestsDrain = [buffer appendData:[self dataWithString:@"git\n"]];
+    NSArray *chunks = [buffer drain];
+    BOOL thirdRequestsDrain = [buffer appendData:[self dataWithString:@"wget\n"]];
+    
+    // verify
+    XCTAssertTrue(firstRequestsDrain, @"Appending to an empty buffer should request a drain.");
+    XCTAssertFalse(secondRequestsDrain, @"Appending while a drain is waiting should not request another.");
+    XCTAssertEqualObjects(chunks, (@[[self dataWithString:@"ack\n"], [self dataWithString:@"git\n"]]), @"A drain should return the chunks in the order they were appended.");
+    XCTAssertTrue(thirdRequestsDrain, @"Appending after a drain should request a drain.");
+}
+
+- (void)testDropPolicyDiscardsAndCountsOutputThatDoesNotFit
+{
+    // setup
+    MRBrewOutputBuffer *buffer = [[MRBrewOutputBuffer alloc] initWithLimit:8 policy:MRBrewOutputBufferPolicyDrop];
+    
+    // execute
+    [buffer appendData:[self dataWithString:@"ack\n"]];
+    [buffer appendData:[self dataWithString:@"wget\n"]];
+    [buffer appendData:[self dataWithString:@"git\n"]];
+    NSArray *chunks = [buffer drain];
+    
+    // verify
+    XCTAssertEqualObjects(chunks, (@[[self dataWithString:@"ack\n"], [self dataWithString:@"git\n"]]), @"Chunks that fit within the limit should be kept.");
+    XCTAssertTrue([buffer droppedLength] == 5, @"The length of discarded chunks should be counted.");
+}
+
+- (void)testCoalescePolicyMergesOutputAndKeepsNewestBytes
+{
+    // setup
+    MRBrewOutputBuffer *buffer = [[MRBrewOutputBuffer alloc] initWithLimit:8 policy:MRBrewOutputBufferPolicyCoalesce];
+    
+    // execute
+    [buffer appendData:[self dataWithString:@"ack\n"]];
+    [buffer appendData:[self dataWithString:@"wget\n"]];
+    [buffer appendData:[self dataWithString:@"git\n"]];
+    NSArray *chunks = [buffer drain];
+    
+    // verify
+    XCTAssertEqualObjects(chunks, @[[self dataWithString:@"get\ngit\n"]], @"Waiting output should be merged, keeping the newest bytes.");
+    XCTAssertTrue([buffer droppedLength] == 5, @"The length of the discarded bytes should be counted.");
+}
+
+- (void)testBlockPolicyWaitsForDrainWhenFull
+{
+    // setup
+    MRBrewOutputBuffer *buffer = [[MRBrewOutputBuffer alloc] initWithLimit:4 policy:MRBrewOutputBufferPolicyBlock];
+    [buffer appendData:[self dataWithString:@"ack\n"]];
+    
+    __block BOOL appended = NO;
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [buffer appendData:[self dataWithString:@"git\n"]];
+        appended = YES;
+    });
+    
+    // execute
+    [NSThread sleepForTimeInterval:0.2];
+    BOOL appendedBeforeDrain = appended;
+    NSArray *chunks = [buffer drain];
+    
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:2.0];
+    while (!appended && [timeout timeIntervalSinceNow] > 0) {
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    
+    // verify
+    XCTAssertFalse(appendedBeforeDrain, @"Appending to a full buffer should wait for a drain.");
+    XCTAssertEqualObjects(chunks, @[[self dataWithString:@"ack\n"]], @"The drain should return the output held before the buffer was full.");
+    XCTAssertTrue(appended, @"Appending should continue once the buffer has been drained.");
+    XCTAssertEqualObjects([buffer drain], @[[self dataWithString:@"git\n"]], @"No output should be lost under the block policy.");
+}
+
+- (void)testClosedBufferHoldsOutputBeyondLimit
+{
+    // setup
+    MRBrewOutputBuffer *buffer = [[MRBrewOutputBuffer alloc] initWithLimit:4 policy:MRBrewOutputBufferPolicyBlock];
+    [buffer appendData:[self dataWithString:@"ack\n"]];
+    
+    // execute
+    [buffer close];
+    [buffer appendData:[self dataWithString:@"git\n"]];
+    
+    // verify
+    XCTAssertEqualObjects([buffer drain], (@[[self dataWithString:@"ack\n"], [self dataWithString:@"git\n"]]), @"A closed buffer should not block or discard the last of the output.");
+}
+
+@end
@@ -36,6 +36,7 @@
     NSString *_fakeOutputFromListOperation;
     NSString *_fakeOutputFromSearchOperation;
     NSString *_fakeOutputFromOptionsOperation;
+    NSString *_fakeOutputFromJSONInfoOperation;
     NSUInteger _fakeCountForListOperation;
     NSUInteger _fakeCountForSearchOperation;
     NSUInteger _fakeCountForOptionsOperation;
@@ -54,6 +55,10 @@
     _fakeOutputFromListOperation = @"test-formula\ntest-formula-two\n";
     _fakeOutputFromSearchOperation = @"test-formula\ntest-formula-two\n";
     _fakeOutputFromOptionsOperation = @"--test-option\n\tTest option description\n--test-option-two\n\tTest option description two\n\n";
+    _fakeOutputFromJSONInfoOperation = @"[{\"name\":\"test-formula\",\"homepage\":\"http://example.com\",\"versions\":{\"stable\":\"1.1\",\"bottle\":true,\"devel\":null,\"head\":\"HEAD\"},\"revision\":0,"
+                                       @"\"installed\":[{\"version\":\"1.0\",\"used_options\":[\"--test-option\"],\"built_as_bottle\":false}],\"linked_keg\":\"1.0\",\"pinned\":true,\"outdated\":true,"
+                                       @"\"dependencies\":[\"test-dependency\"],\"caveats\":\"Line one\\nLine two\",\"options\":[{\"option\":\"--test-option\",\"description\":\"Test option description\"}]},"
+                                       @"{\"name\":\"test-formula-two\",\"versions\":{\"stable\":\"2.0\"},\"installed\":[],\"linked_keg\":null,\"pinned\":false,\"outdated\":false,\"dependencies\":[],\"options\":[]}]\n";
     
     _fakeCountForListOperation = 2;
     _fakeCountForSearchOperation = 2;
@@ -231,6 +236,70 @@
     XCTAssertNil(error, @"An error object should not be returned when a valid output string is provided.");
 }
 
+#pragma mark - Valid JSON Info Output Parsing
+
+- (void)testParsedObjectArrayForJSONInfoOperationContainsFormulaeWithDetails
+{
+    // setup
+    MRBrewOperation *operation = [MRBrewOperation infoOperationForFormulae:@[[MRBrewFormula formulaWithName:@"test-formula"], [MRBrewFormula formulaWithName:@"test-formula-two"]]];
+    NSError *error = nil;
+    
+    // execute
+    NSArray *objects = [[MRBrewOutputParser outputParser] objectsForOperation:operation output:_fakeOutputFromJSONInfoOperation error:&error];
+    
+    // verify
+    XCTAssertNil(error, @"An error object should not be returned when a valid output string is provided.");
+    XCTAssertTrue([objects count] == 2, @"The number of objects parsed should equal the number of formulae in the output string.");
+    
+    MRBrewFormula *formula = [objects objectAtIndex:0];
+    XCTAssertEqualObjects([formula name], @"test-formula", @"Formula name should be parsed.");
+    XCTAssertEqualObjects([formula stableVersion], @"1.1", @"Formula stable version should be parsed.");
+    XCTAssertNil([formula develVersion], @"Formula devel version should be nil when null.");
+    XCTAssertEqualObjects([formula headVersion], @"HEAD", @"Formula head version should be parsed.");
+    XCTAssertEqualObjects([formula installedVersions], @[@"1.0"], @"Formula installed versions should be parsed.");
+    XCTAssertEqualObjects([formula linkedVersion], @"1.0", @"Formula linked version should be parsed.");
+    XCTAssertEqualObjects([formula dependencies], @[@"test-dependency"], @"Formula dependencies should be parsed.");
+    XCTAssertTrue([formula isInstalled] && [formula isPinned] && [formula isOutdated], @"Formula installed, pinned and outdated states should be parsed.");
+    XCTAssertEqualObjects([[[formula options] objectAtIndex:0] name], @"--test-option", @"Formula options should be parsed.");
+    
+    MRBrewFormula *formulaTwo = [objects objectAtIndex:1];
+    XCTAssertFalse([formulaTwo isInstalled] || [formulaTwo isPinned] || [formulaTwo isOutdated], @"Formula without installed kegs should not be installed, pinned or outdated.");
+    XCTAssertNil([formulaTwo linkedVersion], @"Formula linked version should be nil when null.");
+}
+
+#pragma mark - Valid Outdated Output Parsing
+
+- (void)testParsedObjectArrayForVerboseOutdatedOperationContainsFormulaeWithVersions
+{
+    // setup
+    MRBrewOperation *operation = [MRBrewOperation verboseOutdatedOperation];
+    NSError *error = nil;
+    
+    // execute
+    NSArray *objects = [[MRBrewOutputParser outputParser] objectsForOperation:operation output:@"test-formula (1.0) < 1.1\n" error:&error];
+    MRBrewFormula *formula = [objects firstObject];
+    
+    // verify
+    XCTAssertNil(error, @"An error object should not be returned when a valid output string is provided.");
+    XCTAssertEqualObjects([formula installedVersions], @[@"1.0"], @"Formula installed versions should be parsed.");
+    XCTAssertEqualObjects([formula availableVersion], @"1.1", @"Formula available version should be parsed.");
+    XCTAssertTrue([formula isOutdated], @"Formula should be outdated.");
+}
+
+- (void)testErrorIsInstantiatedForInvalidJSONInfoOperationOutput
+{
+    // setup
+    MRBrewOperation *operation = [MRBrewOperation infoOperationForFormulae:@[[MRBrewFormula formulaWithName:@"test-formula"]]];
+    NSError *error = nil;
+    
+    // execute
+    NSArray *objects = [[MRBrewOutputParser outputParser] objectsForOperation:operation output:@"[{\"name\":\"test-formula\"" error:&error];
+    
+    // verify
+    XCTAssertNil(objects, @"Nil should be returned for an invalid output string.");
+    XCTAssertTrue([error code] == MRBrewOutputParserErrorSyntax, @"The error code should match the constant MRBrewOutputParserErrorSyntax.");
+}
+
 #pragma mark - Empty List Output Parsing
 
 - (void)testErrorIsInstantiatedForEmptyListOperationOutput
@@ -423,4 +492,73 @@
     XCTAssertNil(objects, @"Nil should be returned for an invalid output string.");
 }
 
+#pragma mark - Parallel Parsing
+
+- (void)testParallelParsingOfListOperationOutputMatchesSerialParsing
+{
+    // setup
+    id operation = [OCMockObject mockForClass:[MRBrewOperation class]];
+    [[[operation stub] andReturn:MRBrewOperationListIdentifier] name];
+    
+    NSMutableString *output = [NSMutableString string];
+    for (NSUInteger i = 0; i < 1000; i++) {
+        [output appendFormat:@"test-formula-%lu\n%@", (unsigned long)i, (i % 7 == 0 ? @"\n" : @"")];
+    }
+    
+    MRBrewOutputParser *serialParser = [MRBrewOutputParser outputParser];
+    [serialParser setParallelParsingThreshold:NSUIntegerMax];
+    MRBrewOutputParser *parallelParser = [MRBrewOutputParser outputParser];
+    [parallelParser setParallelParsingThreshold:0];
+    
+    // execute
+    NSArray *serialObjects = [serialParser objectsForOperation:operation output:output error:nil];
+    NSArray *parallelObjects = [parallelParser objectsForOperation:operation output:output error:nil];
+    
+    // verify
+    XCTAssertTrue([parallelObjects count] == 1000, @"Each line should be parsed once when output is parsed in parallel.");
+    XCTAssertEqualObjects(parallelObjects, serialObjects, @"Output parsed in parallel should yield the same formulae, in the same order, as serial parsing.");
+    XCTAssertTrue([[parallelObjects lastObject] isInstalled], @"Formulae parsed in parallel should have their isInstalled property set.");
+}
+
+- (void)testParallelParsingOfOptionsOperationOutputMatchesSerialParsing
+{
+    // setup
+    id operation = [OCMockObject mockForClass:[MRBrewOperation class]];
+    [[[operation stub] andReturn:MRBrewOperationOptionsIdentifier] name];
+    
+    NSMutableString *output = [NSMutableString string];
+    for (NSUInteger i = 0; i < 500; i++) {
+        [output appendFormat:@"--test-option-%lu\n\tTest option description %lu\n", (unsigned long)i, (unsigned long)i];
+    }
+    
+    MRBrewOutputParser *serialParser = [MRBrewOutputParser outputParser];
+    [serialParser setParallelParsingThreshold:NSUIntegerMax];
+    MRBrewOutputParser *parallelParser = [MRBrewOutputParser outputParser];
+    [parallelParser setParallelParsingThreshold:0];
+    
+    // execute
+    NSArray *serialObjects = [serialParser objectsForOperation:operation output:output error:nil];
+    NSArray *parallelObjects = [parallelParser objectsForOperation:operation output:output error:nil];
+    
+    // verify
+    XCTAssertTrue([parallelObjects count] == 500, @"Each option should be parsed once when output is parsed in parallel.");
+    XCTAssertEqualObjects([parallelObjects valueForKey:@"name"], [serialObjects valueForKey:@"name"], @"Options parsed in parallel should have the same names, in the same order, as serial parsing.");
+    XCTAssertEqualObjects([parallelObjects valueForKey:@"optionDescription"], [serialObjects valueForKey:@"optionDescription"], @"Options parsed in parallel should have the same descriptions as serial parsing.");
+}
+
+- (void)testNilIsReturnedForInvalidOptionsOperationOutputParsedInParallel
+{
+    // setup
+    id operation = [OCMockObject mockForClass:[MRBrewOperation class]];
+    [[[operation stub] andReturn:MRBrewOperationOptionsIdentifier] name];
+    MRBrewOutputParser *parser = [MRBrewOutputParser outputParser];
+    [parser setParallelParsingThreshold:0];
+    
+    // execute
+    NSArray *objects = [parser objectsForOperation:operation output:@"--test-option\n\tTest option description\n--" error:nil];
+    
+    // verify
+    XCTAssertNil(objects, @"Nil should be returned for an invalid output string parsed in parallel.");
+}
+
 @end
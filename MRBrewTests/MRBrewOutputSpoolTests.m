@@ -0,0 +1,102 @@
+//
+//  MRBrewOutputSpoolTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "MRBrewOutputSpool.h"
+
+@interface MRBrewOutputSpoolTests : XCTestCase
+
+@end
+
+@implementation MRBrewOutputSpoolTests
+
+- (void)setUp
+{
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+}
+
+- (void)tearDown
+{
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+- (void)appendString:(NSString *)string toSpool:(MRBrewOutputSpool *)spool
+{
+    [spool appendData:[string dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+- (void)testOutputBelowThresholdIsHeldInMemory
+{
+    // setup
+    MRBrewOutputSpool *spool = [[MRBrewOutputSpool alloc] initWithMemoryThreshold:64];
+    
+    // execute
+    [self appendString:@"==> Downloading\n==> Pouring\n" toSpool:spool];
+    [spool finishWriting];
+    
+    // verify
+    XCTAssertFalse([spool isSpooledToDisk], @"Output below the memory threshold should not be written to disk.");
+    XCTAssertTrue([spool lineCount] == 2, @"Each line of output should be indexed.");
+    XCTAssertEqualObjects([spool lineAtIndex:1], @"==> Pouring", @"Lines should be returned without their trailing newline.");
+}
+
+- (void)testOutputAboveThresholdIsSpooledToDiskAndMapped
+{
+    // setup
+    MRBrewOutputSpool *spool = [[MRBrewOutputSpool alloc] initWithMemoryThreshold:16];
+    
+    // execute
+    [self appendString:@"==> Downloading\n" toSpool:spool];
+    [self appendString:@"make install\n" toSpool:spool];
+    [self appendString:@"==> Caveats" toSpool:spool];
+    [spool finishWriting];
+    
+    // verify
+    XCTAssertTrue([spool isSpooledToDisk], @"Output above the memory threshold should be written to disk.");
+    XCTAssertNil([spool error], @"Output should be written to disk without error.");
+    XCTAssertEqualObjects([[NSString alloc] initWithData:[spool data] encoding:NSUTF8StringEncoding], @"==> Downloading\nmake install\n==> Caveats", @"All output should be readable after spooling to disk.");
+    XCTAssertTrue([spool lineCount] == 3, @"A final line without a newline should be counted.");
+    XCTAssertEqualObjects([spool lineAtIndex:2], @"==> Caveats", @"Lines should be readable by index.");
+}
+
+- (void)testLinesContainingStringAreFound
+{
+    // setup
+    MRBrewOutputSpool *spool = [[MRBrewOutputSpool alloc] initWithMemoryThreshold:0];
+    [self appendString:@"==> Downloading\nmake\n==> Pouring\n" toSpool:spool];
+    [spool finishWriting];
+    
+    // execute
+    NSIndexSet *indexes = [spool indexesOfLinesContainingString:@"==>"];
+    
+    // verify
+    NSMutableIndexSet *expectedIndexes = [NSMutableIndexSet indexSetWithIndex:0];
+    [expectedIndexes addIndex:2];
+    XCTAssertEqualObjects(indexes, expectedIndexes, @"The indexes of each line containing the string should be returned.");
+}
+
+@end
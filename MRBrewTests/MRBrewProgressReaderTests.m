@@ -0,0 +1,138 @@
+//
+//  MRBrewProgressReaderTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "MRBrewProgressReader.h"
+#import "MRBrewProgress.h"
+
+@interface MRBrewProgressReaderTests : XCTestCase
+
+@end
+
+@implementation MRBrewProgressReaderTests
+
+- (void)setUp
+{
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+}
+
+- (void)tearDown
+{
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+- (NSArray *)progressFromString:(NSString *)string reader:(MRBrewProgressReader *)reader
+{
+    return [reader progressFromData:[string dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+- (void)testPhaseMarkersAreRecognised
+{
+    // setup
+    MRBrewProgressReader *reader = [[MRBrewProgressReader alloc] initWithFormulaName:@"wget"];
+    NSString *output = @"==> Downloading https://example.com/wget-1.15.mavericks.bottle.tar.gz\n"
+                       @"==> Pouring wget-1.15.mavericks.bottle.tar.gz\n"
+                       @"==> Caveats\n"
+                       @"Some caveats\n"
+                       @"==> Summary\n";
+    
+    // execute
+    NSArray *progress = [self progressFromString:output reader:reader];
+    
+    // verify
+    NSArray *expectedProgress = @[[MRBrewProgress progressWithPhase:MRBrewProgressPhaseDownloading formulaName:@"wget" percentComplete:-1],
+                                  [MRBrewProgress progressWithPhase:MRBrewProgressPhasePouring formulaName:@"wget" percentComplete:-1],
+                                  [MRBrewProgress progressWithPhase:MRBrewProgressPhaseCaveats formulaName:@"wget" percentComplete:-1],
+                                  [MRBrewProgress progressWithPhase:MRBrewProgressPhaseSummary formulaName:@"wget" percentComplete:-1]];
+    XCTAssertEqualObjects(progress, expectedProgress, @"Each phase marker should be described by progress for the formula being installed.");
+}
+
+- (void)testDependencyInstallAndBuildStepsNameTheDependency
+{
+    // setup
+    MRBrewProgressReader *reader = [[MRBrewProgressReader alloc] initWithFormulaName:@"wget"];
+    NSString *output = @"==> Installing dependencies for wget: openssl\n"
+                       @"==> Installing wget dependency: openssl\n"
+                       @"==> ./Configure --prefix=/usr/local/Cellar/openssl/1.0.1f\n";
+    
+    // execute
+    NSArray *progress = [self progressFromString:output reader:reader];
+    
+    // verify
+    NSArray *expectedProgress = @[[MRBrewProgress progressWithPhase:MRBrewProgressPhaseInstalling formulaName:@"openssl" percentComplete:-1],
+                                  [MRBrewProgress progressWithPhase:MRBrewProgressPhaseBuilding formulaName:@"openssl" percentComplete:-1]];
+    XCTAssertEqualObjects(progress, expectedProgress, @"Progress should name the dependency being installed and built.");
+}
+
+- (void)testDownloadPercentagesAreReadAcrossChunks
+{
+    // setup
+    MRBrewProgressReader *reader = [[MRBrewProgressReader alloc] initWithFormulaName:@"wget"];
+    
+    // execute
+    NSArray *firstProgress = [self progressFromString:@"\r                          0.6%\r#####       12." reader:reader];
+    NSArray *secondProgress = [self progressFromString:@"5%\r\033[0m#################### 100.0%\n" reader:reader];
+    
+    // verify
+    XCTAssertTrue([firstProgress count] == 1, @"Only completed lines should be read.");
+    XCTAssertEqual([[firstProgress firstObject] percentComplete], 0.6, @"A percentage before the first '#' is drawn should be read.");
+    XCTAssertTrue([secondProgress count] == 2, @"A line split between chunks should be read once it is complete.");
+    XCTAssertEqual([[secondProgress objectAtIndex:0] percentComplete], 12.5, @"The percentage of a line split between chunks should be read.");
+    XCTAssertEqual([[secondProgress objectAtIndex:1] percentComplete], 100.0, @"Escape sequences should be ignored.");
+    XCTAssertEqual([[secondProgress objectAtIndex:1] phase], MRBrewProgressPhaseDownloading, @"Percentages should be reported as download progress.");
+}
+
+- (void)testOtherOutputIsIgnored
+{
+    // setup
+    MRBrewProgressReader *reader = [[MRBrewProgressReader alloc] initWithFormulaName:@"wget"];
+    
+    // execute
+    NSArray *progress = [self progressFromString:@"[ 45%] Building C object\nchecking for gcc... 100%\n" reader:reader];
+    
+    // verify
+    XCTAssertTrue([progress count] == 0, @"Output that is not a phase marker or progress bar should be ignored.");
+}
+
+- (void)testErrorOutputPercentagesNameTheFormulaFromOutput
+{
+    // setup
+    MRBrewProgressReader *reader = [[MRBrewProgressReader alloc] initWithFormulaName:@"wget"];
+    
+    // execute
+    NSArray *firstErrorProgress = [reader progressFromData:[@"######   12." dataUsingEncoding:NSUTF8StringEncoding] errorOutput:YES];
+    [reader progressFromData:[@"==> Installing wget dependency: openssl\n==> Down" dataUsingEncoding:NSUTF8StringEncoding] errorOutput:NO];
+    NSArray *secondErrorProgress = [reader progressFromData:[@"5%\r==> Installing curl\n" dataUsingEncoding:NSUTF8StringEncoding] errorOutput:YES];
+    NSArray *outputProgress = [reader progressFromData:[@"loading https://example.com/openssl.tar.gz\n" dataUsingEncoding:NSUTF8StringEncoding] errorOutput:NO];
+    
+    // verify
+    XCTAssertTrue([firstErrorProgress count] == 0, @"Only completed lines should be read.");
+    XCTAssertEqualObjects(secondErrorProgress, @[[MRBrewProgress progressWithPhase:MRBrewProgressPhaseDownloading formulaName:@"openssl" percentComplete:12.5]], @"A percentage on error output should name the formula most recently named on output, and markers on error output should be ignored.");
+    XCTAssertEqualObjects(outputProgress, @[[MRBrewProgress progressWithPhase:MRBrewProgressPhaseDownloading formulaName:@"openssl" percentComplete:-1]], @"Each stream should keep its own incomplete line.");
+}
+
+@end
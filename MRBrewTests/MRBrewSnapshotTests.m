@@ -0,0 +1,128 @@
+//
+//  MRBrewSnapshotTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "XCTestCase+MRBrewFixtures.h"
+#import "MRBrewSnapshot.h"
+#import "MRBrewChange.h"
+
+@interface MRBrewSnapshotTests : XCTestCase {
+    NSString *_rootPath;
+    NSString *_cellarPath;
+    NSString *_linkedKegsPath;
+    NSString *_pinnedKegsPath;
+    MRBrewSnapshot *_snapshot;
+}
+
+@end
+
+@implementation MRBrewSnapshotTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    _rootPath = [self createTemporaryDirectory];
+    _cellarPath = [self createDirectoryAtPath:@"Cellar" inDirectory:_rootPath];
+    _linkedKegsPath = [self createDirectoryAtPath:@"LinkedKegs" inDirectory:_rootPath];
+    _pinnedKegsPath = [self createDirectoryAtPath:@"PinnedKegs" inDirectory:_rootPath];
+    [self createDirectoryAtPath:@"wget/1.14" inDirectory:_cellarPath];
+    
+    _snapshot = [MRBrewSnapshot snapshotWithCellarPath:_cellarPath linkedKegsPath:_linkedKegsPath pinnedKegsPath:_pinnedKegsPath];
+    [_snapshot reload];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:_rootPath error:NULL];
+    [super tearDown];
+}
+
+- (void)testReloadReadsInstalledFormulae
+{
+    // verify
+    XCTAssertEqualObjects([_snapshot installedFormulaNames], [NSSet setWithObject:@"wget"], @"Snapshot should contain the formulae in the Cellar.");
+    XCTAssertEqualObjects([_snapshot versionsForFormula:@"wget"], [NSSet setWithObject:@"1.14"], @"Snapshot should contain the installed versions of each formula.");
+}
+
+- (void)testChangesForPathsReportsInstalledFormulaAndAddedVersion
+{
+    // setup
+    [self createDirectoryAtPath:@"git/1.8.5" inDirectory:_cellarPath];
+    [self createDirectoryAtPath:@"wget/1.15" inDirectory:_cellarPath];
+    
+    // execute
+    NSArray *changes = [_snapshot changesForPaths:@[_cellarPath, [_cellarPath stringByAppendingPathComponent:@"wget/"]]];
+    
+    // verify
+    NSArray *expectedChanges = @[[MRBrewChange changeWithType:MRBrewChangeFormulaInstalled formulaName:@"git" version:@"1.8.5"],
+                                 [MRBrewChange changeWithType:MRBrewChangeVersionAdded formulaName:@"wget" version:@"1.15"]];
+    XCTAssertEqualObjects(changes, expectedChanges, @"Snapshot should report the installed formula and added version.");
+}
+
+- (void)testChangesForPathsReportsRemovedFormula
+{
+    // setup
+    [[NSFileManager defaultManager] removeItemAtPath:[_cellarPath stringByAppendingPathComponent:@"wget"] error:NULL];
+    
+    // execute
+    NSArray *changes = [_snapshot changesForPaths:@[_cellarPath]];
+    
+    // verify
+    XCTAssertEqualObjects(changes, @[[MRBrewChange changeWithType:MRBrewChangeFormulaRemoved formulaName:@"wget" version:nil]], @"Snapshot should report the removed formula.");
+    XCTAssertEqual([[_snapshot installedFormulaNames] count], (NSUInteger)0, @"Snapshot should no longer contain the removed formula.");
+}
+
+- (void)testChangesForPathsReportsLinkedAndPinnedFormula
+{
+    // setup
+    NSString *kegPath = [_cellarPath stringByAppendingPathComponent:@"wget/1.14"];
+    [[NSFileManager defaultManager] createSymbolicLinkAtPath:[_linkedKegsPath stringByAppendingPathComponent:@"wget"] withDestinationPath:kegPath error:NULL];
+    [[NSFileManager defaultManager] createSymbolicLinkAtPath:[_pinnedKegsPath stringByAppendingPathComponent:@"wget"] withDestinationPath:kegPath error:NULL];
+    
+    // execute
+    NSArray *changes = [_snapshot changesForPaths:@[_linkedKegsPath, _pinnedKegsPath]];
+    
+    // verify
+    NSArray *expectedChanges = @[[MRBrewChange changeWithType:MRBrewChangeFormulaLinked formulaName:@"wget" version:@"1.14"],
+                                 [MRBrewChange changeWithType:MRBrewChangeFormulaPinned formulaName:@"wget" version:@"1.14"]];
+    XCTAssertEqualObjects(changes, expectedChanges, @"Snapshot should report the linked and pinned formula.");
+    XCTAssertEqualObjects([_snapshot linkedVersionForFormula:@"wget"], @"1.14", @"Snapshot should record the linked version.");
+    XCTAssertTrue([_snapshot isFormulaPinned:@"wget"], @"Snapshot should record the pinned formula.");
+}
+
+- (void)testChangesForUnrelatedPathsDoesNotRescan
+{
+    // setup
+    [self createDirectoryAtPath:@"git/1.8.5" inDirectory:_cellarPath];
+    
+    // execute
+    NSArray *changes = [_snapshot changesForPaths:@[_linkedKegsPath]];
+    
+    // verify
+    XCTAssertEqual([changes count], (NSUInteger)0, @"Snapshot should not rescan the Cellar for events outside it.");
+}
+
+@end
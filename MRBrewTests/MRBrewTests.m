@@ -31,6 +31,10 @@
 #import "MRBrewFormula.h"
 #import "MRBrewOperation.h"
 #import "MRBrewConstants.h"
+#import "MRBrewLocations.h"
+#import "MRBrewFuture.h"
+#import "MRBrewWorker+Private.h"
+#import "MRBrewWorkerTaskConstants.h"
 
 @interface MRBrewTests : XCTestCase
 
@@ -38,8 +42,6 @@
 
 @implementation MRBrewTests
 
-static NSString * const MRBrewTestsDefaultBrewPath = @"/usr/local/bin/brew";
-
 #pragma mark - Setup
 
 - (void)setUp
@@ -93,7 +95,7 @@ static NSString * const MRBrewTestsDefaultBrewPath = @"/usr/local/bin/brew";
     NSString *brewPath = [[MRBrew sharedBrew] brewPath];
     
     // verify
-    XCTAssertTrue([brewPath isEqualToString:MRBrewTestsDefaultBrewPath], @"Should equal default brew path.");
+    XCTAssertTrue([brewPath isEqualToString:[[MRBrewLocations defaultLocations] brewPath]], @"Should equal the discovered brew path.");
 }
 
 - (void)testBrewPathWhenSetToNil
@@ -102,10 +104,10 @@ static NSString * const MRBrewTestsDefaultBrewPath = @"/usr/local/bin/brew";
     [[MRBrew sharedBrew] setBrewPath:nil];
     
     // verify
-    XCTAssertTrue([[[MRBrew sharedBrew] brewPath] isEqualToString:MRBrewTestsDefaultBrewPath], @"Should equal default brew path.");
+    XCTAssertTrue([[[MRBrew sharedBrew] brewPath] isEqualToString:[[MRBrewLocations defaultLocations] brewPath]], @"Should equal the discovered brew path.");
     
     // cleanup
-    [[MRBrew sharedBrew] setBrewPath:MRBrewTestsDefaultBrewPath];
+    [[MRBrew sharedBrew] setBrewPath:[[MRBrewLocations defaultLocations] brewPath]];
 }
 
 - (void)testSetBrewPath
@@ -120,7 +122,7 @@ static NSString * const MRBrewTestsDefaultBrewPath = @"/usr/local/bin/brew";
     XCTAssertTrue([[[MRBrew sharedBrew] brewPath] isEqualToString:testPath], @"Should equal new brew path %@.", testPath);
     
     // cleanup
-    [[MRBrew sharedBrew] setBrewPath:MRBrewTestsDefaultBrewPath];
+    [[MRBrew sharedBrew] setBrewPath:[[MRBrewLocations defaultLocations] brewPath]];
 }
 
 - (void)testCancelAllOperationsWillCancelAllWorkersInBackgroundQueue
@@ -235,6 +237,20 @@ static NSString * const MRBrewTestsDefaultBrewPath = @"/usr/local/bin/brew";
     [queue verify];
 }
 
+- (void)testSetMaxConcurrentOperationCountWillSetBackgroundQueueToMaxConcurrentOperationCount
+{
+    // setup
+    id queue = [OCMockObject mockForClass:[NSOperationQueue class]];
+    [[queue expect] setMaxConcurrentOperationCount:4];
+    [[MRBrew sharedBrew] setBackgroundQueue:queue];
+    
+    // execute
+    [[MRBrew sharedBrew] setMaxConcurrentOperationCount:4];
+    
+    // verify
+    [queue verify];
+}
+
 - (void)testPerformOperationDelegateAddsWorkerToQueue
 {
     // setup
@@ -259,6 +275,131 @@ static NSString * const MRBrewTestsDefaultBrewPath = @"/usr/local/bin/brew";
     [queue verify];
 }
 
+- (void)testPerformOperationWithHandlersAddsWorkerToQueue
+{
+    // setup
+    id operation = [OCMockObject mockForClass:[MRBrewOperation class]];
+    [[[operation stub] andReturn:MRBrewOperationUpdateIdentifier] name];
+    [[[operation stub] andReturn:nil] parameters];
+    [[[operation stub] andReturn:nil] formula];
+    [[[operation stub] andReturn:operation] copyWithZone:[OCMArg anyPointer]];
+    
+    NSOperationQueue *callbackQueue = [[NSOperationQueue alloc] init];
+    MRBrewCompletionHandler completionHandler = ^(MRBrewOperation *completedOperation) {};
+    
+    id queue = [OCMockObject mockForClass:[NSOperationQueue class]];
+    [[queue expect] addOperation:[OCMArg checkWithBlock:^BOOL(MRBrewWorker *worker) {
+        return [worker callbackQueue] == callbackQueue && [worker completionHandler] != nil && [worker delegate] == nil;
+    }]];
+    [[MRBrew sharedBrew] setBackgroundQueue:queue];
+    
+    // execute
+    [[MRBrew sharedBrew] performOperation:operation queue:callbackQueue output:nil completion:completionHandler failure:nil];
+    
+    // verify
+    [queue verify];
+}
+
+- (void)testWorkersAreConfiguredByTheInstanceThatCreatesThem
+{
+    // setup
+    MRBrew *brew = [[MRBrew alloc] initWithBrewPath:@"/opt/homebrew/bin/brew"];
+    [brew setEnvironment:@{@"HOMEBREW_PREFIX": @"/opt/homebrew"}];
+    MRBrew *otherBrew = [[MRBrew alloc] initWithBrewPath:@"/usr/local/bin/brew"];
+    
+    // execute
+    MRBrewWorker *worker = [brew workerForOperation:[MRBrewOperation listOperation]];
+    MRBrewWorker *otherWorker = [otherBrew workerForOperation:[MRBrewOperation listOperation]];
+    
+    // verify
+    XCTAssertEqualObjects([worker brewPath], @"/opt/homebrew/bin/brew", @"Worker should use the executable path of the instance that created it.");
+    XCTAssertEqualObjects([worker environment], [brew environment], @"Worker should use the environment of the instance that created it.");
+    XCTAssertEqualObjects([otherWorker brewPath], @"/usr/local/bin/brew", @"Worker should not use the executable path of another instance.");
+    XCTAssertNil([otherWorker environment], @"Worker should not use the environment of another instance.");
+}
+
+- (void)testOperationEnvironmentIsMergedWithBrewEnvironment
+{
+    // setup
+    MRBrew *brew = [[MRBrew alloc] init];
+    [brew setEnvironment:@{@"HOMEBREW_CACHE": @"/tmp/cache", @"HOMEBREW_VERBOSE": @"1"}];
+    MRBrewOperation *operation = [MRBrewOperation updateOperation];
+    [operation setEnvironment:@{@"HOMEBREW_NO_AUTO_UPDATE": @"1", @"HOMEBREW_VERBOSE": [NSNull null]}];
+    [operation setWorkingDirectory:@"/tmp"];
+    
+    // execute
+    MRBrewWorker *worker = [brew workerForOperation:operation];
+    
+    // verify
+    XCTAssertEqualObjects([worker environment], (@{@"HOMEBREW_CACHE": @"/tmp/cache", @"HOMEBREW_NO_AUTO_UPDATE": @"1"}), @"Operation variables should be added to the brew environment, and null variables removed.");
+    XCTAssertEqualObjects([brew environment], (@{@"HOMEBREW_CACHE": @"/tmp/cache", @"HOMEBREW_VERBOSE": @"1"}), @"Brew environment should not be modified by an operation's variables.");
+    XCTAssertEqualObjects([worker currentDirectoryPath], @"/tmp", @"Worker should use the operation's working directory.");
+}
+
+- (void)testOnlyOperationsThatModifyHomebrewAreRetried
+{
+    // setup
+    MRBrew *brew = [[MRBrew alloc] initWithBrewPath:@"/test/brew"];
+    
+    // execute
+    MRBrewWorker *listWorker = [brew workerForOperation:[MRBrewOperation listOperation]];
+    MRBrewWorker *installWorker = [brew workerForOperation:[MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]]];
+    
+    // verify
+    XCTAssertNil([listWorker retryHandler], @"Read-only operations should not be retried, so their output should not be held back.");
+    XCTAssertNotNil([installWorker retryHandler], @"Operations that modify Homebrew should be retried after lock contention.");
+}
+
+- (void)testFutureIsRejectedWhenBrewCannotBeLaunched
+{
+    // setup
+    MRBrew *brew = [[MRBrew alloc] initWithBrewPath:@"/nonexistent/bin/brew"];
+    
+    // execute
+    MRBrewFuture *future = [brew futureForOperation:[MRBrewOperation listOperation]];
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:5.0];
+    while (![future isResolved] && [timeout timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    
+    // verify
+    XCTAssertTrue([future isResolved], @"Future should be resolved when the brew task cannot be launched.");
+    XCTAssertTrue([[future error] code] == MRBrewErrorUnknown, @"Future should be rejected with the unknown error code.");
+}
+
+- (void)testFutureOutputSurvivesCharacterSplitAcrossChunks
+{
+    // setup
+    MRBrew *brew = [[MRBrew alloc] initWithBrewPath:@"/test/brew"];
+    [brew setLockRetryLimit:0];
+    
+    __block MRBrewWorker *worker = nil;
+    id queue = [OCMockObject niceMockForClass:[NSOperationQueue class]];
+    [[queue stub] addOperation:[OCMArg checkWithBlock:^BOOL(MRBrewWorker *queuedWorker) {
+        worker = queuedWorker;
+        return YES;
+    }]];
+    [brew setBackgroundQueue:queue];
+    
+    id task = [OCMockObject mockForClass:[NSTask class]];
+    [[[task stub] andReturnValue:OCMOCK_VALUE(MRBrewWorkerTaskExitedNormally)] terminationStatus];
+    
+    // the beer mug is four bytes of UTF-8, and the first chunk ends halfway
+    // through it
+    NSString *expectedOutput = @"==> \U0001F37A wget\n";
+    NSData *output = [expectedOutput dataUsingEncoding:NSUTF8StringEncoding];
+    
+    // execute
+    MRBrewFuture *future = [brew futureForOperation:[MRBrewOperation listOperation]];
+    [worker setTask:task];
+    [worker notifyDelegateOutputGenerated:[output subdataWithRange:NSMakeRange(0, 6)]];
+    [worker notifyDelegateOutputGenerated:[output subdataWithRange:NSMakeRange(6, [output length] - 6)]];
+    [worker taskExited:nil];
+    
+    // verify
+    XCTAssertEqualObjects([future output], expectedOutput, @"Output split within a multibyte character should be decoded intact.");
+}
+
 - (void)testEnvironmentVariablesAreRetained
 {
     // setup
@@ -0,0 +1,78 @@
+//
+//  MRBrewVersionTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import "MRBrewVersion.h"
+
+@interface MRBrewVersionTests : XCTestCase
+
+@end
+
+@implementation MRBrewVersionTests
+
+- (void)testNumericComponentsAreComparedByValue
+{
+    // verify
+    XCTAssertEqual([MRBrewVersion compareVersion:@"1.9" toVersion:@"1.10"], NSOrderedAscending, @"Numeric components should be compared by value.");
+    XCTAssertEqual([MRBrewVersion compareVersion:@"1.0" toVersion:@"1.0.0"], NSOrderedSame, @"A missing component should be equivalent to zero.");
+    XCTAssertEqual([MRBrewVersion compareVersion:@"1.0.1" toVersion:@"1.0"], NSOrderedDescending, @"A further component should make a version newer.");
+}
+
+- (void)testPreReleaseAndPatchComponentsAreOrdered
+{
+    // setup
+    NSArray *versions = @[@"1.0alpha1", @"1.0b2", @"1.0pre1", @"1.0rc1", @"1.0", @"1.0p1", @"1.0.1"];
+    
+    // verify
+    for (NSUInteger i = 1; i < [versions count]; i++) {
+        XCTAssertEqual([MRBrewVersion compareVersion:[versions objectAtIndex:i - 1] toVersion:[versions objectAtIndex:i]], NSOrderedAscending, @"%@ should be older than %@.", [versions objectAtIndex:i - 1], [versions objectAtIndex:i]);
+    }
+    XCTAssertEqual([MRBrewVersion compareVersion:@"1.0.1f" toVersion:@"1.0.1e"], NSOrderedDescending, @"Letter suffixes should be compared alphabetically.");
+}
+
+- (void)testRevisionIsComparedAfterVersion
+{
+    // verify
+    XCTAssertEqual([MRBrewVersion compareVersion:@"2.0" toVersion:@"2.0_1"], NSOrderedAscending, @"A revision should make a version newer.");
+    XCTAssertEqual([MRBrewVersion compareVersion:@"2.0_2" toVersion:@"2.1"], NSOrderedAscending, @"A revision should only be compared when the versions are equal.");
+}
+
+- (void)testVersionIsDetectedFromURL
+{
+    // setup
+    NSDictionary *versions = @{@"http://ftpmirror.gnu.org/wget/wget-1.15.tar.xz": @"1.15",
+                               @"https://www.openssl.org/source/openssl-1.0.1f.tar.gz": @"1.0.1f",
+                               @"http://downloads.sourceforge.net/project/boost/boost/1.55.0/boost_1_55_0.tar.bz2": @"1.55.0",
+                               @"http://nodejs.org/dist/v0.10.24/node-v0.10.24.tar.gz": @"0.10.24",
+                               @"http://example.com/foo-2.0rc1.tgz?download=1": @"2.0rc1"};
+    
+    // verify
+    for (NSString *URLString in versions) {
+        XCTAssertEqualObjects([MRBrewVersion versionFromURLString:URLString], [versions objectForKey:URLString], @"Version should be detected from %@.", URLString);
+    }
+    XCTAssertNil([MRBrewVersion versionFromURLString:@"https://example.com/archive.tar.gz"], @"No version should be detected from a URL without one.");
+}
+
+@end
@@ -0,0 +1,376 @@
+//
+//  MRBrewWatcherTests.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+#import <OCMock/OCMock.h>
+#import "MRBrewWatcher.h"
+#import "MRBrewWatcherBackend.h"
+#import "MRBrewSnapshot.h"
+#import "MRBrewChange.h"
+#import "MRBrewOperation.h"
+#import "MRBrewFormula.h"
+#import "MRBrewConstants.h"
+#import "MRBrewLocations.h"
+
+@interface MRBrewWatcherTests : XCTestCase <MRBrewWatcherDelegate> {
+    NSArray *_delegateReceivedPaths;
+    NSArray *_delegateReceivedChanges;
+    MRBrewOperation *_delegateReceivedOperation;
+    NSArray *_delegateReceivedOperationPaths;
+    NSMutableDictionary *_delegateReceivedPathsByFormulaName;
+    NSOperationQueue *_delegateReceivedQueue;
+}
+
+@end
+
+@implementation MRBrewWatcherTests
+
+- (void)setUp
+{
+    [super setUp];
+    _delegateReceivedPaths = nil;
+    _delegateReceivedChanges = nil;
+    _delegateReceivedOperation = nil;
+    _delegateReceivedOperationPaths = nil;
+    _delegateReceivedPathsByFormulaName = [NSMutableDictionary dictionary];
+    _delegateReceivedQueue = nil;
+}
+
+- (void)tearDown
+{
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+- (void)testWatcherHasDefaultLatencyAndBackend
+{
+    // execute
+    MRBrewWatcher *watcher = [MRBrewWatcher watcherWithPath:@"/test/path" delegate:nil];
+
+    // verify
+    XCTAssertEqual([watcher latency], (NSTimeInterval)3.0, @"Watcher should have a default latency of 3.0 seconds.");
+    XCTAssertNotNil([watcher backend], @"Watcher should have a default backend for the current platform.");
+}
+
+- (void)testStartWatchingStartsBackendWithPathsAndLatency
+{
+    // setup
+    NSString *path = @"/test/path";
+    NSTimeInterval latency = 0.5;
+    MRBrewWatcher *watcher = [MRBrewWatcher watcherWithPath:path delegate:nil];
+    [watcher setLatency:latency];
+
+    id backend = [OCMockObject niceMockForProtocol:@protocol(MRBrewWatcherBackend)];
+    [[[backend expect] andReturnValue:@YES] startWatchingPaths:@[path] latency:latency handler:[OCMArg any]];
+    [watcher setBackend:backend];
+
+    // execute
+    BOOL started = [watcher startWatching];
+
+    // verify
+    [backend verify];
+    XCTAssertTrue(started, @"Watcher should report that its backend started.");
+}
+
+- (void)testStartWatchingReportsBackendFailure
+{
+    // setup
+    MRBrewWatcher *watcher = [MRBrewWatcher watcherWithPath:@"/test/path" delegate:nil];
+
+    id backend = [OCMockObject niceMockForProtocol:@protocol(MRBrewWatcherBackend)];
+    [[[backend stub] andReturnValue:@NO] startWatchingPaths:[OCMArg any] latency:3.0 handler:[OCMArg any]];
+    [watcher setBackend:backend];
+
+    // execute
+    BOOL started = [watcher startWatching];
+
+    // verify
+    XCTAssertFalse(started, @"Watcher should report that its backend failed to start.");
+}
+
+- (void)testDelegateReceivesPathsReportedByBackend
+{
+    // setup
+    NSArray *paths = @[@"/test/path/one", @"/test/path/two"];
+    MRBrewWatcher *watcher = [MRBrewWatcher watcherWithPath:@"/test/path" delegate:self];
+
+    __block MRBrewWatcherBackendHandler backendHandler = nil;
+    id backend = [OCMockObject niceMockForProtocol:@protocol(MRBrewWatcherBackend)];
+    [[[backend stub] andReturnValue:@YES] startWatchingPaths:[OCMArg any] latency:0 handler:[OCMArg checkWithBlock:^BOOL(id handler) {
+        backendHandler = handler;
+        return YES;
+    }]];
+    [watcher setBackend:backend];
+    [watcher setLatency:0];
+    [watcher setCallbackQueue:nil];
+
+    // execute
+    [watcher startWatching];
+    backendHandler(paths);
+
+    // verify
+    XCTAssertEqualObjects(_delegateReceivedPaths, paths, @"Delegate should receive the paths reported by the watcher's backend.");
+}
+
+- (void)testDelegateIsMessagedOnCallbackQueue
+{
+    // setup
+    NSArray *paths = @[@"/test/path/one"];
+    NSString *cellarPath = [[MRBrewLocations defaultLocations] cellarPath];
+    NSArray *operationPaths = @[[cellarPath stringByAppendingPathComponent:@"wget/1.15"]];
+    MRBrewOperation *operation = [MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]];
+    MRBrewWatcher *watcher = [MRBrewWatcher watcherWithPath:@"/test/path" delegate:self];
+    NSOperationQueue *queue = [[NSOperationQueue alloc] init];
+    [queue setMaxConcurrentOperationCount:1];
+    
+    __block MRBrewWatcherBackendHandler backendHandler = nil;
+    id backend = [OCMockObject niceMockForProtocol:@protocol(MRBrewWatcherBackend)];
+    [[[backend stub] andReturnValue:@YES] startWatchingPaths:[OCMArg any] latency:0 handler:[OCMArg checkWithBlock:^BOOL(id handler) {
+        backendHandler = handler;
+        return YES;
+    }]];
+    [watcher setBackend:backend];
+    [watcher setLatency:0];
+    [watcher setCallbackQueue:queue];
+    [watcher setSuppressesOperationEvents:YES];
+    [watcher startWatching];
+    
+    // execute
+    backendHandler(paths);
+    [queue waitUntilAllOperationsAreFinished];
+    NSOperationQueue *changeQueue = _delegateReceivedQueue;
+    
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationWillLaunchNotification object:operation];
+    backendHandler(operationPaths);
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationDidExitNotification object:operation];
+    
+    // wait for the attribution period to end
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:2.0];
+    while ([timeout timeIntervalSinceNow] > 0) {
+        @synchronized(self) {
+            if (_delegateReceivedOperation) {
+                break;
+            }
+        }
+        [NSThread sleepForTimeInterval:0.1];
+    }
+    [queue waitUntilAllOperationsAreFinished];
+    
+    // verify
+    XCTAssertEqualObjects(_delegateReceivedPaths, paths, @"Delegate should receive the paths reported by the watcher's backend.");
+    XCTAssertEqual(changeQueue, queue, @"Delegate should receive events on the callback queue.");
+    @synchronized(self) {
+        XCTAssertEqual(_delegateReceivedOperation, operation, @"Delegate should receive the operation the events were attributed to.");
+        XCTAssertEqual(_delegateReceivedQueue, queue, @"Delegate should receive attributed events on the callback queue.");
+    }
+}
+
+- (void)testDelegateReceivesChangesComputedBySnapshot
+{
+    // setup
+    NSArray *paths = @[@"/test/Cellar/wget"];
+    NSArray *changes = @[[MRBrewChange changeWithType:MRBrewChangeVersionAdded formulaName:@"wget" version:@"1.15"]];
+    MRBrewWatcher *watcher = [MRBrewWatcher watcherWithPath:@"/test/Cellar" delegate:self];
+    
+    __block MRBrewWatcherBackendHandler backendHandler = nil;
+    id backend = [OCMockObject niceMockForProtocol:@protocol(MRBrewWatcherBackend)];
+    [[[backend stub] andReturnValue:@YES] startWatchingPaths:[OCMArg any] latency:0 handler:[OCMArg checkWithBlock:^BOOL(id handler) {
+        backendHandler = handler;
+        return YES;
+    }]];
+    [watcher setBackend:backend];
+    [watcher setLatency:0];
+    [watcher setCallbackQueue:nil];
+    
+    id snapshot = [OCMockObject mockForClass:[MRBrewSnapshot class]];
+    [[snapshot expect] reload];
+    [[[snapshot expect] andReturn:changes] changesForPaths:paths];
+    [watcher setSnapshot:snapshot];
+    
+    // execute
+    [watcher startWatching];
+    backendHandler(paths);
+    
+    // verify
+    [snapshot verify];
+    XCTAssertEqualObjects(_delegateReceivedChanges, changes, @"Delegate should receive the changes computed by the watcher's snapshot.");
+}
+
+- (void)testEventsDuringOperationAreAttributedToOperation
+{
+    // setup
+    NSString *cellarPath = [[MRBrewLocations defaultLocations] cellarPath];
+    NSArray *paths = @[[cellarPath stringByAppendingPathComponent:@"wget/1.15"]];
+    MRBrewOperation *operation = [MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]];
+    MRBrewWatcher *watcher = [MRBrewWatcher watcherWithPath:@"/test/path" delegate:self];
+    
+    __block MRBrewWatcherBackendHandler backendHandler = nil;
+    id backend = [OCMockObject niceMockForProtocol:@protocol(MRBrewWatcherBackend)];
+    [[[backend stub] andReturnValue:@YES] startWatchingPaths:[OCMArg any] latency:0 handler:[OCMArg checkWithBlock:^BOOL(id handler) {
+        backendHandler = handler;
+        return YES;
+    }]];
+    [watcher setBackend:backend];
+    [watcher setLatency:0];
+    [watcher setSuppressesOperationEvents:YES];
+    [watcher startWatching];
+    
+    // execute
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationWillLaunchNotification object:operation];
+    backendHandler(paths);
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationDidExitNotification object:operation];
+    
+    // wait for the attribution period to end
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:2.0];
+    while (!_delegateReceivedOperation && [timeout timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    }
+    
+    // verify
+    XCTAssertNil(_delegateReceivedPaths, @"Delegate should not receive events caused by an operation.");
+    XCTAssertEqual(_delegateReceivedOperation, operation, @"Delegate should receive the operation the events were attributed to.");
+    XCTAssertEqualObjects(_delegateReceivedOperationPaths, paths, @"Delegate should receive the paths attributed to the operation.");
+}
+
+- (void)testEventsOutsideOperationKegsAreNotSuppressed
+{
+    // setup
+    NSString *cellarPath = [[MRBrewLocations defaultLocations] cellarPath];
+    NSArray *paths = @[[cellarPath stringByAppendingPathComponent:@"curl/7.36.0"], @"/test/path/one"];
+    MRBrewOperation *operation = [MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]];
+    MRBrewWatcher *watcher = [MRBrewWatcher watcherWithPath:@"/test/path" delegate:self];
+    
+    __block MRBrewWatcherBackendHandler backendHandler = nil;
+    id backend = [OCMockObject niceMockForProtocol:@protocol(MRBrewWatcherBackend)];
+    [[[backend stub] andReturnValue:@YES] startWatchingPaths:[OCMArg any] latency:0 handler:[OCMArg checkWithBlock:^BOOL(id handler) {
+        backendHandler = handler;
+        return YES;
+    }]];
+    [watcher setBackend:backend];
+    [watcher setLatency:0];
+    [watcher setCallbackQueue:nil];
+    [watcher setSuppressesOperationEvents:YES];
+    [watcher startWatching];
+    
+    // execute
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationWillLaunchNotification object:operation];
+    backendHandler(paths);
+    
+    // verify
+    XCTAssertEqualObjects(_delegateReceivedPaths, paths, @"Delegate should receive events outside the kegs and links of a running operation's formula.");
+}
+
+- (void)testEventsAreOnlyAttributedToOperationOnTheirFormula
+{
+    // setup
+    NSString *cellarPath = [[MRBrewLocations defaultLocations] cellarPath];
+    NSArray *paths = @[[cellarPath stringByAppendingPathComponent:@"curl/7.36.0"]];
+    MRBrewOperation *wgetOperation = [MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]];
+    MRBrewOperation *curlOperation = [MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"curl"]];
+    MRBrewWatcher *watcher = [MRBrewWatcher watcherWithPath:@"/test/path" delegate:self];
+    
+    __block MRBrewWatcherBackendHandler backendHandler = nil;
+    id backend = [OCMockObject niceMockForProtocol:@protocol(MRBrewWatcherBackend)];
+    [[[backend stub] andReturnValue:@YES] startWatchingPaths:[OCMArg any] latency:0 handler:[OCMArg checkWithBlock:^BOOL(id handler) {
+        backendHandler = handler;
+        return YES;
+    }]];
+    [watcher setBackend:backend];
+    [watcher setLatency:0];
+    [watcher setSuppressesOperationEvents:YES];
+    [watcher startWatching];
+    
+    // execute
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationWillLaunchNotification object:wgetOperation];
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationWillLaunchNotification object:curlOperation];
+    backendHandler(paths);
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationDidExitNotification object:wgetOperation];
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationDidExitNotification object:curlOperation];
+    
+    // wait for both attribution periods to end
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:1.5];
+    while ([timeout timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    }
+    
+    // verify
+    XCTAssertNil(_delegateReceivedPaths, @"Delegate should not receive events caused by an operation.");
+    @synchronized(self) {
+        XCTAssertEqualObjects([_delegateReceivedPathsByFormulaName objectForKey:@"curl"], paths, @"Delegate should receive the paths attributed to the operation on their formula.");
+        XCTAssertNil([_delegateReceivedPathsByFormulaName objectForKey:@"wget"], @"Delegate should not receive paths for an operation on another formula.");
+    }
+}
+
+- (void)testEventsDuringReadOnlyOperationAreNotSuppressed
+{
+    // setup
+    NSArray *paths = @[@"/test/path/one"];
+    MRBrewOperation *operation = [MRBrewOperation listOperation];
+    MRBrewWatcher *watcher = [MRBrewWatcher watcherWithPath:@"/test/path" delegate:self];
+    
+    __block MRBrewWatcherBackendHandler backendHandler = nil;
+    id backend = [OCMockObject niceMockForProtocol:@protocol(MRBrewWatcherBackend)];
+    [[[backend stub] andReturnValue:@YES] startWatchingPaths:[OCMArg any] latency:0 handler:[OCMArg checkWithBlock:^BOOL(id handler) {
+        backendHandler = handler;
+        return YES;
+    }]];
+    [watcher setBackend:backend];
+    [watcher setLatency:0];
+    [watcher setCallbackQueue:nil];
+    [watcher setSuppressesOperationEvents:YES];
+    [watcher startWatching];
+    
+    // execute
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationWillLaunchNotification object:operation];
+    backendHandler(paths);
+    [[NSNotificationCenter defaultCenter] postNotificationName:MRBrewOperationDidExitNotification object:operation];
+    
+    // verify
+    XCTAssertEqualObjects(_delegateReceivedPaths, paths, @"Delegate should receive events that occur during a read-only operation.");
+}
+
+// MRBrewWatcherDelegate methods
+- (void)brewChangeDidOccur:(NSArray *)paths
+{
+    _delegateReceivedPaths = paths;
+    _delegateReceivedQueue = [NSOperationQueue currentQueue];
+}
+
+- (void)brewChangesDidOccur:(NSArray *)changes
+{
+    _delegateReceivedChanges = changes;
+}
+
+- (void)brewOperation:(MRBrewOperation *)operation didChangePaths:(NSArray *)paths changes:(NSArray *)changes
+{
+    @synchronized(self) {
+        _delegateReceivedOperation = operation;
+        _delegateReceivedOperationPaths = paths;
+        _delegateReceivedQueue = [NSOperationQueue currentQueue];
+        [_delegateReceivedPathsByFormulaName setObject:paths forKey:[[operation formula] name]];
+    }
+}
+
+@end
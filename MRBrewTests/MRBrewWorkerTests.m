@@ -30,6 +30,8 @@
 #import "MRBrew.h"
 #import "MRBrewDelegate.h"
 #import "MRBrewWorkerTaskConstants.h"
+#import "MRBrewFormula.h"
+#import "MRBrewProgress.h"
 
 @interface MRBrewWorkerTests : XCTestCase <MRBrewDelegate> {
     BOOL _delegateReceivedDidFinishCallback;
@@ -49,8 +51,6 @@
     _delegateReceivedDidFailWithErrorCallback = NO;
     _delegateReceivedErrorCode = MRBrewErrorNone;
     _delegateReceivedOperation = nil;
-    
-    [[MRBrew sharedBrew] setEnvironment:nil];
 }
 
 - (void)tearDown
@@ -171,13 +171,16 @@
 {
     // setup
     NSArray *arguments = @[@"arg1", @"arg2"];
+    NSString *brewPath = @"/opt/homebrew/bin/brew";
     MRBrewWorker *worker = [[MRBrewWorker alloc] init];
     [worker setArguments:arguments];
+    [worker setBrewPath:brewPath];
     
     id mockTask = [OCMockObject niceMockForClass:[NSTask class]];
-    [[mockTask expect] setLaunchPath:[[MRBrew sharedBrew] brewPath]];
+    [[mockTask expect] setLaunchPath:brewPath];
     [[mockTask expect] setArguments:arguments];
     [[mockTask expect] setStandardOutput:[OCMArg any]];
+    [[mockTask expect] setStandardError:[OCMArg any]];
 
     [worker setTask:mockTask];
     
@@ -204,8 +207,7 @@
 
     MRBrewWorker *worker = [[MRBrewWorker alloc] init];
     [worker setTask:mockTask];
-    
-    [[MRBrew sharedBrew] setEnvironment:environment];
+    [worker setEnvironment:environment];
 
     NSOperationQueue *queue = [[NSOperationQueue alloc] init];
 
@@ -217,6 +219,26 @@
     [mockTask verify];
 }
 
+- (void)testTaskCurrentDirectoryIsSetIfWorkerDirectoryIsSet
+{
+    // setup
+    id mockTask = [OCMockObject niceMockForClass:[NSTask class]];
+    [[mockTask expect] setCurrentDirectoryPath:@"/tmp"];
+    
+    // throw exception to avoid endless loop while spinning runloop for task termination notification
+    [[[mockTask stub] andThrow:[NSException exceptionWithName:NSInvalidArgumentException reason:nil userInfo:nil]] launch];
+    
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    [worker setTask:mockTask];
+    [worker setCurrentDirectoryPath:@"/tmp"];
+    
+    // execute
+    [worker start];
+    
+    // verify
+    [mockTask verify];
+}
+
 - (void)testTaskEnvironmentIsNotSetIfBrewEnvironmentIsNotSet
 {
     // setup
@@ -236,6 +258,399 @@
     [mockTask verify];
 }
 
+- (void)testCompletionHandlerIsInvokedInlineWhenCallbackQueueIsNil
+{
+    // setup
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    
+    id operation = [OCMockObject mockForClass:[MRBrewOperation class]];
+    [[[operation stub] andReturn:operation] copyWithZone:[OCMArg anyPointer]];
+    [worker setOperation:operation];
+    
+    id task = [OCMockObject mockForClass:[NSTask class]];
+    [[[task stub] andReturnValue:OCMOCK_VALUE(MRBrewWorkerTaskExitedNormally)] terminationStatus];
+    [[[task stub] andReturn:nil] standardOutput];
+    [worker setTask:task];
+    [worker setCallbackQueue:nil];
+    
+    __block MRBrewOperation *receivedOperation = nil;
+    [worker setCompletionHandler:^(MRBrewOperation *completedOperation) {
+        receivedOperation = completedOperation;
+    }];
+    
+    // execute
+    [worker taskExited:nil];
+    
+    // verify
+    XCTAssertEqual(receivedOperation, operation, @"Completion handler should be invoked inline with the operation object held by worker instance.");
+}
+
+- (void)testFailureHandlerIsInvokedOnCallbackQueueWhenTaskTerminatesAbnormally
+{
+    // setup
+    int unknownExitStatus = 99;
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    
+    id operation = [OCMockObject mockForClass:[MRBrewOperation class]];
+    [[[operation stub] andReturn:operation] copyWithZone:[OCMArg anyPointer]];
+    [worker setOperation:operation];
+    
+    id task = [OCMockObject mockForClass:[NSTask class]];
+    [[[task stub] andReturnValue:OCMOCK_VALUE(unknownExitStatus)] terminationStatus];
+    [[[task stub] andReturn:nil] standardOutput];
+    [worker setTask:task];
+    
+    NSOperationQueue *callbackQueue = [[NSOperationQueue alloc] init];
+    [worker setCallbackQueue:callbackQueue];
+    
+    __block NSInteger receivedErrorCode = MRBrewErrorNone;
+    __block BOOL receivedOnCallbackQueue = NO;
+    [worker setFailureHandler:^(MRBrewOperation *failedOperation, NSError *error) {
+        receivedErrorCode = [error code];
+        receivedOnCallbackQueue = ([NSOperationQueue currentQueue] == callbackQueue);
+    }];
+    
+    // execute
+    [worker taskExited:nil];
+    [callbackQueue waitUntilAllOperationsAreFinished];
+    
+    // verify
+    XCTAssertTrue(receivedErrorCode == MRBrewErrorUnknown, @"Failure handler should receive correct error code when task exits for unknown reason.");
+    XCTAssertTrue(receivedOnCallbackQueue, @"Failure handler should be invoked on the worker's callback queue.");
+}
+
+- (void)testDataHandlerReceivesOutputBufferWithoutCopying
+{
+    // setup
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    
+    id operation = [OCMockObject mockForClass:[MRBrewOperation class]];
+    [[[operation stub] andReturn:operation] copyWithZone:[OCMArg anyPointer]];
+    [worker setOperation:operation];
+    [worker setCallbackQueue:nil];
+    
+    NSData *data = [@"==> Downloading" dataUsingEncoding:NSUTF8StringEncoding];
+    __block NSData *receivedData = nil;
+    [worker setDataHandler:^(MRBrewOperation *generatingOperation, NSData *chunk) {
+        receivedData = chunk;
+    }];
+    
+    // execute
+    [worker notifyDelegateOutputGenerated:data];
+    
+    // verify
+    XCTAssertEqual(receivedData, data, @"Data handler should receive the buffer the output was read into.");
+}
+
+- (void)testErrorOutputIsDeliveredSeparatelyFromOutput
+{
+    // setup
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    [worker setOperation:[MRBrewOperation listOperation]];
+    [worker setCallbackQueue:nil];
+    
+    NSData *errorData = [@"Warning: wget is already installed\n" dataUsingEncoding:NSUTF8StringEncoding];
+    __block NSData *receivedData = nil;
+    __block NSData *receivedErrorData = nil;
+    [worker setDataHandler:^(MRBrewOperation *generatingOperation, NSData *chunk) {
+        receivedData = chunk;
+    }];
+    [worker setErrorDataHandler:^(MRBrewOperation *generatingOperation, NSData *chunk) {
+        receivedErrorData = chunk;
+    }];
+    
+    // execute
+    [worker notifyDelegateErrorOutputGenerated:errorData];
+    
+    // verify
+    XCTAssertNil(receivedData, @"Error output should not be delivered to the data handler.");
+    XCTAssertEqualObjects(receivedErrorData, errorData, @"Error output should be delivered to the error data handler.");
+}
+
+- (void)testOutputWaitingForCallbackQueueIsDeliveredByOneCallback
+{
+    // setup
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    [worker setOperation:[MRBrewOperation listOperation]];
+    
+    NSOperationQueue *callbackQueue = [[NSOperationQueue alloc] init];
+    [callbackQueue setSuspended:YES];
+    [worker setCallbackQueue:callbackQueue];
+    
+    NSMutableArray *receivedOutput = [NSMutableArray array];
+    [worker setOutputHandler:^(MRBrewOperation *generatingOperation, NSString *output) {
+        [receivedOutput addObject:output];
+    }];
+    
+    // execute
+    [worker notifyDelegateOutputGenerated:[@"ack\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [worker notifyDelegateOutputGenerated:[@"git\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [worker notifyDelegateOutputGenerated:[@"wget\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    NSUInteger callbackCount = [callbackQueue operationCount];
+    [callbackQueue setSuspended:NO];
+    [callbackQueue waitUntilAllOperationsAreFinished];
+    
+    // verify
+    XCTAssertTrue(callbackCount == 1, @"Output read while earlier output is waiting should not add callbacks to the queue.");
+    XCTAssertEqualObjects(receivedOutput, (@[@"ack\n", @"git\n", @"wget\n"]), @"Waiting output should be delivered in the order it was read.");
+}
+
+- (void)testDownloadProgressIsReadFromErrorOutput
+{
+    // setup
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    [worker setOperation:[MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]]];
+    [worker setCallbackQueue:nil];
+    
+    NSMutableArray *receivedProgress = [NSMutableArray array];
+    [worker setProgressHandler:^(MRBrewOperation *operation, MRBrewProgress *progress) {
+        [receivedProgress addObject:progress];
+    }];
+    
+    // execute
+    [worker notifyDelegateOutputGenerated:[@"==> Installing wget dependency: openssl\n==> Downloading https://example.com/openssl.tar.gz\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [worker notifyDelegateErrorOutputGenerated:[@"######## 20.0%\r" dataUsingEncoding:NSUTF8StringEncoding]];
+    
+    // verify
+    MRBrewProgress *progress = [receivedProgress lastObject];
+    XCTAssertEqual([progress percentComplete], 20.0, @"Download percentages on error output should be delivered.");
+    XCTAssertEqualObjects([progress formulaName], @"openssl", @"Download percentages should be attributed to the formula named on output.");
+}
+
+- (void)testOutputProviderAnswersOperationWithoutLaunchingTask
+{
+    // setup
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    
+    id operation = [OCMockObject mockForClass:[MRBrewOperation class]];
+    [[[operation stub] andReturn:operation] copyWithZone:[OCMArg anyPointer]];
+    [worker setOperation:operation];
+    [worker setCallbackQueue:nil];
+    
+    // a strict mock fails the test if the task is configured or launched
+    id task = [OCMockObject mockForClass:[NSTask class]];
+    [worker setTask:task];
+    
+    NSData *output = [@"wget\n" dataUsingEncoding:NSUTF8StringEncoding];
+    [worker setOutputProvider:^NSData *{
+        return output;
+    }];
+    
+    __block NSData *receivedData = nil;
+    __block BOOL completed = NO;
+    [worker setDataHandler:^(MRBrewOperation *generatingOperation, NSData *chunk) {
+        receivedData = chunk;
+    }];
+    [worker setCompletionHandler:^(MRBrewOperation *completedOperation) {
+        completed = YES;
+    }];
+    
+    // execute
+    [worker start];
+    
+    // verify
+    [task verify];
+    XCTAssertEqualObjects(receivedData, output, @"Output handlers should receive the output of the output provider.");
+    XCTAssertTrue(completed, @"Completion handler should be invoked once the provided output has been delivered.");
+    XCTAssertTrue([worker isFinished], @"Worker should finish without launching its task.");
+}
+
+- (void)testProgressUpdatesWithinPhaseAreThrottled
+{
+    // setup
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    [worker setOperation:[MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]]];
+    [worker setCallbackQueue:nil];
+    [worker setProgressInterval:60];
+    
+    id task = [OCMockObject mockForClass:[NSTask class]];
+    [[[task stub] andReturnValue:OCMOCK_VALUE(MRBrewWorkerTaskExitedNormally)] terminationStatus];
+    [[[task stub] andReturn:nil] standardOutput];
+    [worker setTask:task];
+    
+    NSMutableArray *receivedProgress = [NSMutableArray array];
+    [worker setProgressHandler:^(MRBrewOperation *operation, MRBrewProgress *progress) {
+        [receivedProgress addObject:progress];
+    }];
+    
+    // execute
+    [worker notifyDelegateOutputGenerated:[@"==> Downloading https://example.com/wget.tar.gz\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [worker notifyDelegateOutputGenerated:[@"#### 10.0%\r######## 20.0%\r" dataUsingEncoding:NSUTF8StringEncoding]];
+    NSUInteger progressCountBeforeExit = [receivedProgress count];
+    [worker taskExited:nil];
+    
+    // verify
+    XCTAssertTrue(progressCountBeforeExit == 1, @"Updates within a phase should not be delivered before the progress interval ends.");
+    XCTAssertTrue([receivedProgress count] == 2, @"The latest update should be delivered when the operation exits.");
+    XCTAssertEqual([[receivedProgress lastObject] percentComplete], 20.0, @"Only the latest update within the interval should be delivered.");
+}
+
+- (void)testLockContentionFailureIsRetriedWithBackoff
+{
+    // setup
+    int failureExitStatus = 1;
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    [worker setOperation:[MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]]];
+    [worker setCallbackQueue:nil];
+    [worker setLockRetryLimit:3];
+    [worker setLockRetryInterval:2.0];
+    [worker setAttempt:1];
+    
+    id task = [OCMockObject mockForClass:[NSTask class]];
+    [[[task stub] andReturnValue:OCMOCK_VALUE(failureExitStatus)] terminationStatus];
+    [[[task stub] andReturn:nil] standardOutput];
+    [worker setTask:task];
+    
+    __block MRBrewWorker *retryWorker = nil;
+    __block NSTimeInterval retryDelay = 0;
+    [worker setRetryHandler:^(MRBrewWorker *nextWorker, NSTimeInterval delay) {
+        retryWorker = nextWorker;
+        retryDelay = delay;
+    }];
+    
+    __block BOOL receivedFailure = NO;
+    [worker setFailureHandler:^(MRBrewOperation *failedOperation, NSError *error) {
+        receivedFailure = YES;
+    }];
+    
+    // execute
+    [worker appendErrorOutput:[@"Error: Another active Homebrew update process is already in progress.\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [worker taskExited:nil];
+    
+    // verify
+    XCTAssertFalse(receivedFailure, @"Failure handler should not be invoked when a lock contention failure will be retried.");
+    XCTAssertNotNil(retryWorker, @"Retry handler should receive a worker for the next attempt.");
+    XCTAssertTrue([retryWorker attempt] == 2, @"Worker for the next attempt should count the attempt.");
+    XCTAssertEqualObjects([retryWorker operation], [worker operation], @"Worker for the next attempt should perform the same operation.");
+    XCTAssertNotNil([retryWorker failureHandler], @"Worker for the next attempt should deliver the final outcome.");
+    XCTAssertTrue(retryDelay >= 2.0 && retryDelay <= 6.0, @"Retry delay should double with each attempt and be jittered by up to half.");
+}
+
+- (void)testLockContentionFailureIsReportedWhenRetriesAreExhausted
+{
+    // setup
+    int failureExitStatus = 1;
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    [worker setOperation:[MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]]];
+    [worker setCallbackQueue:nil];
+    [worker setLockRetryLimit:3];
+    [worker setAttempt:3];
+    
+    id task = [OCMockObject mockForClass:[NSTask class]];
+    [[[task stub] andReturnValue:OCMOCK_VALUE(failureExitStatus)] terminationStatus];
+    [[[task stub] andReturn:nil] standardOutput];
+    [worker setTask:task];
+    
+    __block BOOL receivedRetry = NO;
+    [worker setRetryHandler:^(MRBrewWorker *nextWorker, NSTimeInterval delay) {
+        receivedRetry = YES;
+    }];
+    
+    __block NSInteger receivedErrorCode = MRBrewErrorNone;
+    [worker setFailureHandler:^(MRBrewOperation *failedOperation, NSError *error) {
+        receivedErrorCode = [error code];
+    }];
+    
+    // execute
+    [worker appendErrorOutput:[@"Error: Operation already in progress for wget\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [worker taskExited:nil];
+    
+    // verify
+    XCTAssertFalse(receivedRetry, @"Operation should not be retried once its retries are exhausted.");
+    XCTAssertTrue(receivedErrorCode == MRBrewErrorLockContention, @"Failure handler should receive the lock contention error code.");
+}
+
+- (void)testOutputOfRetriedAttemptIsNotDelivered
+{
+    // setup
+    int failureExitStatus = 1;
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    [worker setOperation:[MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]]];
+    [worker setCallbackQueue:nil];
+    [worker setLockRetryLimit:3];
+    
+    id task = [OCMockObject mockForClass:[NSTask class]];
+    [[[task stub] andReturnValue:OCMOCK_VALUE(failureExitStatus)] terminationStatus];
+    [worker setTask:task];
+    
+    __block MRBrewWorker *retryWorker = nil;
+    [worker setRetryHandler:^(MRBrewWorker *nextWorker, NSTimeInterval delay) {
+        retryWorker = nextWorker;
+    }];
+    
+    NSMutableArray *receivedOutput = [NSMutableArray array];
+    [worker setOutputHandler:^(MRBrewOperation *generatingOperation, NSString *output) {
+        [receivedOutput addObject:output];
+    }];
+    
+    // execute
+    [worker notifyDelegateOutputGenerated:[@"==> Installing wget\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [worker notifyDelegateErrorOutputGenerated:[@"Error: Operation already in progress for wget\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [worker taskExited:nil];
+    
+    id retryTask = [OCMockObject mockForClass:[NSTask class]];
+    [[[retryTask stub] andReturnValue:OCMOCK_VALUE(MRBrewWorkerTaskExitedNormally)] terminationStatus];
+    [retryWorker setTask:retryTask];
+    [retryWorker notifyDelegateOutputGenerated:[@"==> Pouring wget-1.15.mavericks.bottle.tar.gz\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    NSUInteger outputCountBeforeExit = [receivedOutput count];
+    [retryWorker taskExited:nil];
+    
+    // verify
+    XCTAssertNotNil(retryWorker, @"The attempt should be retried.");
+    XCTAssertTrue(outputCountBeforeExit == 0, @"Output of an attempt that may be retried should be held back.");
+    XCTAssertEqualObjects(receivedOutput, @[@"==> Pouring wget-1.15.mavericks.bottle.tar.gz\n"], @"Only the output of the final attempt should be delivered.");
+}
+
+- (void)testHeldOutputIsReleasedInOrderOnceTheBufferLimitIsExceeded
+{
+    // setup
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    [worker setOperation:[MRBrewOperation installOperation:[MRBrewFormula formulaWithName:@"wget"]]];
+    [worker setCallbackQueue:nil];
+    [worker setLockRetryLimit:3];
+    [worker setOutputBufferLimit:24];
+    [worker setRetryHandler:^(MRBrewWorker *nextWorker, NSTimeInterval delay) {}];
+    
+    NSMutableArray *receivedOutput = [NSMutableArray array];
+    [worker setOutputHandler:^(MRBrewOperation *generatingOperation, NSString *output) {
+        [receivedOutput addObject:output];
+    }];
+    
+    // execute
+    [worker notifyDelegateOutputGenerated:[@"==> Installing wget\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    NSUInteger outputCountWhileHeld = [receivedOutput count];
+    [worker notifyDelegateOutputGenerated:[@"==> Downloading wget-1.15.tar.gz\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [worker notifyDelegateOutputGenerated:[@"==> Pouring wget-1.15.mavericks.bottle.tar.gz\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    
+    // verify
+    XCTAssertTrue(outputCountWhileHeld == 0, @"Output within the buffer limit should be held back.");
+    XCTAssertEqualObjects(receivedOutput, (@[@"==> Installing wget\n", @"==> Downloading wget-1.15.tar.gz\n", @"==> Pouring wget-1.15.mavericks.bottle.tar.gz\n"]), @"Held output should be released in order, followed by later output.");
+}
+
+- (void)testFailureIsDeliveredWhenBrewCannotBeLaunched
+{
+    // setup
+    MRBrewWorker *worker = [[MRBrewWorker alloc] init];
+    [worker setOperation:[MRBrewOperation listOperation]];
+    [worker setBrewPath:@"/nonexistent/bin/brew"];
+    [worker setArguments:@[@"list"]];
+    [worker setCallbackQueue:nil];
+    
+    __block NSError *receivedError = nil;
+    [worker setFailureHandler:^(MRBrewOperation *failedOperation, NSError *error) {
+        receivedError = error;
+    }];
+    
+    // execute
+    [worker start];
+    
+    // verify
+    XCTAssertNotNil(receivedError, @"Failure handler should be invoked when the brew task cannot be launched.");
+    XCTAssertTrue([receivedError code] == MRBrewErrorUnknown, @"Failure handler should receive the unknown error code.");
+    XCTAssertNotNil([[receivedError userInfo] objectForKey:NSLocalizedFailureReasonErrorKey], @"Error should describe why the task could not be launched.");
+    XCTAssertTrue([worker isFinished], @"Worker should finish when the brew task cannot be launched.");
+}
+
 - (void)testBrewWorkerWillExecuteAsynchronouslyForCurrentThread
 {
     // setup
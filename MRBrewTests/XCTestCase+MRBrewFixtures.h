@@ -0,0 +1,48 @@
+//
+//  XCTestCase+MRBrewFixtures.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <XCTest/XCTest.h>
+
+/* Builds the Homebrew installations and other directory trees that tests
+ * operate on, inside uniquely named temporary directories.
+ */
+@interface XCTestCase (MRBrewFixtures)
+
+/* Creates an empty, uniquely named directory in the temporary directory and
+ * returns its path. The caller removes it when the test has finished.
+ */
+- (NSString *)createTemporaryDirectory;
+
+/* Creates a directory, and any missing intermediate directories, at a path
+ * relative to directoryPath, and returns its absolute path.
+ */
+- (NSString *)createDirectoryAtPath:(NSString *)path inDirectory:(NSString *)directoryPath;
+
+/* Writes data to a file at a path relative to directoryPath, creating any
+ * missing intermediate directories, and returns its absolute path.
+ */
+- (NSString *)writeData:(NSData *)data toFileAtPath:(NSString *)path inDirectory:(NSString *)directoryPath;
+
+@end
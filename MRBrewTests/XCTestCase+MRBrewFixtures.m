@@ -0,0 +1,55 @@
+//
+//  XCTestCase+MRBrewFixtures.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "XCTestCase+MRBrewFixtures.h"
+
+@implementation XCTestCase (MRBrewFixtures)
+
+- (NSString *)createTemporaryDirectory
+{
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSProcessInfo processInfo] globallyUniqueString]];
+    [[NSFileManager defaultManager] createDirectoryAtPath:path withIntermediateDirectories:YES attributes:nil error:NULL];
+    
+    return path;
+}
+
+- (NSString *)createDirectoryAtPath:(NSString *)path inDirectory:(NSString *)directoryPath
+{
+    NSString *absolutePath = [directoryPath stringByAppendingPathComponent:path];
+    [[NSFileManager defaultManager] createDirectoryAtPath:absolutePath withIntermediateDirectories:YES attributes:nil error:NULL];
+    
+    return absolutePath;
+}
+
+- (NSString *)writeData:(NSData *)data toFileAtPath:(NSString *)path inDirectory:(NSString *)directoryPath
+{
+    NSString *absolutePath = [directoryPath stringByAppendingPathComponent:path];
+    [self createDirectoryAtPath:[path stringByDeletingLastPathComponent] inDirectory:directoryPath];
+    [data writeToFile:absolutePath atomically:NO];
+    
+    return absolutePath;
+}
+
+@end
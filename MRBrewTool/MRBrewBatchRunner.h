@@ -0,0 +1,117 @@
+//
+//  MRBrewBatchRunner.h
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+@class MRBrew;
+
+extern NSString * const MRBrewBatchErrorDomain;
+
+/** These constants determine how the operations of a batch are scheduled. */
+typedef NS_ENUM(NSInteger, MRBrewBatchSchedule) {
+    /** Every operation is performed at once, and executed as the brew object's
+     * concurrency allows.
+     */
+    MRBrewBatchScheduleParallel,
+    /** Each operation is performed once the previous operation has finished. */
+    MRBrewBatchScheduleSequential
+};
+
+/** An `MRBrewBatchRunner` object performs a batch of operations with an
+ * `MRBrew` object, writes the result of each operation as a line of JSON, and
+ * summarises how long the batch took.
+ *
+ * A batch is read from text with one operation per line, written as it would
+ * be passed to brew, such as `install wget --build-from-source`. Empty lines
+ * and lines starting with `#` are ignored. A batch can also be a JSON array of
+ * objects, or one JSON object per line, each with a `name` and optionally a
+ * `formula` and an array of `parameters`:
+ *
+ *     {"name": "install", "formula": "wget", "parameters": ["--build-from-source"]}
+ *
+ * Each result line describes one operation: the batch run and index it belongs
+ * to, its name, formula and parameters, whether it succeeded and its error
+ * code if not, the seconds from when it was performed until it finished, and
+ * either the objects parsed from its output by `MRBrewOutputParser` or, for
+ * operations whose output is not parsed, the lines of its output.
+ */
+@interface MRBrewBatchRunner : NSObject
+
+/** The brew object the operations are performed with. */
+@property (readonly, strong) MRBrew *brew;
+
+/** How the operations of the batch are scheduled. The default is
+ * `MRBrewBatchScheduleParallel`.
+ */
+@property (assign) MRBrewBatchSchedule schedule;
+
+/** The number of times the batch is run. The default is `1`. */
+@property (assign) NSUInteger repeatCount;
+
+/** The file handle result lines are written to. The default is standard
+ * output.
+ */
+@property (strong) NSFileHandle *resultHandle;
+
+/** The file handle timing summaries are written to, after each run of the
+ * batch. The default is standard error; `nil` writes no summaries.
+ */
+@property (strong) NSFileHandle *summaryHandle;
+
+/** Returns an initialized `MRBrewBatchRunner` object that performs operations
+ * with the specified brew object.
+ *
+ * @param brew The brew object to perform operations with.
+ * @return A runner for the specified brew object.
+ */
+- (instancetype)initWithBrew:(MRBrew *)brew;
+
+/** Returns the operations of a batch.
+ *
+ * @param data The batch as text or JSON.
+ * @param error A pointer to an error object that is set if the batch cannot be
+ * read. This parameter is optional and can be passed `nil`.
+ * @return An array of `MRBrewOperation` objects, or `nil` if the batch cannot
+ * be read.
+ */
++ (NSArray *)operationsFromData:(NSData *)data error:(NSError **)error;
+
+/** Returns a representation of an object parsed from an operation's output
+ * that can be written as JSON.
+ *
+ * @param object An `MRBrewFormula` or `MRBrewInstallOption` object.
+ * @return A dictionary describing the object.
+ */
++ (NSDictionary *)dictionaryForObject:(id)object;
+
+/** Runs the batch repeatCount times, writing the result of each operation as
+ * it finishes. This method blocks until every run has finished.
+ *
+ * @param operations The `MRBrewOperation` objects of the batch.
+ * @return `YES` if every operation succeeded, otherwise `NO`.
+ */
+- (BOOL)runOperations:(NSArray *)operations;
+
+@end
@@ -0,0 +1,381 @@
+//
+//  MRBrewBatchRunner.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import "MRBrewBatchRunner.h"
+#import "MRBrew.h"
+#import "MRBrewOperation.h"
+#import "MRBrewFormula.h"
+#import "MRBrewInstallOption.h"
+#import "MRBrewOutputParser.h"
+
+NSString * const MRBrewBatchErrorDomain = @"MRBrewBatchErrorDomain";
+
+/* Sets a member of a result object, omitting values the output did not
+ * provide.
+ */
+static void MRBrewBatchSetValue(NSMutableDictionary *dictionary, NSString *key, id value)
+{
+    if (value && !([value isKindOfClass:[NSArray class]] && [value count] == 0)) {
+        [dictionary setObject:value forKey:key];
+    }
+}
+
+/* The outcome of one operation of a run. */
+@interface MRBrewBatchResult : NSObject
+
+@property (assign) NSUInteger index;
+@property (strong) MRBrewOperation *operation;
+@property (strong) NSMutableData *output;
+@property (strong) NSDate *startDate;
+@property (assign) NSTimeInterval duration;
+@property (assign) BOOL succeeded;
+@property (assign) NSInteger errorCode;
+
+@end
+
+@implementation MRBrewBatchResult
+
+@end
+
+@interface MRBrewBatchRunner ()
+{
+    @private
+    NSOperationQueue *_callbackQueue;
+    MRBrewOutputParser *_parser;
+}
+
+@end
+
+@implementation MRBrewBatchRunner
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithBrew:(MRBrew *)brew
+{
+    if (self = [super init]) {
+        _brew = brew;
+        _schedule = MRBrewBatchScheduleParallel;
+        _repeatCount = 1;
+        _resultHandle = [NSFileHandle fileHandleWithStandardOutput];
+        _summaryHandle = [NSFileHandle fileHandleWithStandardError];
+        _parser = [MRBrewOutputParser outputParser];
+        
+        // results are handled one at a time so that lines are never interleaved
+        _callbackQueue = [[NSOperationQueue alloc] init];
+        [_callbackQueue setMaxConcurrentOperationCount:1];
+    }
+    
+    return self;
+}
+
+#pragma mark - Reading Batches
+
++ (NSArray *)operationsFromData:(NSData *)data error:(NSError **)error
+{
+    NSString *batch = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    if (!batch) {
+        [self setError:error line:0 reason:@"The batch is not UTF-8 text."];
+        return nil;
+    }
+    
+    NSString *trimmedBatch = [batch stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+    if ([trimmedBatch hasPrefix:@"["]) {
+        id objects = [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
+        if (![objects isKindOfClass:[NSArray class]]) {
+            [self setError:error line:0 reason:@"The batch is not a valid JSON array."];
+            return nil;
+        }
+        
+        NSMutableArray *operations = [NSMutableArray array];
+        for (id object in objects) {
+            MRBrewOperation *operation = [self operationFromJSONObject:object];
+            if (!operation) {
+                [self setError:error line:0 reason:[NSString stringWithFormat:@"Operation %lu of the batch is not valid.", (unsigned long)[operations count] + 1]];
+                return nil;
+            }
+            [operations addObject:operation];
+        }
+        
+        return operations;
+    }
+    
+    NSMutableArray *operations = [NSMutableArray array];
+    NSUInteger lineNumber = 0;
+    
+    for (NSString *batchLine in [batch componentsSeparatedByString:@"\n"]) {
+        lineNumber++;
+        
+        NSString *line = [batchLine stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        if ([line length] == 0 || [line hasPrefix:@"#"]) {
+            continue;
+        }
+        
+        MRBrewOperation *operation = nil;
+        if ([line hasPrefix:@"{"]) {
+            id object = [NSJSONSerialization JSONObjectWithData:[line dataUsingEncoding:NSUTF8StringEncoding] options:0 error:NULL];
+            operation = [self operationFromJSONObject:object];
+        }
+        else {
+            operation = [self operationFromLine:line];
+        }
+        
+        if (!operation) {
+            [self setError:error line:lineNumber reason:[NSString stringWithFormat:@"Line %lu of the batch is not a valid operation.", (unsigned long)lineNumber]];
+            return nil;
+        }
+        [operations addObject:operation];
+    }
+    
+    return operations;
+}
+
+/* Reads an operation written as it would be passed to brew. A single argument
+ * that is not an option is the operation's formula; with several, every
+ * argument is passed through as a parameter so that their order is kept.
+ */
++ (MRBrewOperation *)operationFromLine:(NSString *)line
+{
+    NSMutableArray *arguments = [NSMutableArray array];
+    for (NSString *argument in [line componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]]) {
+        if ([argument length]) {
+            [arguments addObject:argument];
+        }
+    }
+    
+    NSString *name = [arguments firstObject];
+    [arguments removeObjectAtIndex:0];
+    
+    NSArray *formulaArguments = [arguments filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"NOT SELF BEGINSWITH '-'"]];
+    if ([formulaArguments count] == 1) {
+        [arguments removeObject:[formulaArguments firstObject]];
+        return [MRBrewOperation operationWithName:name formula:[MRBrewFormula formulaWithName:[formulaArguments firstObject]] parameters:arguments];
+    }
+    
+    return [MRBrewOperation operationWithName:name formula:nil parameters:arguments];
+}
+
++ (MRBrewOperation *)operationFromJSONObject:(id)object
+{
+    if (![object isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+    
+    id name = [object objectForKey:@"name"];
+    id formulaName = [object objectForKey:@"formula"];
+    id parameters = [object objectForKey:@"parameters"];
+    
+    if (![name isKindOfClass:[NSString class]] || (formulaName && ![formulaName isKindOfClass:[NSString class]]) || (parameters && ![parameters isKindOfClass:[NSArray class]])) {
+        return nil;
+    }
+    for (id parameter in parameters) {
+        if (![parameter isKindOfClass:[NSString class]]) {
+            return nil;
+        }
+    }
+    
+    MRBrewFormula *formula = formulaName ? [MRBrewFormula formulaWithName:formulaName] : nil;
+    return [MRBrewOperation operationWithName:name formula:formula parameters:(parameters ? parameters : @[])];
+}
+
++ (void)setError:(NSError **)error line:(NSUInteger)line reason:(NSString *)reason
+{
+    if (error) {
+        *error = [NSError errorWithDomain:MRBrewBatchErrorDomain code:line userInfo:@{NSLocalizedDescriptionKey: reason}];
+    }
+}
+
+#pragma mark - Running Batches
+
+- (BOOL)runOperations:(NSArray *)operations
+{
+    BOOL succeeded = YES;
+    
+    for (NSUInteger run = 1; run <= [self repeatCount]; run++) {
+        NSDate *runStartDate = [NSDate date];
+        NSArray *results = [self runOperations:operations run:run];
+        NSTimeInterval runDuration = -[runStartDate timeIntervalSinceNow];
+        
+        [self writeSummaryForResults:results run:run duration:runDuration];
+        
+        for (MRBrewBatchResult *result in results) {
+            succeeded = succeeded && [result succeeded];
+        }
+    }
+    
+    return succeeded;
+}
+
+- (NSArray *)runOperations:(NSArray *)operations run:(NSUInteger)run
+{
+    NSMutableArray *results = [NSMutableArray arrayWithCapacity:[operations count]];
+    dispatch_group_t group = dispatch_group_create();
+    
+    for (NSUInteger index = 0; index < [operations count]; index++) {
+        MRBrewBatchResult *result = [[MRBrewBatchResult alloc] init];
+        [result setIndex:index];
+        [result setOperation:[operations objectAtIndex:index]];
+        [result setOutput:[NSMutableData data]];
+        [results addObject:result];
+        
+        dispatch_group_enter(group);
+        [self performResult:result run:run completion:^{
+            dispatch_group_leave(group);
+        }];
+        
+        if ([self schedule] == MRBrewBatchScheduleSequential) {
+            dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+        }
+    }
+    
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    
+    return results;
+}
+
+- (void)performResult:(MRBrewBatchResult *)result run:(NSUInteger)run completion:(void (^)(void))completion
+{
+    [result setStartDate:[NSDate date]];
+    
+    [[self brew] performOperation:[result operation] queue:_callbackQueue data:^(MRBrewOperation *operation, NSData *data) {
+        [[result output] appendData:data];
+    } completion:^(MRBrewOperation *operation) {
+        [result setSucceeded:YES];
+        [self finishResult:result run:run];
+        completion();
+    } failure:^(MRBrewOperation *operation, NSError *error) {
+        [result setErrorCode:[error code]];
+        [self finishResult:result run:run];
+        completion();
+    }];
+}
+
+- (void)finishResult:(MRBrewBatchResult *)result run:(NSUInteger)run
+{
+    [result setDuration:-[[result startDate] timeIntervalSinceNow]];
+    
+    MRBrewOperation *operation = [result operation];
+    NSMutableDictionary *line = [NSMutableDictionary dictionary];
+    [line setObject:@(run) forKey:@"run"];
+    [line setObject:@([result index]) forKey:@"index"];
+    [line setObject:[operation name] forKey:@"operation"];
+    [line setObject:([operation formula] ? [[operation formula] name] : [NSNull null]) forKey:@"formula"];
+    [line setObject:([operation parameters] ? [operation parameters] : @[]) forKey:@"parameters"];
+    [line setObject:@([result succeeded]) forKey:@"succeeded"];
+    [line setObject:([result succeeded] ? [NSNull null] : @([result errorCode])) forKey:@"error"];
+    [line setObject:@([result duration]) forKey:@"seconds"];
+    
+    NSString *output = [[NSString alloc] initWithData:[result output] encoding:NSUTF8StringEncoding];
+    NSArray *objects = [result succeeded] && [output length] ? [_parser objectsForOperation:operation output:output error:NULL] : nil;
+    if (objects) {
+        NSMutableArray *parsedObjects = [NSMutableArray arrayWithCapacity:[objects count]];
+        for (id object in objects) {
+            [parsedObjects addObject:[[self class] dictionaryForObject:object]];
+        }
+        [line setObject:parsedObjects forKey:@"results"];
+    }
+    else {
+        NSMutableArray *outputLines = [NSMutableArray arrayWithArray:[(output ? output : @"") componentsSeparatedByString:@"\n"]];
+        if ([[outputLines lastObject] length] == 0) {
+            [outputLines removeLastObject];
+        }
+        [line setObject:outputLines forKey:@"output"];
+    }
+    
+    NSMutableData *lineData = [[NSJSONSerialization dataWithJSONObject:line options:0 error:NULL] mutableCopy];
+    [lineData appendBytes:"\n" length:1];
+    [[self resultHandle] writeData:lineData];
+    
+    // the result's output is no longer needed once it has been written
+    [result setOutput:nil];
+}
+
++ (NSDictionary *)dictionaryForObject:(id)object
+{
+    NSMutableDictionary *dictionary = [NSMutableDictionary dictionary];
+    
+    if ([object isKindOfClass:[MRBrewInstallOption class]]) {
+        MRBrewInstallOption *option = object;
+        [dictionary setObject:[option name] forKey:@"option"];
+        if ([option optionDescription]) {
+            [dictionary setObject:[option optionDescription] forKey:@"description"];
+        }
+        return dictionary;
+    }
+    
+    MRBrewFormula *formula = object;
+    [dictionary setObject:[formula name] forKey:@"name"];
+    [dictionary setObject:@([formula isInstalled]) forKey:@"installed"];
+    [dictionary setObject:@([formula isOutdated]) forKey:@"outdated"];
+    [dictionary setObject:@([formula isPinned]) forKey:@"pinned"];
+    
+    MRBrewBatchSetValue(dictionary, @"stable_version", [formula stableVersion]);
+    MRBrewBatchSetValue(dictionary, @"devel_version", [formula develVersion]);
+    MRBrewBatchSetValue(dictionary, @"head_version", [formula headVersion]);
+    MRBrewBatchSetValue(dictionary, @"installed_versions", [formula installedVersions]);
+    MRBrewBatchSetValue(dictionary, @"available_version", [formula availableVersion]);
+    MRBrewBatchSetValue(dictionary, @"linked_version", [formula linkedVersion]);
+    MRBrewBatchSetValue(dictionary, @"dependencies", [formula dependencies]);
+    
+    if ([[formula options] count]) {
+        NSMutableArray *options = [NSMutableArray array];
+        for (MRBrewInstallOption *option in [formula options]) {
+            [options addObject:[self dictionaryForObject:option]];
+        }
+        [dictionary setObject:options forKey:@"options"];
+    }
+    
+    return dictionary;
+}
+
+#pragma mark - Summaries
+
+- (void)writeSummaryForResults:(NSArray *)results run:(NSUInteger)run duration:(NSTimeInterval)duration
+{
+    if (![self summaryHandle] || [results count] == 0) {
+        return;
+    }
+    
+    NSUInteger succeededCount = 0;
+    for (MRBrewBatchResult *result in results) {
+        succeededCount += [result succeeded] ? 1 : 0;
+    }
+    
+    NSArray *durations = [[results valueForKey:@"duration"] sortedArrayUsingSelector:@selector(compare:)];
+    NSUInteger count = [durations count];
+    double (^percentile)(double) = ^double(double fraction) {
+        NSUInteger rank = (NSUInteger)ceil(fraction * count);
+        return [[durations objectAtIndex:(rank > 0 ? MIN(rank, count) - 1 : 0)] doubleValue];
+    };
+    
+    NSString *summary = [NSString stringWithFormat:@"mrbrew: run %lu: %lu operations in %.3fs (%.2f/s), %lu succeeded, %lu failed\n"
+                                                   @"mrbrew: run %lu: latency min %.3fs, median %.3fs, p90 %.3fs, max %.3fs\n",
+                         (unsigned long)run, (unsigned long)count, duration, duration > 0 ? count / duration : 0.0,
+                         (unsigned long)succeededCount, (unsigned long)(count - succeededCount),
+                         (unsigned long)run, percentile(0), percentile(0.5), percentile(0.9), percentile(1.0)];
+    
+    [[self summaryHandle] writeData:[summary dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+@end
@@ -0,0 +1,187 @@
+//
+//  main.m
+//  MRBrew
+//
+//  Copyright (c) 2014 Marc Ransome <marc.ransome@fidgetbox.co.uk>
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to
+//  deal in the Software without restriction, including without limitation the
+//  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//  sell copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+#import "MRBrew.h"
+#import "MRBrewLocations.h"
+#import "MRBrewOutdatedScanner.h"
+#import "MRBrewBatchRunner.h"
+
+/* Exit statuses of the tool. */
+enum {
+    MRBrewToolExitSucceeded = 0,
+    MRBrewToolExitOperationFailed = 1,
+    MRBrewToolExitUsage = 2
+};
+
+static void MRBrewToolPrintUsage(void)
+{
+    fprintf(stderr,
+            "usage: mrbrew [options] [batch-file]\n"
+            "\n"
+            "Performs the operations in batch-file, or standard input, with MRBrew and\n"
+            "writes the result of each as a line of JSON.\n"
+            "\n"
+            "options:\n"
+            "  --brew PATH            the brew executable (default: discovered)\n"
+            "  --concurrency N        operations executed at once (default: system)\n"
+            "  --schedule MODE        parallel (default) or sequential\n"
+            "  --cache MODE           stored (default) uses the stored Homebrew\n"
+            "                         locations; none discovers them afresh\n"
+            "  --native-outdated      answer outdated operations without running brew\n"
+            "  --repeat N             run the batch N times (default: 1)\n"
+            "  --quiet                do not print timing summaries\n"
+            "  --help                 print this message\n");
+}
+
+int main(int argc, const char *argv[])
+{
+    @autoreleasepool {
+        NSString *brewPath = nil;
+        NSString *batchPath = nil;
+        NSInteger concurrency = NSOperationQueueDefaultMaxConcurrentOperationCount;
+        MRBrewBatchSchedule schedule = MRBrewBatchScheduleParallel;
+        BOOL usesStoredLocations = YES;
+        BOOL usesOutdatedScanner = NO;
+        NSUInteger repeatCount = 1;
+        BOOL quiet = NO;
+        
+        NSArray *arguments = [[NSProcessInfo processInfo] arguments];
+        for (NSUInteger i = 1; i < [arguments count]; i++) {
+            NSString *argument = [arguments objectAtIndex:i];
+            NSString *value = (i + 1 < [arguments count]) ? [arguments objectAtIndex:i + 1] : nil;
+            BOOL takesValue = [@[@"--brew", @"--concurrency", @"--schedule", @"--cache", @"--repeat"] containsObject:argument];
+            
+            if (takesValue && !value) {
+                fprintf(stderr, "mrbrew: %s requires a value\n", [argument UTF8String]);
+                return MRBrewToolExitUsage;
+            }
+            
+            if ([argument isEqualToString:@"--brew"]) {
+                brewPath = value;
+            }
+            else if ([argument isEqualToString:@"--concurrency"]) {
+                concurrency = [value integerValue];
+                if (concurrency < 1) {
+                    fprintf(stderr, "mrbrew: concurrency must be at least 1\n");
+                    return MRBrewToolExitUsage;
+                }
+            }
+            else if ([argument isEqualToString:@"--schedule"]) {
+                if ([value isEqualToString:@"parallel"]) {
+                    schedule = MRBrewBatchScheduleParallel;
+                }
+                else if ([value isEqualToString:@"sequential"]) {
+                    schedule = MRBrewBatchScheduleSequential;
+                }
+                else {
+                    fprintf(stderr, "mrbrew: unknown schedule '%s'\n", [value UTF8String]);
+                    return MRBrewToolExitUsage;
+                }
+            }
+            else if ([argument isEqualToString:@"--cache"]) {
+                if ([value isEqualToString:@"stored"] || [value isEqualToString:@"none"]) {
+                    usesStoredLocations = [value isEqualToString:@"stored"];
+                }
+                else {
+                    fprintf(stderr, "mrbrew: unknown cache mode '%s'\n", [value UTF8String]);
+                    return MRBrewToolExitUsage;
+                }
+            }
+            else if ([argument isEqualToString:@"--repeat"]) {
+                repeatCount = (NSUInteger)MAX([value integerValue], 1);
+            }
+            else if ([argument isEqualToString:@"--native-outdated"]) {
+                usesOutdatedScanner = YES;
+            }
+            else if ([argument isEqualToString:@"--quiet"]) {
+                quiet = YES;
+            }
+            else if ([argument isEqualToString:@"--help"] || [argument isEqualToString:@"-h"]) {
+                MRBrewToolPrintUsage();
+                return MRBrewToolExitSucceeded;
+            }
+            else if ([argument hasPrefix:@"-"] && ![argument isEqualToString:@"-"]) {
+                fprintf(stderr, "mrbrew: unknown option '%s'\n", [argument UTF8String]);
+                MRBrewToolPrintUsage();
+                return MRBrewToolExitUsage;
+            }
+            else {
+                batchPath = argument;
+            }
+            
+            if (takesValue) {
+                i++;
+            }
+        }
+        
+        // resolve the installation, either from the stored locations or afresh
+        if (!brewPath) {
+            brewPath = [MRBrewLocations discoverBrewPath];
+        }
+        MRBrewLocations *locations = nil;
+        if (brewPath) {
+            locations = usesStoredLocations ? [MRBrewLocations locationsForBrewPath:brewPath] : [MRBrewLocations locationsForBrewPath:brewPath storePath:nil];
+        }
+        if (!locations) {
+            fprintf(stderr, "mrbrew: no Homebrew installation found\n");
+            return MRBrewToolExitUsage;
+        }
+        
+        NSData *batch = nil;
+        if (batchPath && ![batchPath isEqualToString:@"-"]) {
+            batch = [NSData dataWithContentsOfFile:batchPath];
+            if (!batch) {
+                fprintf(stderr, "mrbrew: unable to read %s\n", [batchPath UTF8String]);
+                return MRBrewToolExitUsage;
+            }
+        }
+        else {
+            batch = [[NSFileHandle fileHandleWithStandardInput] readDataToEndOfFile];
+        }
+        
+        NSError *error = nil;
+        NSArray *operations = [MRBrewBatchRunner operationsFromData:batch error:&error];
+        if (!operations) {
+            fprintf(stderr, "mrbrew: %s\n", [[error localizedDescription] UTF8String]);
+            return MRBrewToolExitUsage;
+        }
+        
+        MRBrew *brew = [[MRBrew alloc] initWithBrewPath:[locations brewPath]];
+        [brew setMaxConcurrentOperationCount:concurrency];
+        if (usesOutdatedScanner) {
+            [brew setOutdatedScanner:[[MRBrewOutdatedScanner alloc] initWithLocations:locations]];
+        }
+        
+        MRBrewBatchRunner *runner = [[MRBrewBatchRunner alloc] initWithBrew:brew];
+        [runner setSchedule:schedule];
+        [runner setRepeatCount:repeatCount];
+        if (quiet) {
+            [runner setSummaryHandle:nil];
+        }
+        
+        return [runner runOperations:operations] ? MRBrewToolExitSucceeded : MRBrewToolExitOperationFailed;
+    }
+}